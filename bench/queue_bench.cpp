@@ -0,0 +1,146 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../common/queue.h"
+#include "../common/ring_queue.h"
+#include "../server/event.h"
+
+// Microbenchmark de colas: N productores empujan eventos de juego a un único
+// consumidor (el patrón reactores -> tick de la partida).
+#define DEFAULT_PRODUCERS 4
+#define DEFAULT_EVENTS_PER_PRODUCER 1000000
+#define QUEUE_CAPACITY 4096
+#define BATCH_SIZE 256
+#define PRODUCERS_ARG 1
+#define EVENTS_ARG 2
+#define BENCH_PARAMS " [productores] [eventos por productor]\n"
+
+class QueueBench
+{
+private:
+    const int producers;
+    const int events_per_producer;
+
+    using Clock = std::chrono::steady_clock;
+
+    void report(const std::string &name, Clock::time_point start, long long checksum) const
+    {
+        double secs = std::chrono::duration<double>(Clock::now() - start).count();
+        double total = static_cast<double>(producers) * events_per_producer;
+        std::cout << name << ": " << total / secs / 1e6 << " Mev/s ("
+                  << secs * 1e3 << " ms, checksum " << checksum << ")" << std::endl;
+    }
+
+    template <typename Q>
+    std::vector<std::thread> spawn_producers(Q &q) const
+    {
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&q, p, this]()
+                                 {
+                for (int i = 0; i < events_per_producer; ++i)
+                {
+                    Event ev(p, InputEvent{InputAction::MOVE_UP_PRESSED, static_cast<uint8_t>(i)});
+                    q.push(std::move(ev));
+                } });
+        }
+        return threads;
+    }
+
+public:
+    QueueBench(int producers, int events_per_producer)
+        : producers(producers), events_per_producer(events_per_producer)
+    {
+    }
+
+    void run_queue() const
+    {
+        Queue<Event> q(QUEUE_CAPACITY);
+        auto start = Clock::now();
+        auto threads = spawn_producers(q);
+        long long checksum = 0;
+        for (long long n = 0; n < static_cast<long long>(producers) * events_per_producer; ++n)
+            checksum += q.pop().input.arg;
+        for (auto &t : threads)
+            t.join();
+        report("Queue (mutex)        ", start, checksum);
+    }
+
+    void run_ring() const
+    {
+        RingQueue<Event> q(QUEUE_CAPACITY);
+        auto start = Clock::now();
+        auto threads = spawn_producers(q);
+        long long checksum = 0;
+        for (long long n = 0; n < static_cast<long long>(producers) * events_per_producer; ++n)
+            checksum += q.pop().input.arg;
+        for (auto &t : threads)
+            t.join();
+        report("RingQueue pop        ", start, checksum);
+    }
+
+    void run_ring_batch() const
+    {
+        RingQueue<Event> q(QUEUE_CAPACITY);
+        auto start = Clock::now();
+        auto threads = spawn_producers(q);
+        long long checksum = 0;
+        long long remaining = static_cast<long long>(producers) * events_per_producer;
+        std::vector<Event> batch;
+        batch.reserve(BATCH_SIZE);
+        while (remaining > 0)
+        {
+            batch.clear();
+            if (q.try_pop_all(batch, BATCH_SIZE) == 0)
+            {
+                batch.push_back(q.pop());
+            }
+            for (const auto &ev : batch)
+                checksum += ev.input.arg;
+            remaining -= static_cast<long long>(batch.size());
+        }
+        for (auto &t : threads)
+            t.join();
+        report("RingQueue try_pop_all", start, checksum);
+    }
+
+    void run_spsc() const
+    {
+        RingQueue<Event, RingProducers::SINGLE> q(QUEUE_CAPACITY);
+        auto start = Clock::now();
+        std::thread producer([&q, this]()
+                             {
+            for (long long i = 0; i < static_cast<long long>(producers) * events_per_producer; ++i)
+                q.push(Event(0, InputEvent{InputAction::MOVE_UP_PRESSED, static_cast<uint8_t>(i)})); });
+        long long checksum = 0;
+        for (long long n = 0; n < static_cast<long long>(producers) * events_per_producer; ++n)
+            checksum += q.pop().input.arg;
+        producer.join();
+        report("RingQueue SPSC       ", start, checksum);
+    }
+};
+
+int main(int argc, const char *argv[])
+{
+    int producers = argc > PRODUCERS_ARG ? std::atoi(argv[PRODUCERS_ARG]) : DEFAULT_PRODUCERS;
+    int events = argc > EVENTS_ARG ? std::atoi(argv[EVENTS_ARG]) : DEFAULT_EVENTS_PER_PRODUCER;
+    if (producers <= 0 || events <= 0)
+    {
+        std::cerr << "Use: " << argv[0] << BENCH_PARAMS;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << producers << " productores x " << events << " eventos, capacidad "
+              << QUEUE_CAPACITY << std::endl;
+    QueueBench bench(producers, events);
+    bench.run_queue();
+    bench.run_ring();
+    bench.run_ring_batch();
+    bench.run_spsc();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,432 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <linux/tcp.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+#include "../client/game_client_handler.h"
+#include "../common/constants.h"
+#include "../common/protocol.h"
+#include "../common/socket.h"
+#include "../server/acceptor.h"
+#include "../server/game_monitor.h"
+#include "../server/lobby_handler.h"
+
+// Benchmark de punta a punta del servidor: levanta Acceptor + GameMonitor en
+// el mismo proceso, conecta bots por loopback que crean/se unen a partidas,
+// largan la carrera y manejan con un guion determinístico (semilla fija).
+// Reporta percentiles del tick, latencia input -> snapshot, bytes por cliente
+// y CPU por partida.
+#define DEFAULT_GAMES 4
+#define DEFAULT_BOTS_PER_GAME 4
+#define DEFAULT_SECONDS 20
+#define DEFAULT_MAP 0
+#define MAX_BOTS_PER_GAME 8
+#define BENCH_HOST "127.0.0.1"
+#define BENCH_PORT "50400"
+#define BENCH_SEED 1234u
+#define ACCEPTOR_STARTUP_MS 200
+// Cuenta regresiva de start_game (10 s) más margen
+#define START_TIMEOUT_MS 15000
+#define POLL_MS 1
+#define MIN_STEER_MS 100
+#define MAX_STEER_MS 600
+#define GAMES_ARG 1
+#define BOTS_ARG 2
+#define SECONDS_ARG 3
+#define MAP_ARG 4
+#define BENCH_PARAMS " [partidas] [bots por partida] [segundos] [mapa]\n"
+
+class BenchBot
+{
+private:
+    using Clock = std::chrono::steady_clock;
+
+    int fd;
+    Protocol protocol;
+    GameClientHandler handler;
+    std::mt19937 rng;
+    uint32_t player_id;
+    uint32_t game_id;
+
+    // Último giro pedido y cuándo: se mide hasta el primer snapshot que lo refleja
+    MovementDirectionX pending_direction;
+    Clock::time_point pending_since;
+    bool waiting_echo;
+
+    uint64_t bytes_at_start;
+    uint64_t snapshots;
+    std::vector<double> latencies_ms;
+
+    static Socket connect_to(const char *port, int &fd_out)
+    {
+        Socket skt(BENCH_HOST, port);
+        fd_out = skt.get_fd();
+        return skt;
+    }
+
+    void steer(MovementDirectionX direction)
+    {
+        if (pending_direction != not_horizontal)
+            handler.send(pending_direction == left ? MOVE_LEFT_RELEASED_STR : MOVE_RIGHT_RELEASED_STR);
+        if (direction != not_horizontal)
+            handler.send(direction == left ? MOVE_LEFT_PRESSED_STR : MOVE_RIGHT_PRESSED_STR);
+        pending_direction = direction;
+        pending_since = Clock::now();
+        waiting_echo = true;
+    }
+
+    void drain_snapshots()
+    {
+        ServerMessage msg;
+        while (handler.try_receive(msg))
+        {
+            if (msg.opcode != UPDATE_POSITIONS && msg.opcode != UPDATE_POSITIONS_DELTA)
+                continue;
+            snapshots++;
+            for (const auto &update : msg.positions)
+            {
+                if (update.player_id != static_cast<int>(player_id))
+                    continue;
+                if (waiting_echo && update.new_pos.direction_x == pending_direction)
+                {
+                    latencies_ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - pending_since).count());
+                    waiting_echo = false;
+                }
+            }
+        }
+    }
+
+public:
+    BenchBot(const char *port, uint32_t seed)
+        : fd(-1),
+          protocol(connect_to(port, fd)),
+          handler(protocol),
+          rng(seed),
+          player_id(0),
+          game_id(0),
+          pending_direction(not_horizontal),
+          pending_since(),
+          waiting_echo(false),
+          bytes_at_start(0),
+          snapshots(0),
+          latencies_ms()
+    {
+        handler.start();
+        handler.request_protocol_version();
+    }
+
+    bool create(uint8_t map_id, const std::string &name)
+    {
+        uint8_t out_map = 0;
+        return handler.create_game_blocking(game_id, player_id, out_map, name, map_id);
+    }
+
+    bool join(uint32_t id)
+    {
+        uint8_t out_map = 0;
+        game_id = id;
+        return handler.join_game_blocking(static_cast<int32_t>(id), player_id, out_map);
+    }
+
+    void start_race() { handler.send(START_GAME_STR); }
+
+    // El receiver avisa dos veces: al arrancar la cuenta regresiva y al largar
+    bool wait_until_playing()
+    {
+        int signals = 0;
+        auto deadline = Clock::now() + std::chrono::milliseconds(START_TIMEOUT_MS);
+        while (signals < 2 && Clock::now() < deadline)
+        {
+            if (handler.wait_for_game_started())
+                signals++;
+            else
+                std::this_thread::sleep_for(std::chrono::milliseconds(POLL_MS));
+        }
+        return signals == 2;
+    }
+
+    // Acelera siempre y alterna giros de duración aleatoria (reproducible por semilla)
+    void drive(Clock::time_point until)
+    {
+        std::uniform_int_distribution<int> steer_ms(MIN_STEER_MS, MAX_STEER_MS);
+        std::uniform_int_distribution<int> direction(-1, 1);
+        handler.send(MOVE_UP_PRESSED_STR);
+        snapshots = 0;
+        latencies_ms.clear();
+        bytes_at_start = bytes_received();
+
+        auto next_step = Clock::now();
+        while (Clock::now() < until)
+        {
+            if (Clock::now() >= next_step)
+            {
+                auto next = static_cast<MovementDirectionX>(direction(rng));
+                // Solo se mide si el pedido cambia algo visible en el snapshot
+                if (next == pending_direction)
+                    next = (next == not_horizontal) ? left : not_horizontal;
+                steer(next);
+                next_step += std::chrono::milliseconds(steer_ms(rng));
+            }
+            drain_snapshots();
+            std::this_thread::sleep_for(std::chrono::milliseconds(POLL_MS));
+        }
+        handler.send(MOVE_UP_RELEASED_STR);
+    }
+
+    void shutdown()
+    {
+        handler.stop();
+        handler.join();
+    }
+
+    // Bytes de aplicación recibidos por el socket según el kernel
+    uint64_t bytes_received() const
+    {
+        struct tcp_info info = {};
+        socklen_t len = sizeof(info);
+        if (getsockopt(fd, IPPROTO_TCP, TCP_INFO, &info, &len) != 0)
+            return 0;
+        return info.tcpi_bytes_received;
+    }
+
+    uint64_t bytes_during_drive() const { return bytes_received() - bytes_at_start; }
+    uint64_t snapshot_count() const { return snapshots; }
+    const std::vector<double> &latencies() const { return latencies_ms; }
+    uint32_t get_game_id() const { return game_id; }
+};
+
+class ServerBench
+{
+private:
+    using Clock = std::chrono::steady_clock;
+
+    const int games;
+    const int bots_per_game;
+    const int seconds;
+    const uint8_t map_id;
+
+    static double percentile(std::vector<double> &samples, double p)
+    {
+        if (samples.empty())
+            return 0.0;
+        size_t idx = static_cast<size_t>(p * static_cast<double>(samples.size() - 1) + 0.5);
+        std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+        return samples[idx];
+    }
+
+    static void print_distribution(const std::string &name, std::vector<double> &samples)
+    {
+        std::cout << name << ": p50 " << percentile(samples, 0.50) << " ms, p90 "
+                  << percentile(samples, 0.90) << " ms, p99 " << percentile(samples, 0.99)
+                  << " ms, max " << percentile(samples, 1.0) << " ms (" << samples.size()
+                  << " muestras)" << std::endl;
+    }
+
+    static double cpu_seconds()
+    {
+        struct rusage usage = {};
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+               static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+
+    // Muestrea el trabajo de cada tick mirando las stats del scheduler de cada partida
+    static void sample_ticks(const std::vector<GameLoop *> &loops, const std::atomic<bool> &running,
+                             std::vector<double> &work_ms, uint64_t &unsampled)
+    {
+        std::vector<uint64_t> seen(loops.size(), 0);
+        for (size_t g = 0; g < loops.size(); ++g)
+            seen[g] = loops[g]->get_tick_stats().ticks;
+
+        while (running.load())
+        {
+            for (size_t g = 0; g < loops.size(); ++g)
+            {
+                TickStats stats = loops[g]->get_tick_stats();
+                if (stats.ticks == seen[g])
+                    continue;
+                work_ms.push_back(stats.last_work_ms);
+                unsampled += stats.ticks - seen[g] - 1;
+                seen[g] = stats.ticks;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(POLL_MS));
+        }
+    }
+
+    bool setup_games(std::vector<std::unique_ptr<BenchBot>> &bots) const
+    {
+        uint32_t seed = BENCH_SEED;
+        for (int g = 0; g < games; ++g)
+        {
+            auto host = std::make_unique<BenchBot>(BENCH_PORT, seed++);
+            if (!host->create(map_id, "bench" + std::to_string(g)))
+            {
+                std::cerr << "[ServerBench] No se pudo crear la partida " << g << std::endl;
+                return false;
+            }
+            uint32_t game_id = host->get_game_id();
+            bots.push_back(std::move(host));
+            for (int b = 1; b < bots_per_game; ++b)
+            {
+                auto bot = std::make_unique<BenchBot>(BENCH_PORT, seed++);
+                if (!bot->join(game_id))
+                {
+                    std::cerr << "[ServerBench] No se pudo unir un bot a la partida " << game_id << std::endl;
+                    return false;
+                }
+                bots.push_back(std::move(bot));
+            }
+        }
+
+        for (int g = 0; g < games; ++g)
+            bots[static_cast<size_t>(g * bots_per_game)]->start_race();
+        for (auto &bot : bots)
+        {
+            if (!bot->wait_until_playing())
+            {
+                std::cerr << "[ServerBench] La carrera no largó a tiempo" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void run_drive(std::vector<std::unique_ptr<BenchBot>> &bots, GameMonitor &monitor) const
+    {
+        std::vector<GameLoop *> loops;
+        std::vector<TickStats> before;
+        for (int g = 0; g < games; ++g)
+        {
+            GameLoop *loop = monitor.get_game(static_cast<int>(bots[static_cast<size_t>(g * bots_per_game)]->get_game_id()));
+            loops.push_back(loop);
+            before.push_back(loop->get_tick_stats());
+        }
+
+        std::atomic<bool> sampling(true);
+        std::vector<double> work_ms;
+        uint64_t unsampled = 0;
+        std::thread sampler([&]() { sample_ticks(loops, sampling, work_ms, unsampled); });
+
+        double cpu_start = cpu_seconds();
+        auto start = Clock::now();
+        auto until = start + std::chrono::seconds(seconds);
+        std::vector<std::thread> drivers;
+        for (auto &bot : bots)
+            drivers.emplace_back([&bot, until]() { bot->drive(until); });
+        for (auto &t : drivers)
+            t.join();
+        double wall = std::chrono::duration<double>(Clock::now() - start).count();
+        double cpu = cpu_seconds() - cpu_start;
+
+        sampling.store(false);
+        sampler.join();
+
+        report(bots, loops, before, work_ms, unsampled, wall, cpu);
+    }
+
+    void report(const std::vector<std::unique_ptr<BenchBot>> &bots, const std::vector<GameLoop *> &loops,
+                const std::vector<TickStats> &before, std::vector<double> &work_ms, uint64_t unsampled,
+                double wall, double cpu) const
+    {
+        std::cout << std::fixed << std::setprecision(3);
+        print_distribution("Tick (trabajo)      ", work_ms);
+        if (unsampled > 0)
+            std::cout << "  " << unsampled << " ticks sin muestrear (recuperación en ráfaga)" << std::endl;
+
+        uint64_t ticks = 0, missed = 0, skipped = 0;
+        double tick_work_ms = 0.0;
+        for (size_t g = 0; g < loops.size(); ++g)
+        {
+            TickStats after = loops[g]->get_tick_stats();
+            ticks += after.ticks - before[g].ticks;
+            missed += after.missed_deadlines - before[g].missed_deadlines;
+            skipped += after.skipped_ticks - before[g].skipped_ticks;
+            tick_work_ms += after.avg_work_ms * static_cast<double>(after.ticks) -
+                            before[g].avg_work_ms * static_cast<double>(before[g].ticks);
+        }
+        std::cout << "Ticks: " << ticks << " (" << ticks / wall / games << " Hz por partida), "
+                  << missed << " deadlines perdidos, " << skipped << " descartados" << std::endl;
+
+        std::vector<double> latencies;
+        uint64_t bytes = 0, snapshots = 0;
+        for (const auto &bot : bots)
+        {
+            latencies.insert(latencies.end(), bot->latencies().begin(), bot->latencies().end());
+            bytes += bot->bytes_during_drive();
+            snapshots += bot->snapshot_count();
+        }
+        print_distribution("Input -> snapshot   ", latencies);
+
+        double clients = static_cast<double>(bots.size());
+        std::cout << "Tráfico: " << bytes / wall / clients / 1024.0 << " KiB/s por cliente, "
+                  << snapshots / wall / clients << " snapshots/s por cliente" << std::endl;
+        // El trabajo de tick es CPU del worker; el total del proceso incluye reactores y bots
+        std::cout << "CPU por partida: " << tick_work_ms / 1e3 / wall / games * 100.0
+                  << "% de un core en ticks; proceso completo " << cpu / wall * 100.0
+                  << "% (servidor + bots)" << std::endl;
+    }
+
+public:
+    ServerBench(int games, int bots_per_game, int seconds, uint8_t map_id)
+        : games(games), bots_per_game(bots_per_game), seconds(seconds), map_id(map_id)
+    {
+    }
+
+    bool run() const
+    {
+        GameMonitor monitor;
+        LobbyHandler lobby(monitor);
+        Acceptor acceptor(BENCH_PORT, lobby);
+        acceptor.start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(ACCEPTOR_STARTUP_MS));
+
+        std::vector<std::unique_ptr<BenchBot>> bots;
+        bool ok = false;
+        try
+        {
+            ok = setup_games(bots);
+            if (ok)
+                run_drive(bots, monitor);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "[ServerBench] " << e.what() << std::endl;
+        }
+
+        for (auto &bot : bots)
+            bot->shutdown();
+        acceptor.stop();
+        acceptor.join();
+        return ok;
+    }
+};
+
+int main(int argc, const char *argv[])
+{
+    int games = argc > GAMES_ARG ? std::atoi(argv[GAMES_ARG]) : DEFAULT_GAMES;
+    int bots = argc > BOTS_ARG ? std::atoi(argv[BOTS_ARG]) : DEFAULT_BOTS_PER_GAME;
+    int seconds = argc > SECONDS_ARG ? std::atoi(argv[SECONDS_ARG]) : DEFAULT_SECONDS;
+    int map = argc > MAP_ARG ? std::atoi(argv[MAP_ARG]) : DEFAULT_MAP;
+    if (games <= 0 || bots <= 0 || bots > MAX_BOTS_PER_GAME || seconds <= 0 || map < 0)
+    {
+        std::cerr << "Use: " << argv[0] << BENCH_PARAMS;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << games << " partidas x " << bots << " bots, " << seconds << " s, mapa " << map
+              << ", semilla " << BENCH_SEED << std::endl;
+    ServerBench bench(games, bots, seconds, static_cast<uint8_t>(map));
+    return bench.run() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -16,6 +16,7 @@ void Client::initLegacyConnection(const char* address, const char* port) {
     owned_handler_ = std::make_unique<GameClientHandler>(*owned_protocol_);
     active_handler_ = owned_handler_.get();
     owned_handler_->start();
+    owned_handler_->request_protocol_version();
 }
 
 Client::Client(const char *address, const char *port, StartMode mode, int join_game_id, const std::string &game_name)
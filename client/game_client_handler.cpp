@@ -3,7 +3,10 @@
 
 GameClientHandler::GameClientHandler(Protocol& proto)
         : protocol(proto), incoming(), outgoing(), join_results(),
-            sender(protocol, outgoing), receiver(protocol, incoming, join_results) {}
+            sender(protocol, outgoing), receiver(protocol, incoming, join_results, outgoing) {
+    // Los inputs son de pocos bytes: con Nagle esperarían el ACK del anterior
+    protocol.setNoDelay(true);
+}
 
 void GameClientHandler::start() {
     sender.start();
@@ -20,6 +23,10 @@ void GameClientHandler::join() {
     receiver.join();
 }
 
+void GameClientHandler::request_protocol_version() {
+    send(HELLO_STR);
+}
+
 void GameClientHandler::send(const std::string& msg) {
     outgoing.push(msg);
 }
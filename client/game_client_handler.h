@@ -29,6 +29,8 @@ public:
     void stop();
     void join();
 
+    // Pide la versión más nueva del protocolo; tiene que ir antes de entrar a una partida
+    void request_protocol_version();
     void send(const std::string& msg);
     bool try_receive(ServerMessage& out);
 
@@ -1,8 +1,34 @@
 #include "game_client_receiver.h"
 #include <iostream>
 
-GameClientReceiver::GameClientReceiver(Protocol& proto, Queue<ServerMessage>& messages, Queue<ServerMessage>& joins) :
-    protocol(proto), incoming_messages(messages), join_results(joins) {}
+GameClientReceiver::GameClientReceiver(Protocol& proto, Queue<ServerMessage>& messages, Queue<ServerMessage>& joins,
+                                       Queue<std::string>& outgoing) :
+    protocol(proto), incoming_messages(messages), join_results(joins), acks(outgoing) {}
+
+void GameClientReceiver::send_ack(uint32_t seq) {
+    try {
+        acks.push(std::string(SNAPSHOT_ACK_STR) + " " + std::to_string(seq));
+    } catch (const ClosedQueue&) {
+        // El sender ya se detuvo
+    }
+}
+
+void GameClientReceiver::request_datagram_channel(uint32_t game_id) {
+    try {
+        acks.push(std::string(UDP_REQUEST_STR) + " " + std::to_string(game_id));
+    } catch (const ClosedQueue&) {
+        // El sender ya se detuvo
+    }
+}
+
+void GameClientReceiver::open_datagram_channel(const ServerMessage& offer) {
+    try {
+        protocol.openDatagramChannel(offer.udp_port, offer.udp_token);
+    } catch (const std::exception& e) {
+        // Sin UDP todo sigue llegando por TCP
+        std::cerr << "[Game Client Receiver] No se pudo abrir el canal UDP: " << e.what() << std::endl;
+    }
+}
 
 void GameClientReceiver::run() {
     try {
@@ -21,8 +47,19 @@ void GameClientReceiver::run() {
                 m.player_id = joinResp.player_id; 
                 m.success = joinResp.success;
                 m.map_id = joinResp.map_id;
+                if (m.success) {
+                    // Ack 0: habilita los snapshots delta para esta conexión
+                    send_ack(0);
+                    // El canal UDP necesita frames con largo (v3)
+                    if (protocol.getVersion() >= PROTOCOL_VERSION_FRAMED) {
+                        request_datagram_channel(joinResp.game_id);
+                    }
+                }
                 join_results.push(std::move(m));
-            } else if (opcode == UPDATE_POSITIONS) {
+            } else if (opcode == UPDATE_POSITIONS || opcode == UPDATE_POSITIONS_DELTA) {
+                if (positionsMsg.snapshot_seq != 0) {
+                    send_ack(positionsMsg.snapshot_seq);
+                }
                 if (!positionsMsg.positions.empty()) {
                     incoming_messages.push(std::move(positionsMsg));
                 }
@@ -38,6 +75,8 @@ void GameClientReceiver::run() {
                 m.opcode = GAME_STARTED;
                 join_results.push(std::move(m)); 
                 incoming_messages.push(std::move(positionsMsg));
+            } else if (opcode == UDP_OFFER) {
+                open_datagram_channel(positionsMsg);
             } else if (opcode == RACE_TIMES) {
                 incoming_messages.push(std::move(positionsMsg));
             } else if (opcode == TOTAL_TIMES) {
@@ -2,6 +2,7 @@
 #define GAME_CLIENT_RECEIVER_H
 
 #include <memory>
+#include <string>
 #include "../common/queue.h"
 #include "../common/socket.h"
 #include "../common/thread.h"
@@ -13,9 +14,17 @@ private:
     Protocol& protocol;
     Queue<ServerMessage>& incoming_messages;
     Queue<ServerMessage>& join_results;
+    // Cola del sender: por acá se confirman los snapshots recibidos
+    Queue<std::string>& acks;
+
+    void send_ack(uint32_t seq);
+    // Pide el canal UDP por TCP y lo abre cuando llega UDP_OFFER
+    void request_datagram_channel(uint32_t game_id);
+    void open_datagram_channel(const ServerMessage& offer);
 
 public:
-    explicit GameClientReceiver(Protocol& proto, Queue<ServerMessage>& messages, Queue<ServerMessage>& joins);
+    explicit GameClientReceiver(Protocol& proto, Queue<ServerMessage>& messages, Queue<ServerMessage>& joins,
+                                Queue<std::string>& outgoing);
     
     void run() override;
     void stop() override;  
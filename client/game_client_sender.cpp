@@ -1,11 +1,15 @@
 #include "game_client_sender.h"
 #include <iostream>
 
+// Mensajes que se juntan como máximo en una escritura
+#define MAX_BATCH_MESSAGES 64
+
 GameClientSender::GameClientSender(Protocol& proto, Queue<std::string>& messages) :
     protocol(proto), outgoing_messages(messages) {}
 
 void GameClientSender::run() {
     try {
+        std::vector<ClientMessage> batch;
         while (should_keep_running()) {
             std::string msg;
             try {
@@ -14,77 +18,20 @@ void GameClientSender::run() {
                 break;
             }
             if (!should_keep_running()) break;
-            ClientMessage client_msg;
-            client_msg.cmd = msg;
-            client_msg.player_id = player_id;
-            client_msg.game_id = game_id;
 
-            if (client_msg.cmd.rfind(JOIN_GAME_STR, 0) == 0) {
-                size_t sp = client_msg.cmd.find(' ');
-                if (sp != std::string::npos && sp + 1 < client_msg.cmd.size()) {
-                    std::string id_str = client_msg.cmd.substr(sp + 1);
-                    try {
-                        int parsed = std::stoi(id_str);
-                        client_msg.game_id = parsed;
-                    } catch (...) {
-                    }
-                }
-                client_msg.cmd = JOIN_GAME_STR;
-            }
-            if (client_msg.cmd.rfind(CREATE_GAME_STR, 0) == 0) {
-                size_t sp = client_msg.cmd.find(' ');
-                if (sp != std::string::npos && sp + 1 < client_msg.cmd.size()) {
-                    std::string payload = client_msg.cmd.substr(sp + 1);
-                    size_t pipe_pos = payload.find('|');
-                    if (pipe_pos != std::string::npos) {
-                        client_msg.game_name = payload.substr(0, pipe_pos);
-                        try {
-                            client_msg.map_id = static_cast<uint8_t>(std::stoi(payload.substr(pipe_pos + 1)));
-                        } catch (...) {
-                            client_msg.map_id = 0;
-                        }
-                    } else {
-                        client_msg.game_name = payload;
-                        client_msg.map_id = 0;
-                    }
-                    client_msg.cmd = CREATE_GAME_STR;
-                } else {
-                    client_msg.game_name = "";
-                    client_msg.map_id = 0;
-                }
-            }
-            if (client_msg.cmd.rfind(CHANGE_CAR_STR, 0) == 0) {
-                size_t sp = client_msg.cmd.find(' ');
-                if (sp != std::string::npos && sp + 1 < client_msg.cmd.size()) {
-                    client_msg.car_type = client_msg.cmd.substr(sp + 1);
-                }
-            }
-
-            if (client_msg.cmd.rfind(UPGRADE_CAR_STR, 0) == 0) {
-                size_t sp = client_msg.cmd.find(' ');
-                if (sp != std::string::npos && sp + 1 < client_msg.cmd.size()) {
-                    std::string upgrade_str = client_msg.cmd.substr(sp + 1);
-                    try {
-                        int upgrade_val = std::stoi(upgrade_str);
-                        client_msg.upgrade_type = static_cast<CarUpgrade>(upgrade_val);
-                    } catch (...) {
-                        client_msg.upgrade_type = CarUpgrade::ACCELERATION_BOOST;
-                    }
+            // Lo que se encoló mientras tanto sale en la misma escritura
+            batch.clear();
+            enqueue(msg, batch);
+            try {
+                while (batch.size() < MAX_BATCH_MESSAGES && outgoing_messages.try_pop(msg)) {
+                    enqueue(msg, batch);
                 }
+            } catch (const ClosedQueue&) {
+                // Lo ya juntado se envía; el próximo pop corta el loop
             }
-            if (client_msg.cmd == CHEAT_GOD_MODE_STR) {
-                client_msg.cheat_type = CheatType::GOD_MODE;
-            } else if (client_msg.cmd == CHEAT_DIE_STR) {
-                client_msg.cheat_type = CheatType::DIE;
-            } else if (client_msg.cmd == CHEAT_SKIP_LAP_STR) {
-                client_msg.cheat_type = CheatType::SKIP_LAP;
-            } else if (client_msg.cmd == CHEAT_FULL_UPGRADE_STR) {
-                client_msg.cheat_type = CheatType::FULL_UPGRADE;
-            }
-            if (client_msg.cmd == GET_GAMES_STR) {
-                // no payload extra
+            if (!batch.empty()) {
+                protocol.sendMessages(batch);
             }
-            protocol.sendMessage(client_msg);
         }
     } catch (const std::exception& e) {
         std::cerr << "[Game Client Sender] Exception: " << e.what() << std::endl;
@@ -94,6 +41,144 @@ void GameClientSender::run() {
     }
 }
 
+void GameClientSender::enqueue(const std::string& cmd, std::vector<ClientMessage>& batch) {
+    bool is_move = update_input_mask(cmd, input_mask);
+    if (protocol.datagramChannelReady()) {
+        if (is_move) {
+            // Con UDP los movimientos viajan como el estado de todas las teclas
+            protocol.sendInputMask(input_mask);
+            return;
+        }
+        if (cmd.rfind(SNAPSHOT_ACK_STR, 0) == 0) {
+            // Se repite con cada ack: si un datagrama se pierde, el siguiente corrige
+            protocol.sendInputMask(input_mask);
+        }
+    }
+    batch.push_back(build_message(cmd));
+}
+
+bool GameClientSender::update_input_mask(const std::string& cmd, uint8_t& mask) {
+    static const struct {
+        const std::string& pressed;
+        const std::string& released;
+        uint8_t bit;
+    } keys[] = {
+        {MOVE_UP_PRESSED_STR, MOVE_UP_RELEASED_STR, INPUT_MASK_UP},
+        {MOVE_DOWN_PRESSED_STR, MOVE_DOWN_RELEASED_STR, INPUT_MASK_DOWN},
+        {MOVE_LEFT_PRESSED_STR, MOVE_LEFT_RELEASED_STR, INPUT_MASK_LEFT},
+        {MOVE_RIGHT_PRESSED_STR, MOVE_RIGHT_RELEASED_STR, INPUT_MASK_RIGHT},
+    };
+    for (const auto& key : keys) {
+        if (cmd == key.pressed) {
+            mask |= key.bit;
+            return true;
+        }
+        if (cmd == key.released) {
+            mask &= ~key.bit;
+            return true;
+        }
+    }
+    return false;
+}
+
+ClientMessage GameClientSender::build_message(const std::string& cmd) const {
+    ClientMessage client_msg;
+    client_msg.cmd = cmd;
+    client_msg.player_id = player_id;
+    client_msg.game_id = game_id;
+
+    if (client_msg.cmd.rfind(JOIN_GAME_STR, 0) == 0) {
+        size_t sp = client_msg.cmd.find(' ');
+        if (sp != std::string::npos && sp + 1 < client_msg.cmd.size()) {
+            std::string id_str = client_msg.cmd.substr(sp + 1);
+            try {
+                int parsed = std::stoi(id_str);
+                client_msg.game_id = parsed;
+            } catch (...) {
+            }
+        }
+        client_msg.cmd = JOIN_GAME_STR;
+    }
+    if (client_msg.cmd.rfind(UDP_REQUEST_STR, 0) == 0) {
+        size_t sp = client_msg.cmd.find(' ');
+        if (sp != std::string::npos && sp + 1 < client_msg.cmd.size()) {
+            try {
+                client_msg.game_id = std::stoi(client_msg.cmd.substr(sp + 1));
+            } catch (...) {
+            }
+        }
+        client_msg.cmd = UDP_REQUEST_STR;
+    }
+    if (client_msg.cmd.rfind(CREATE_GAME_STR, 0) == 0) {
+        size_t sp = client_msg.cmd.find(' ');
+        if (sp != std::string::npos && sp + 1 < client_msg.cmd.size()) {
+            std::string payload = client_msg.cmd.substr(sp + 1);
+            size_t pipe_pos = payload.find('|');
+            if (pipe_pos != std::string::npos) {
+                client_msg.game_name = payload.substr(0, pipe_pos);
+                try {
+                    client_msg.map_id = static_cast<uint8_t>(std::stoi(payload.substr(pipe_pos + 1)));
+                } catch (...) {
+                    client_msg.map_id = 0;
+                }
+            } else {
+                client_msg.game_name = payload;
+                client_msg.map_id = 0;
+            }
+            client_msg.cmd = CREATE_GAME_STR;
+        } else {
+            client_msg.game_name = "";
+            client_msg.map_id = 0;
+        }
+    }
+    if (client_msg.cmd.rfind(CHANGE_CAR_STR, 0) == 0) {
+        size_t sp = client_msg.cmd.find(' ');
+        if (sp != std::string::npos && sp + 1 < client_msg.cmd.size()) {
+            client_msg.car_type = client_msg.cmd.substr(sp + 1);
+        }
+    }
+
+    if (client_msg.cmd.rfind(UPGRADE_CAR_STR, 0) == 0) {
+        size_t sp = client_msg.cmd.find(' ');
+        if (sp != std::string::npos && sp + 1 < client_msg.cmd.size()) {
+            std::string upgrade_str = client_msg.cmd.substr(sp + 1);
+            try {
+                int upgrade_val = std::stoi(upgrade_str);
+                client_msg.upgrade_type = static_cast<CarUpgrade>(upgrade_val);
+            } catch (...) {
+                client_msg.upgrade_type = CarUpgrade::ACCELERATION_BOOST;
+            }
+        }
+    }
+    if (client_msg.cmd == CHEAT_GOD_MODE_STR) {
+        client_msg.cheat_type = CheatType::GOD_MODE;
+    } else if (client_msg.cmd == CHEAT_DIE_STR) {
+        client_msg.cheat_type = CheatType::DIE;
+    } else if (client_msg.cmd == CHEAT_SKIP_LAP_STR) {
+        client_msg.cheat_type = CheatType::SKIP_LAP;
+    } else if (client_msg.cmd == CHEAT_FULL_UPGRADE_STR) {
+        client_msg.cheat_type = CheatType::FULL_UPGRADE;
+    }
+    if (client_msg.cmd.rfind(SNAPSHOT_ACK_STR, 0) == 0) {
+        size_t sp = client_msg.cmd.find(' ');
+        if (sp != std::string::npos && sp + 1 < client_msg.cmd.size()) {
+            try {
+                client_msg.snapshot_seq = static_cast<uint32_t>(std::stoul(client_msg.cmd.substr(sp + 1)));
+            } catch (...) {
+                client_msg.snapshot_seq = 0;
+            }
+        }
+        client_msg.cmd = SNAPSHOT_ACK_STR;
+    }
+    if (client_msg.cmd == HELLO_STR) {
+        client_msg.protocol_version = PROTOCOL_VERSION;
+    }
+    if (client_msg.cmd == GET_GAMES_STR) {
+        // no payload extra
+    }
+    return client_msg;
+}
+
 void GameClientSender::stop() {
     Thread::stop(); 
     outgoing_messages.close(); 
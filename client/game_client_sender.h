@@ -2,6 +2,8 @@
 #define GAME_CLIENT_SENDER_H
 
 #include <memory>
+#include <string>
+#include <vector>
 #include "../common/queue.h"
 #include "../common/socket.h"
 #include "../common/thread.h"
@@ -14,6 +16,15 @@ private:
     Queue<std::string>& outgoing_messages;
     int32_t player_id{-1};
     int32_t game_id{-1};
+    // Teclas de movimiento apretadas (bits INPUT_MASK_*)
+    uint8_t input_mask{0};
+
+    // Arma el mensaje del protocolo a partir del comando textual encolado
+    ClientMessage build_message(const std::string& cmd) const;
+    // Agrega el comando al lote de TCP, salvo los movimientos si hay canal UDP
+    void enqueue(const std::string& cmd, std::vector<ClientMessage>& batch);
+    // Aplica un comando de movimiento a la máscara; false si no es uno
+    static bool update_input_mask(const std::string& cmd, uint8_t& mask);
 
 public:
     explicit GameClientSender(Protocol& proto, Queue<std::string>& messages);
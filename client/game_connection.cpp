@@ -85,6 +85,7 @@ bool GameConnection::connect(const std::string& host, const std::string& port) {
 void GameConnection::start() {
     if (handler_ && !started_) {
         handler_->start();
+        handler_->request_protocol_version();
         started_ = true;
     }
 }
@@ -193,6 +193,16 @@ void GameRenderer::cleanupRemovedCars(
         {
             Car &car = it->second;
 
+            // Los NPCs no se destruyen: si no vienen es que salieron del área de interés
+            if (id < 0)
+            {
+                if (audioManager)
+                    audioManager->stopCarEngine(id);
+                previousCarPositions.erase(id);
+                it = otherCars.erase(it);
+                continue;
+            }
+
             if (!car.isExploding())
             {
                 car.startExplosion();
@@ -0,0 +1,111 @@
+#ifndef COMPACT_CODEC_H
+#define COMPACT_CODEC_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include "constants.h"
+#include "position.h"
+
+// Campos compactos del protocolo v2.
+// Position (7 bytes en vez de 15):
+//   flags (1B): bit 0 on_bridge, bits 1-2 direction_x + 1, bits 3-4 direction_y + 1
+//   x, y (2B c/u): (px - POSITION_ORIGIN_PX) * POSITION_SCALE, relativo al borde del mapa
+//   angle (2B): ANGLE_BITS bits sobre una vuelta completa
+// car_type: índice en CAR_TYPES (CAR_TYPES_COUNT = NPC_CAR); CAR_TYPE_ESCAPE + string si no está
+// Mejoras: 2 bits por nivel (0-3) en un byte
+class CompactCodec
+{
+public:
+    static constexpr unsigned int POSITION_SIZE = 7;
+    static constexpr std::uint8_t CAR_TYPE_ESCAPE = 0xFF;
+
+    static std::uint16_t packCoord(float px)
+    {
+        float q = std::round((px - POSITION_ORIGIN_PX) * POSITION_SCALE);
+        return static_cast<std::uint16_t>(std::clamp(q, 0.0f, 65535.0f));
+    }
+
+    static float unpackCoord(std::uint16_t q)
+    {
+        return static_cast<float>(q) / POSITION_SCALE + POSITION_ORIGIN_PX;
+    }
+
+    static std::uint16_t packAngle(float rad)
+    {
+        constexpr float steps = static_cast<float>(1 << ANGLE_BITS);
+        float turns = rad / (2.0f * static_cast<float>(M_PI));
+        turns -= std::floor(turns);
+        return static_cast<std::uint16_t>(static_cast<int>(std::round(turns * steps)) & ((1 << ANGLE_BITS) - 1));
+    }
+
+    static float unpackAngle(std::uint16_t q)
+    {
+        constexpr float steps = static_cast<float>(1 << ANGLE_BITS);
+        return static_cast<float>(q & ((1 << ANGLE_BITS) - 1)) * (2.0f * static_cast<float>(M_PI)) / steps;
+    }
+
+    static std::uint8_t packFlags(const Position &pos)
+    {
+        std::uint8_t flags = pos.on_bridge ? 1 : 0;
+        flags |= static_cast<std::uint8_t>((pos.direction_x + 1) & 0x03) << 1;
+        flags |= static_cast<std::uint8_t>((pos.direction_y + 1) & 0x03) << 3;
+        return flags;
+    }
+
+    static void unpackFlags(std::uint8_t flags, Position &pos)
+    {
+        pos.on_bridge = (flags & 0x01) != 0;
+        pos.direction_x = static_cast<MovementDirectionX>(((flags >> 1) & 0x03) - 1);
+        pos.direction_y = static_cast<MovementDirectionY>(((flags >> 3) & 0x03) - 1);
+    }
+
+    static std::uint8_t packCarType(const std::string &car_type)
+    {
+        for (int i = 0; i < CAR_TYPES_COUNT; ++i)
+        {
+            if (car_type == CAR_TYPES[i])
+                return static_cast<std::uint8_t>(i);
+        }
+        if (car_type == NPC_CAR)
+            return static_cast<std::uint8_t>(CAR_TYPES_COUNT);
+        return CAR_TYPE_ESCAPE;
+    }
+
+    // nullptr si el índice no es conocido
+    static const char *unpackCarType(std::uint8_t index)
+    {
+        if (index < CAR_TYPES_COUNT)
+            return CAR_TYPES[index];
+        if (index == CAR_TYPES_COUNT)
+            return NPC_CAR;
+        return nullptr;
+    }
+
+    static std::uint8_t packUpgrades(std::uint8_t speed, std::uint8_t acceleration,
+                                     std::uint8_t handling, std::uint8_t durability)
+    {
+        return static_cast<std::uint8_t>((speed & 0x03) | (acceleration & 0x03) << 2 |
+                                         (handling & 0x03) << 4 | (durability & 0x03) << 6);
+    }
+
+    static std::uint8_t unpackUpgrade(std::uint8_t packed, int slot)
+    {
+        return static_cast<std::uint8_t>((packed >> (slot * 2)) & 0x03);
+    }
+
+    // HP en v2: centésimas en 16 bits
+    static std::uint16_t packHp(float hp)
+    {
+        return static_cast<std::uint16_t>(std::clamp(std::round(hp * 100.0f), 0.0f, 65535.0f));
+    }
+
+    static float unpackHp(std::uint16_t q)
+    {
+        return static_cast<float>(q) / 100.0f;
+    }
+};
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef CONSTANTS_H
 #define CONSTANTS_H
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include "install_paths.h"
@@ -38,6 +39,64 @@ const std::uint8_t TOTAL_TIMES = 0x41;
 
 // Game opcodes
 const std::uint8_t UPDATE_POSITIONS = 0x20;
+// Snapshot delta contra el último snapshot confirmado por el cliente
+const std::uint8_t UPDATE_POSITIONS_DELTA = 0x21;
+// Confirmación de snapshot (cliente -> servidor)
+const std::uint8_t SNAPSHOT_ACK = 0x22;
+const std::string SNAPSHOT_ACK_STR = "snapshot_ack";
+
+// Negociación de versión del protocolo: el cliente manda HELLO al conectarse y el
+// servidor responde HELLO con la versión elegida. Sin HELLO se habla la v1.
+const std::uint8_t HELLO = 0x23;
+const std::string HELLO_STR = "hello";
+constexpr std::uint8_t PROTOCOL_VERSION_LEGACY = 1;  // posiciones en float*100 (15 bytes)
+constexpr std::uint8_t PROTOCOL_VERSION_COMPACT = 2; // posiciones cuantizadas (7 bytes)
+// v3: como v2, pero cada mensaje servidor -> cliente (salvo HELLO) lleva delante su
+// largo en un uint32. El sentido cliente -> servidor no cambia.
+constexpr std::uint8_t PROTOCOL_VERSION_FRAMED = 3;
+constexpr std::uint8_t PROTOCOL_VERSION = PROTOCOL_VERSION_FRAMED; // la más nueva de este build
+constexpr std::uint32_t MAX_FRAME_LENGTH = 1 << 20;
+
+// Canal UDP opcional para los snapshots. Después de GAME_JOINED el cliente pide el
+// canal por TCP (UDP_REQUEST) y el servidor responde con el puerto y un token
+// (UDP_OFFER). El cliente manda el token por UDP y, cuando el servidor lo confirma,
+// los snapshots viajan como datagramas y los movimientos como máscaras de teclas.
+// Todo lo demás (lobby, resultados, acks) sigue por TCP.
+const std::uint8_t UDP_REQUEST = 0x24;
+const std::string UDP_REQUEST_STR = "udp_request";
+const std::uint8_t UDP_OFFER = 0x25;
+// Primer byte de cada datagrama
+const std::uint8_t DATAGRAM_BIND = 0x01;      // token (4B); el servidor lo devuelve igual al confirmarlo
+const std::uint8_t DATAGRAM_SNAPSHOT = 0x02;  // seq (4B) + frame de posiciones (v3, con largo)
+const std::uint8_t DATAGRAM_INPUT = 0x03;     // token (4B) + seq (4B) + máscara (1B)
+// Tope para no fragmentar en IP; un snapshot más grande va por TCP
+constexpr std::size_t MAX_DATAGRAM_BYTES = 1200;
+// Bits de la máscara de teclas de DATAGRAM_INPUT
+const std::uint8_t INPUT_MASK_UP = 0x01;
+const std::uint8_t INPUT_MASK_DOWN = 0x02;
+const std::uint8_t INPUT_MASK_LEFT = 0x04;
+const std::uint8_t INPUT_MASK_RIGHT = 0x08;
+
+// Coordenadas v2: 16 bits a 1/8 px desde -64 px cubren -64..8128 px
+// (los mapas miden 4640x4672 px)
+constexpr float POSITION_ORIGIN_PX = -64.0f;
+constexpr float POSITION_SCALE = 8.0f;
+constexpr int ANGLE_BITS = 12;
+
+// Snapshots que guardan servidor y cliente para usar como base de los deltas
+constexpr int SNAPSHOT_HISTORY = 64;
+
+// Campos presentes por entidad en UPDATE_POSITIONS_DELTA
+const std::uint8_t DELTA_POSITION = 0x01;
+const std::uint8_t DELTA_CHECKPOINTS = 0x02;
+const std::uint8_t DELTA_CAR_TYPE = 0x04;
+const std::uint8_t DELTA_HP = 0x08;
+const std::uint8_t DELTA_UPGRADES = 0x10;
+const std::uint8_t DELTA_FLAGS = 0x20;
+const std::uint8_t DELTA_ALL = 0x3F;
+// Bits del byte de flags (DELTA_FLAGS)
+const std::uint8_t DELTA_FLAG_COLLISION = 0x01;
+const std::uint8_t DELTA_FLAG_STOPPING = 0x02;
 
 const int OPCODE_SIZE = 1;
 const std::uint8_t POSITIONS_SIZE = 2;
@@ -206,6 +265,7 @@ inline const std::string MAP_SPAWN_POINTS_PATHS[] = {
 #define RED_JEEP_CAR "red_jeep_car"
 #define PURPLE_TRUCK "purple_truck"
 #define LIMOUSINE_CAR "limousine_car"
+#define NPC_CAR "npc"
 #define DEFAULTS "defaults"
 
 constexpr int CAR_TYPES_COUNT = 7;
@@ -0,0 +1,513 @@
+#include "message_encoder.h"
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <netinet/in.h>
+
+
+MessageEncoder::MessageEncoder(): buffer(), version(PROTOCOL_VERSION_LEGACY) {
+    init_cmd_map();
+    init_encode_handlers();
+}
+
+void MessageEncoder::setVersion(uint8_t protocol_version) {
+    version = protocol_version;
+}
+
+uint8_t MessageEncoder::getVersion() const {
+    return version;
+}
+
+void MessageEncoder::init_encode_handlers() {
+    server_encode_handlers[UPDATE_POSITIONS] = [this](const ServerMessage& out) { encodeUpdatePositions(out); };
+    server_encode_handlers[GAME_JOINED] = [this](const ServerMessage& out) { encodeGameJoined(out); };
+    server_encode_handlers[GAMES_LIST] = [this](const ServerMessage& out) { encodeGamesList(out); };
+    server_encode_handlers[RACE_TIMES] = [this](const ServerMessage& out) { encodeRaceTimes(out); };
+    server_encode_handlers[TOTAL_TIMES] = [this](const ServerMessage& out) { encodeTotalTimes(out); };
+    server_encode_handlers[HELLO] = [this](const ServerMessage& out) { encodeHello(out); };
+    server_encode_handlers[UDP_OFFER] = [this](const ServerMessage& out) { encodeUdpOffer(out); };
+    
+    client_encode_handlers[CREATE_GAME] = [this](const ClientMessage& msg, uint8_t) { encodeCreateGame(msg); };
+    client_encode_handlers[CHANGE_CAR] = [this](const ClientMessage& msg, uint8_t) { encodeChangeCar(msg); };
+    client_encode_handlers[UPGRADE_CAR] = [this](const ClientMessage& msg, uint8_t) { encodeUpgrade(msg); };
+    client_encode_handlers[CHEAT_CMD] = [this](const ClientMessage& msg, uint8_t) { encodeCheat(msg); };
+    client_encode_handlers[SNAPSHOT_ACK] = [this](const ClientMessage& msg, uint8_t) { encodeSnapshotAck(msg); };
+    client_encode_handlers[HELLO] = [this](const ClientMessage& msg, uint8_t) { encodeClientHello(msg); };
+}
+
+
+void MessageEncoder::init_cmd_map() {
+    cmd_to_opcode[MOVE_UP_PRESSED_STR] = MOVE_UP_PRESSED;
+    cmd_to_opcode[MOVE_UP_RELEASED_STR] = MOVE_UP_RELEASED;
+    cmd_to_opcode[MOVE_DOWN_PRESSED_STR] = MOVE_DOWN_PRESSED;
+    cmd_to_opcode[MOVE_DOWN_RELEASED_STR] = MOVE_DOWN_RELEASED;
+    cmd_to_opcode[MOVE_LEFT_PRESSED_STR] = MOVE_LEFT_PRESSED;
+    cmd_to_opcode[MOVE_LEFT_RELEASED_STR] = MOVE_LEFT_RELEASED;
+    cmd_to_opcode[MOVE_RIGHT_PRESSED_STR] = MOVE_RIGHT_PRESSED;
+    cmd_to_opcode[MOVE_RIGHT_RELEASED_STR] = MOVE_RIGHT_RELEASED;
+
+    cmd_to_opcode[CREATE_GAME_STR] = CREATE_GAME;
+    cmd_to_opcode[JOIN_GAME_STR] = JOIN_GAME;
+    cmd_to_opcode[GET_GAMES_STR] = GET_GAMES;
+    cmd_to_opcode[START_GAME_STR] = START_GAME;
+
+    cmd_to_opcode[CHANGE_CAR_STR] = CHANGE_CAR;
+
+    cmd_to_opcode[std::string(CHANGE_CAR_STR) + " " + GREEN_CAR] = CHANGE_CAR;
+    cmd_to_opcode[std::string(CHANGE_CAR_STR) + " " + RED_SQUARED_CAR] = CHANGE_CAR;
+    cmd_to_opcode[std::string(CHANGE_CAR_STR) + " " + RED_SPORTS_CAR] = CHANGE_CAR;
+    cmd_to_opcode[std::string(CHANGE_CAR_STR) + " " + LIGHT_BLUE_CAR] = CHANGE_CAR;
+    cmd_to_opcode[std::string(CHANGE_CAR_STR) + " " + RED_JEEP_CAR] = CHANGE_CAR;
+    cmd_to_opcode[std::string(CHANGE_CAR_STR) + " " + PURPLE_TRUCK] = CHANGE_CAR;
+    cmd_to_opcode[std::string(CHANGE_CAR_STR) + " " + LIMOUSINE_CAR] = CHANGE_CAR;
+    
+    cmd_to_opcode[UPGRADE_CAR_STR] = UPGRADE_CAR;
+
+    cmd_to_opcode[std::string(UPGRADE_CAR_STR) + " 0"] = UPGRADE_CAR;
+    cmd_to_opcode[std::string(UPGRADE_CAR_STR) + " 1"] = UPGRADE_CAR;
+    cmd_to_opcode[std::string(UPGRADE_CAR_STR) + " 2"] = UPGRADE_CAR;
+    cmd_to_opcode[std::string(UPGRADE_CAR_STR) + " 3"] = UPGRADE_CAR;
+
+    cmd_to_opcode[CHEAT_GOD_MODE_STR] = CHEAT_CMD;
+    cmd_to_opcode[CHEAT_DIE_STR] = CHEAT_CMD;
+    cmd_to_opcode[CHEAT_SKIP_LAP_STR] = CHEAT_CMD;
+    cmd_to_opcode[CHEAT_FULL_UPGRADE_STR] = CHEAT_CMD;
+
+    cmd_to_opcode[SNAPSHOT_ACK_STR] = SNAPSHOT_ACK;
+    cmd_to_opcode[HELLO_STR] = HELLO;
+    cmd_to_opcode[UDP_REQUEST_STR] = UDP_REQUEST;
+}
+
+void MessageEncoder::insertUint16(std::uint16_t value) {
+    uint16_t _value = htons(value);
+    appendValue(_value);
+}
+
+void MessageEncoder::insertUint32(std::uint32_t value) {
+    uint32_t _value = htonl(value);
+    appendValue(_value);
+}
+
+void MessageEncoder::prependLength() {
+    if (version < PROTOCOL_VERSION_FRAMED || buffer.empty() || buffer[0] == HELLO)
+        return;
+    uint32_t length = htonl(static_cast<uint32_t>(buffer.size()));
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&length);
+    buffer.insert(buffer.begin(), bytes, bytes + sizeof(length));
+}
+
+uint32_t MessageEncoder::quantizeFloat(float value) {
+    value *= 100;
+    return static_cast<uint32_t>(value);
+}
+
+void MessageEncoder::insertFloat(float value) {
+    insertUint32(quantizeFloat(value));
+}
+
+void MessageEncoder::insertInt(int value) {
+    uint32_t int_value = static_cast<uint32_t>(value);
+    insertUint32(int_value);
+}
+
+void MessageEncoder::insertHp(float hp) {
+    if (version >= PROTOCOL_VERSION_COMPACT) {
+        insertUint16(CompactCodec::packHp(hp));
+        return;
+    }
+    insertFloat(hp);
+}
+
+void MessageEncoder::insertCarType(const std::string& car_type) {
+    if (version >= PROTOCOL_VERSION_COMPACT) {
+        uint8_t index = CompactCodec::packCarType(car_type);
+        buffer.push_back(index);
+        if (index != CompactCodec::CAR_TYPE_ESCAPE)
+            return;
+    }
+    insertString(car_type);
+}
+
+void MessageEncoder::insertUpgrades(const PlayerPositionUpdate& update) {
+    if (version >= PROTOCOL_VERSION_COMPACT) {
+        buffer.push_back(CompactCodec::packUpgrades(update.upgrade_speed, update.upgrade_acceleration,
+                                                    update.upgrade_handling, update.upgrade_durability));
+        return;
+    }
+    buffer.push_back(update.upgrade_speed);
+    buffer.push_back(update.upgrade_acceleration);
+    buffer.push_back(update.upgrade_handling);
+    buffer.push_back(update.upgrade_durability);
+}
+
+void MessageEncoder::insertEntityFlags(const PlayerPositionUpdate& update) {
+    uint8_t flags = 0;
+    if (update.collision_flag)
+        flags |= DELTA_FLAG_COLLISION;
+    if (update.is_stopping)
+        flags |= DELTA_FLAG_STOPPING;
+    buffer.push_back(flags);
+}
+
+void MessageEncoder::insertString(const std::string& str) {
+    uint16_t len = static_cast<uint16_t>(str.size());
+    insertUint16(len);
+    for (char c : str) {
+        buffer.push_back(static_cast<uint8_t>(c));
+    }
+}
+
+void MessageEncoder::insertPosition(const Position& pos) {
+    if (version >= PROTOCOL_VERSION_COMPACT) {
+        buffer.push_back(CompactCodec::packFlags(pos));
+        insertUint16(CompactCodec::packCoord(pos.new_X));
+        insertUint16(CompactCodec::packCoord(pos.new_Y));
+        insertUint16(CompactCodec::packAngle(pos.angle));
+        return;
+    }
+    buffer.push_back(pos.on_bridge ? 1 : 0);
+    buffer.push_back(static_cast<int8_t>(pos.direction_x));
+    buffer.push_back(static_cast<int8_t>(pos.direction_y));
+    insertFloat(pos.new_X);
+    insertFloat(pos.new_Y);
+    insertFloat(pos.angle);
+}
+
+
+std::vector<std::uint8_t> MessageEncoder::encodeClientMessage(const ClientMessage &msg)
+{
+    if (msg.input.action != InputAction::NONE)
+        return encodeInput(msg);
+
+    buffer.clear();
+    const std::string &cmd = msg.cmd;
+
+    auto cmd_it = cmd_to_opcode.find(cmd);
+    if (cmd_it == cmd_to_opcode.end()) {
+        std::cerr << "[MessageEncoder] Unknown command: " << cmd << std::endl;
+        return buffer;
+    }
+    
+    uint8_t opcode = cmd_it->second;
+
+    buffer.push_back(opcode);
+    insertUint32(static_cast<uint32_t>(msg.player_id));
+    insertUint32(static_cast<uint32_t>(msg.game_id));
+    
+    auto it = client_encode_handlers.find(opcode);
+    if (it != client_encode_handlers.end()) {
+        it->second(msg, opcode);
+    }
+    
+    return buffer;
+}
+
+
+std::vector<std::uint8_t> MessageEncoder::encodeInput(const ClientMessage &msg)
+{
+    buffer.clear();
+    InputAction action = msg.input.action;
+    // Los enums siguen el orden de los opcodes de movimiento, CarUpgrade y CheatType
+    auto offset = [action](InputAction first) {
+        return static_cast<uint8_t>(static_cast<uint8_t>(action) - static_cast<uint8_t>(first));
+    };
+
+    if (action >= InputAction::MOVE_UP_PRESSED && action <= InputAction::MOVE_RIGHT_RELEASED) {
+        buffer.push_back(static_cast<uint8_t>(MOVE_UP_PRESSED + offset(InputAction::MOVE_UP_PRESSED)));
+    } else if (action == InputAction::CHANGE_CAR) {
+        buffer.push_back(CHANGE_CAR);
+    } else if (action >= InputAction::UPGRADE_ACCELERATION && action <= InputAction::UPGRADE_DURABILITY) {
+        buffer.push_back(UPGRADE_CAR);
+    } else if (action >= InputAction::CHEAT_GOD_MODE && action <= InputAction::CHEAT_FULL_UPGRADE) {
+        buffer.push_back(CHEAT_CMD);
+    } else {
+        return buffer;
+    }
+    insertUint32(static_cast<uint32_t>(msg.player_id));
+    insertUint32(static_cast<uint32_t>(msg.game_id));
+
+    if (action == InputAction::CHANGE_CAR) {
+        const char *car_type = CompactCodec::unpackCarType(msg.input.arg);
+        insertString(car_type ? car_type : "");
+    } else if (buffer[0] == UPGRADE_CAR) {
+        buffer.push_back(offset(InputAction::UPGRADE_ACCELERATION));
+    } else if (buffer[0] == CHEAT_CMD) {
+        buffer.push_back(offset(InputAction::CHEAT_GOD_MODE));
+    }
+    return buffer;
+}
+
+void MessageEncoder::encodeCreateGame(const ClientMessage& msg) {
+    insertString(msg.game_name);
+    buffer.push_back(msg.map_id);
+}
+
+void MessageEncoder::encodeChangeCar(const ClientMessage& msg) {
+    insertString(msg.car_type);
+}
+
+void MessageEncoder::encodeUpgrade(const ClientMessage& msg) {
+    buffer.push_back(static_cast<uint8_t>(msg.upgrade_type));
+}
+
+void MessageEncoder::encodeCheat(const ClientMessage& msg) {
+    buffer.push_back(static_cast<uint8_t>(msg.cheat_type));
+}
+
+void MessageEncoder::encodeSnapshotAck(const ClientMessage& msg) {
+    insertUint32(msg.snapshot_seq);
+}
+
+void MessageEncoder::encodeClientHello(const ClientMessage& msg) {
+    buffer.push_back(msg.protocol_version);
+}
+
+
+
+std::vector<std::uint8_t> MessageEncoder::encodeServerMessage(const ServerMessage &out)
+{
+    buffer.clear();
+    
+    auto it = server_encode_handlers.find(out.opcode);
+    if (it != server_encode_handlers.end()) {
+        it->second(out);
+    } else {
+        encodeDefaultOpcode(out);
+    }
+    prependLength();
+    
+    return buffer;
+}
+
+EncodedFrame MessageEncoder::encodeFrame(const ServerMessage &out)
+{
+    return std::make_shared<const std::vector<std::uint8_t>>(encodeServerMessage(out));
+}
+
+void MessageEncoder::encodeUpdatePositions(const ServerMessage& out) {
+    buffer.push_back(UPDATE_POSITIONS);
+    buffer.push_back(static_cast<std::uint8_t>(out.positions.size()));
+
+    for (const auto &pos_update : out.positions) {
+        insertInt(pos_update.player_id);
+        insertPosition(pos_update.new_pos);
+
+        uint8_t next_count = static_cast<uint8_t>(pos_update.next_checkpoints.size());
+        buffer.push_back(next_count);
+
+        for (const auto &cp : pos_update.next_checkpoints) {
+            insertPosition(cp);
+        }
+
+        insertCarType(pos_update.car_type);
+
+        insertHp(pos_update.hp);
+        if (version >= PROTOCOL_VERSION_COMPACT) {
+            insertEntityFlags(pos_update);
+            insertUpgrades(pos_update);
+            continue;
+        }
+        buffer.push_back(pos_update.collision_flag ? 1 : 0);
+
+        insertUpgrades(pos_update);
+        
+        buffer.push_back(pos_update.is_stopping ? 1 : 0);
+    }
+}
+
+EncodedFrame MessageEncoder::encodeSnapshotDelta(uint32_t seq, uint32_t baseline_seq,
+                                                 const std::vector<PlayerPositionUpdate>& baseline,
+                                                 const std::vector<PlayerPositionUpdate>& current)
+{
+    std::unordered_map<int, const PlayerPositionUpdate*> base_by_id;
+    base_by_id.reserve(baseline.size());
+    for (const auto &prev : baseline) {
+        base_by_id[prev.player_id] = &prev;
+    }
+
+    buffer.clear();
+    buffer.push_back(UPDATE_POSITIONS_DELTA);
+    insertUint32(seq);
+    insertUint32(baseline_seq);
+
+    // Entidades del baseline que ya no están (jugador que se fue)
+    std::unordered_set<int> in_current;
+    in_current.reserve(current.size());
+    for (const auto &cur : current) {
+        in_current.insert(cur.player_id);
+    }
+    size_t removed_count_idx = buffer.size();
+    buffer.push_back(0);
+    uint8_t removed = 0;
+    for (const auto &prev : baseline) {
+        if (in_current.find(prev.player_id) == in_current.end()) {
+            insertInt(prev.player_id);
+            removed++;
+        }
+    }
+    buffer[removed_count_idx] = removed;
+
+    size_t count_idx = buffer.size();
+    buffer.push_back(0);
+    uint8_t changed = 0;
+    for (const auto &cur : current) {
+        auto it = base_by_id.find(cur.player_id);
+        uint8_t mask = (it == base_by_id.end()) ? DELTA_ALL : deltaMask(*it->second, cur);
+        if (mask == 0)
+            continue;
+        insertEntityDelta(cur, mask);
+        changed++;
+    }
+    buffer[count_idx] = changed;
+    prependLength();
+
+    return std::make_shared<const std::vector<std::uint8_t>>(buffer);
+}
+
+void MessageEncoder::insertEntityDelta(const PlayerPositionUpdate& update, uint8_t mask) {
+    insertInt(update.player_id);
+    buffer.push_back(mask);
+    if (mask & DELTA_POSITION) {
+        insertPosition(update.new_pos);
+    }
+    if (mask & DELTA_CHECKPOINTS) {
+        buffer.push_back(static_cast<uint8_t>(update.next_checkpoints.size()));
+        for (const auto &cp : update.next_checkpoints) {
+            insertPosition(cp);
+        }
+    }
+    if (mask & DELTA_CAR_TYPE) {
+        insertCarType(update.car_type);
+    }
+    if (mask & DELTA_HP) {
+        insertHp(update.hp);
+    }
+    if (mask & DELTA_UPGRADES) {
+        insertUpgrades(update);
+    }
+    if (mask & DELTA_FLAGS) {
+        insertEntityFlags(update);
+    }
+}
+
+bool MessageEncoder::samePosition(const Position& a, const Position& b) const {
+    if (version >= PROTOCOL_VERSION_COMPACT) {
+        return CompactCodec::packFlags(a) == CompactCodec::packFlags(b) &&
+               CompactCodec::packCoord(a.new_X) == CompactCodec::packCoord(b.new_X) &&
+               CompactCodec::packCoord(a.new_Y) == CompactCodec::packCoord(b.new_Y) &&
+               CompactCodec::packAngle(a.angle) == CompactCodec::packAngle(b.angle);
+    }
+    return a.on_bridge == b.on_bridge &&
+           a.direction_x == b.direction_x &&
+           a.direction_y == b.direction_y &&
+           quantizeFloat(a.new_X) == quantizeFloat(b.new_X) &&
+           quantizeFloat(a.new_Y) == quantizeFloat(b.new_Y) &&
+           quantizeFloat(a.angle) == quantizeFloat(b.angle);
+}
+
+bool MessageEncoder::sameHp(float a, float b) const {
+    if (version >= PROTOCOL_VERSION_COMPACT)
+        return CompactCodec::packHp(a) == CompactCodec::packHp(b);
+    return quantizeFloat(a) == quantizeFloat(b);
+}
+
+uint8_t MessageEncoder::deltaMask(const PlayerPositionUpdate& prev, const PlayerPositionUpdate& cur) const {
+    uint8_t mask = 0;
+    if (!samePosition(prev.new_pos, cur.new_pos))
+        mask |= DELTA_POSITION;
+
+    bool same_checkpoints = prev.next_checkpoints.size() == cur.next_checkpoints.size();
+    for (size_t i = 0; same_checkpoints && i < cur.next_checkpoints.size(); ++i) {
+        same_checkpoints = samePosition(prev.next_checkpoints[i], cur.next_checkpoints[i]);
+    }
+    if (!same_checkpoints)
+        mask |= DELTA_CHECKPOINTS;
+
+    if (prev.car_type != cur.car_type)
+        mask |= DELTA_CAR_TYPE;
+    if (!sameHp(prev.hp, cur.hp))
+        mask |= DELTA_HP;
+    if (prev.upgrade_speed != cur.upgrade_speed ||
+        prev.upgrade_acceleration != cur.upgrade_acceleration ||
+        prev.upgrade_handling != cur.upgrade_handling ||
+        prev.upgrade_durability != cur.upgrade_durability)
+        mask |= DELTA_UPGRADES;
+    if (prev.collision_flag != cur.collision_flag || prev.is_stopping != cur.is_stopping)
+        mask |= DELTA_FLAGS;
+    return mask;
+}
+
+void MessageEncoder::encodeGameJoined(const ServerMessage& out) {
+    buffer.push_back(GAME_JOINED);
+    insertUint32(out.game_id);
+    insertUint32(out.player_id);
+    buffer.push_back(out.success ? 1 : 0);
+    buffer.push_back(out.map_id);
+}
+
+void MessageEncoder::encodeGamesList(const ServerMessage& out) {
+    buffer.push_back(GAMES_LIST);
+    insertUint32(static_cast<uint32_t>(out.games.size()));
+    for (const auto &g : out.games) {
+        insertUint32(g.game_id);
+        insertUint32(g.player_count);
+        buffer.push_back(g.map_id);
+        insertString(g.name);
+    }
+}
+
+void MessageEncoder::encodeRaceTimes(const ServerMessage& out) {
+    buffer.push_back(RACE_TIMES);
+    insertUint32(static_cast<uint32_t>(out.race_times.size()));
+    for (const auto &rt : out.race_times) {
+        insertUint32(rt.player_id);
+        insertUint32(rt.time_ms);
+        buffer.push_back(rt.disqualified ? 1 : 0);
+        buffer.push_back(rt.round_index);
+    }
+}
+
+void MessageEncoder::encodeTotalTimes(const ServerMessage& out) {
+    buffer.push_back(TOTAL_TIMES);
+    insertUint32(static_cast<uint32_t>(out.total_times.size()));
+    for (const auto &tt : out.total_times) {
+        insertUint32(tt.player_id);
+        insertUint32(tt.total_ms);
+    }
+}
+
+void MessageEncoder::encodeHello(const ServerMessage& out) {
+    buffer.push_back(HELLO);
+    buffer.push_back(out.protocol_version);
+}
+
+void MessageEncoder::encodeUdpOffer(const ServerMessage& out) {
+    buffer.push_back(UDP_OFFER);
+    insertUint16(out.udp_port);
+    insertUint32(out.udp_token);
+}
+
+void MessageEncoder::encodeDefaultOpcode(const ServerMessage& out) {
+    buffer.push_back(out.opcode);
+}
+
+// ==================== LEGACY FUNCTIONS ====================
+
+std::vector<std::uint8_t> MessageEncoder::encodeOpcode(std::uint8_t opcode)
+{
+    buffer.clear();
+    buffer.push_back(opcode);
+    prependLength();
+    return buffer;
+}
+
+std::vector<std::uint8_t> MessageEncoder::encodeGameJoinedResponse(const GameJoinedResponse &response)
+{
+    buffer.clear();
+    buffer.push_back(GAME_JOINED);
+    insertUint32(response.game_id);
+    insertUint32(response.player_id);
+    buffer.push_back(response.success ? 1 : 0);
+    prependLength();
+    return buffer;
+}
@@ -0,0 +1,110 @@
+#ifndef MESSAGE_ENCODER_H
+#define MESSAGE_ENCODER_H
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "compact_codec.h"
+#include "constants.h"
+#include "messages.h"
+
+// Frame ya codificado e inmutable. Se codifica una sola vez y se comparte
+// (sin copiar) entre los outbox de todos los destinatarios.
+using EncodedFrame = std::shared_ptr<const std::vector<std::uint8_t>>;
+
+// Serializa mensajes al formato del protocolo sin depender de un socket.
+// Protocol lo usa para enviar y el servidor para codificar broadcasts una vez por tick.
+class MessageEncoder
+{
+private:
+    std::vector<uint8_t> buffer;
+    // Versión negociada con el peer: define cómo se codifican posiciones y HP
+    uint8_t version;
+
+    using ServerEncodeHandler = std::function<void(const ServerMessage&)>;
+    std::unordered_map<uint8_t, ServerEncodeHandler> server_encode_handlers;
+
+    using ClientEncodeHandler = std::function<void(const ClientMessage&, uint8_t)>;
+    std::unordered_map<uint8_t, ClientEncodeHandler> client_encode_handlers;
+
+    using CmdToOpcodeMap = std::unordered_map<std::string, uint8_t>;
+    CmdToOpcodeMap cmd_to_opcode;
+
+    void init_cmd_map();
+    void init_encode_handlers();
+
+    template <typename T>
+    void appendValue(T value)
+    {
+        size_t old_size = buffer.size();
+        buffer.resize(old_size + sizeof(T));
+        std::memcpy(buffer.data() + old_size, &value, sizeof(T));
+    }
+
+    void insertUint16(std::uint16_t value);
+    void insertUint32(std::uint32_t value);
+    void insertFloat(float value);
+    void insertInt(int value);
+    void insertString(const std::string& str);
+    void insertPosition(const Position& pos);
+    void insertHp(float hp);
+    void insertCarType(const std::string& car_type);
+    void insertUpgrades(const PlayerPositionUpdate& update);
+    // collision_flag / is_stopping en un byte (bits DELTA_FLAG_*)
+    void insertEntityFlags(const PlayerPositionUpdate& update);
+    // v3: antepone el largo del mensaje ya codificado en buffer (HELLO va sin largo)
+    void prependLength();
+
+    void encodeUpdatePositions(const ServerMessage& out);
+    void encodeGameJoined(const ServerMessage& out);
+    void encodeGamesList(const ServerMessage& out);
+    void encodeRaceTimes(const ServerMessage& out);
+    void encodeTotalTimes(const ServerMessage& out);
+    void encodeHello(const ServerMessage& out);
+    void encodeUdpOffer(const ServerMessage& out);
+    void encodeDefaultOpcode(const ServerMessage& out);
+
+    void insertEntityDelta(const PlayerPositionUpdate& update, uint8_t mask);
+    static uint32_t quantizeFloat(float value);
+    bool samePosition(const Position& a, const Position& b) const;
+    bool sameHp(float a, float b) const;
+    // Campos de cur que cambiaron respecto de prev (comparados ya cuantizados)
+    uint8_t deltaMask(const PlayerPositionUpdate& prev, const PlayerPositionUpdate& cur) const;
+
+    // Acción tipada (msg.input) con el mismo formato que su comando textual
+    std::vector<std::uint8_t> encodeInput(const ClientMessage& msg);
+    void encodeCreateGame(const ClientMessage& msg);
+    void encodeChangeCar(const ClientMessage& msg);
+    void encodeUpgrade(const ClientMessage& msg);
+    void encodeCheat(const ClientMessage& msg);
+    void encodeSnapshotAck(const ClientMessage& msg);
+    void encodeClientHello(const ClientMessage& msg);
+
+public:
+    MessageEncoder();
+    MessageEncoder(const MessageEncoder&) = delete;
+    MessageEncoder& operator=(const MessageEncoder&) = delete;
+
+    void setVersion(uint8_t protocol_version);
+    uint8_t getVersion() const;
+
+    std::vector<std::uint8_t> encodeClientMessage(const ClientMessage& msg);
+    std::vector<std::uint8_t> encodeServerMessage(const ServerMessage& out);
+    // Igual que encodeServerMessage pero devuelve el frame listo para compartir
+    EncodedFrame encodeFrame(const ServerMessage& out);
+    // UPDATE_POSITIONS_DELTA: solo las entidades/campos de current que difieren de
+    // baseline. Con baseline_seq == 0 (baseline vacío) es un keyframe completo.
+    EncodedFrame encodeSnapshotDelta(uint32_t seq, uint32_t baseline_seq,
+                                     const std::vector<PlayerPositionUpdate>& baseline,
+                                     const std::vector<PlayerPositionUpdate>& current);
+
+    std::vector<std::uint8_t> encodeGameJoinedResponse(const GameJoinedResponse& response);
+    std::vector<std::uint8_t> encodeOpcode(std::uint8_t opcode);
+};
+
+#endif
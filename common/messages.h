@@ -55,6 +55,13 @@ struct ServerMessage
 
     // Payload para UPDATE_POSITIONS
     std::vector<PlayerPositionUpdate> positions;
+    // Secuencia del snapshot si llegó como delta (0 = sin secuencia, no se confirma)
+    uint32_t snapshot_seq = 0;
+    // Versión elegida por el servidor (solo si opcode == HELLO)
+    uint8_t protocol_version = 0;
+    // Puerto y token del canal UDP (solo si opcode == UDP_OFFER)
+    uint16_t udp_port = 0;
+    uint32_t udp_token = 0;
 
     // Payload para GAME_JOINED (lobby)
     uint32_t game_id = 0;
@@ -89,9 +96,46 @@ struct ServerMessage
     std::vector<PlayerTotalTime> total_times; // usado si opcode == TOTAL_TIMES
 };
 
+// Acción de juego tipada: viaja del socket a GameEventHandler sin strings ni
+// allocations, y GameEventHandler la usa como índice de su tabla de handlers
+enum class InputAction : uint8_t
+{
+    NONE = 0,
+    MOVE_UP_PRESSED,
+    MOVE_UP_RELEASED,
+    MOVE_DOWN_PRESSED,
+    MOVE_DOWN_RELEASED,
+    MOVE_LEFT_PRESSED,
+    MOVE_LEFT_RELEASED,
+    MOVE_RIGHT_PRESSED,
+    MOVE_RIGHT_RELEASED,
+    CHANGE_CAR,
+    UPGRADE_ACCELERATION,
+    UPGRADE_SPEED,
+    UPGRADE_HANDLING,
+    UPGRADE_DURABILITY,
+    CHEAT_GOD_MODE,
+    CHEAT_DIE,
+    CHEAT_SKIP_LAP,
+    CHEAT_FULL_UPGRADE,
+    COUNT
+};
+
+struct InputEvent
+{
+    InputAction action = InputAction::NONE;
+    // CHANGE_CAR: índice del auto en CAR_TYPES (ver CompactCodec::packCarType)
+    uint8_t arg = 0;
+};
+
 struct ClientMessage
 {
-    // Comando textual (movimientos: move_up_pressed, lobby: create_game, join_game <id>, etc.)
+    // Opcode con el que llegó del socket (0 = desconocido)
+    uint8_t opcode = 0;
+    // Acciones de juego (movimiento, cambio de auto, mejoras, cheats); el resto usa cmd
+    InputEvent input;
+    // Comando textual (lobby: create_game, join_game, etc.). El cliente también arma
+    // las acciones de juego con texto (move_up_pressed, change_car <auto>) antes de enviarlas.
     std::string cmd;
     // Identificador del jugador asignado por el servidor. Antes de recibir GameJoinedResponse -> -1
     int32_t player_id = -1;
@@ -107,5 +151,9 @@ struct ClientMessage
     CarUpgrade upgrade_type = CarUpgrade::ACCELERATION_BOOST;
     // Cheat solicitado
     CheatType cheat_type = CheatType::GOD_MODE;
+    // Último snapshot recibido (solo si cmd == SNAPSHOT_ACK_STR)
+    uint32_t snapshot_seq = 0;
+    // Versión más nueva que habla el cliente (solo si cmd == HELLO_STR)
+    uint8_t protocol_version = PROTOCOL_VERSION_LEGACY;
 };
 #endif
@@ -3,25 +3,24 @@
 #include <iostream>
 #include <utility>
 #include <netinet/in.h>
+#include <sys/uio.h>
 #include <cerrno>
 #include <cstring>
 
-Protocol::Protocol(Socket&& socket) noexcept: skt(std::move(socket)), buffer() {
+Protocol::Protocol(Socket&& socket) noexcept: skt(std::move(socket)), encoder(), version(PROTOCOL_VERSION_LEGACY), inbound(), inbound_pos(0), parsing_inbound(false), outbound(), outbound_pos(0), outbound_bytes(0), udp(), udp_token(0), udp_bind_attempts(0), udp_ready(false), udp_input_seq(0), last_datagram_seq(0), datagram(), snapshot_history() {
     init_handlers();
-    init_cmd_map();
-    init_encode_handlers();
     init_server_receive_handlers();
 }
 
 void Protocol::init_handlers() {
-    receive_handlers[MOVE_UP_PRESSED] = [this]() { return receiveUpPressed(); };
-    receive_handlers[MOVE_UP_RELEASED] = [this]() { return receiveUpRealesed(); };
-    receive_handlers[MOVE_DOWN_PRESSED] = [this]() { return receiveDownPressed(); };
-    receive_handlers[MOVE_DOWN_RELEASED] = [this]() { return receiveDownReleased(); };
-    receive_handlers[MOVE_LEFT_PRESSED] = [this]() { return receiveLeftPressed(); };
-    receive_handlers[MOVE_LEFT_RELEASED] = [this]() { return receiveLeftReleased(); };
-    receive_handlers[MOVE_RIGHT_PRESSED] = [this]() { return receiveRightPressed(); };
-    receive_handlers[MOVE_RIGHT_RELEASED] = [this]() { return receiveRightReleased(); };
+    receive_handlers[MOVE_UP_PRESSED] = [this]() { return receiveInput(InputAction::MOVE_UP_PRESSED); };
+    receive_handlers[MOVE_UP_RELEASED] = [this]() { return receiveInput(InputAction::MOVE_UP_RELEASED); };
+    receive_handlers[MOVE_DOWN_PRESSED] = [this]() { return receiveInput(InputAction::MOVE_DOWN_PRESSED); };
+    receive_handlers[MOVE_DOWN_RELEASED] = [this]() { return receiveInput(InputAction::MOVE_DOWN_RELEASED); };
+    receive_handlers[MOVE_LEFT_PRESSED] = [this]() { return receiveInput(InputAction::MOVE_LEFT_PRESSED); };
+    receive_handlers[MOVE_LEFT_RELEASED] = [this]() { return receiveInput(InputAction::MOVE_LEFT_RELEASED); };
+    receive_handlers[MOVE_RIGHT_PRESSED] = [this]() { return receiveInput(InputAction::MOVE_RIGHT_PRESSED); };
+    receive_handlers[MOVE_RIGHT_RELEASED] = [this]() { return receiveInput(InputAction::MOVE_RIGHT_RELEASED); };
 
     receive_handlers[CREATE_GAME] = [this]() { return receiveCreateGame();};
     receive_handlers[JOIN_GAME] = [this]() { return receiveJoinGame(); };
@@ -32,50 +31,19 @@ void Protocol::init_handlers() {
     receive_handlers[UPGRADE_CAR] = [this]() { return receiveUpgradeCar(); };
 
     receive_handlers[CHEAT_CMD] = [this]() { return receiveCheat(); };
-}
-
-void Protocol::init_cmd_map() {
-    cmd_to_opcode[MOVE_UP_PRESSED_STR] = MOVE_UP_PRESSED;
-    cmd_to_opcode[MOVE_UP_RELEASED_STR] = MOVE_UP_RELEASED;
-    cmd_to_opcode[MOVE_DOWN_PRESSED_STR] = MOVE_DOWN_PRESSED;
-    cmd_to_opcode[MOVE_DOWN_RELEASED_STR] = MOVE_DOWN_RELEASED;
-    cmd_to_opcode[MOVE_LEFT_PRESSED_STR] = MOVE_LEFT_PRESSED;
-    cmd_to_opcode[MOVE_LEFT_RELEASED_STR] = MOVE_LEFT_RELEASED;
-    cmd_to_opcode[MOVE_RIGHT_PRESSED_STR] = MOVE_RIGHT_PRESSED;
-    cmd_to_opcode[MOVE_RIGHT_RELEASED_STR] = MOVE_RIGHT_RELEASED;
-
-    cmd_to_opcode[CREATE_GAME_STR] = CREATE_GAME;
-    cmd_to_opcode[JOIN_GAME_STR] = JOIN_GAME;
-    cmd_to_opcode[GET_GAMES_STR] = GET_GAMES;
-    cmd_to_opcode[START_GAME_STR] = START_GAME;
-
-    cmd_to_opcode[CHANGE_CAR_STR] = CHANGE_CAR;
-
-    cmd_to_opcode[std::string(CHANGE_CAR_STR) + " " + GREEN_CAR] = CHANGE_CAR;
-    cmd_to_opcode[std::string(CHANGE_CAR_STR) + " " + RED_SQUARED_CAR] = CHANGE_CAR;
-    cmd_to_opcode[std::string(CHANGE_CAR_STR) + " " + RED_SPORTS_CAR] = CHANGE_CAR;
-    cmd_to_opcode[std::string(CHANGE_CAR_STR) + " " + LIGHT_BLUE_CAR] = CHANGE_CAR;
-    cmd_to_opcode[std::string(CHANGE_CAR_STR) + " " + RED_JEEP_CAR] = CHANGE_CAR;
-    cmd_to_opcode[std::string(CHANGE_CAR_STR) + " " + PURPLE_TRUCK] = CHANGE_CAR;
-    cmd_to_opcode[std::string(CHANGE_CAR_STR) + " " + LIMOUSINE_CAR] = CHANGE_CAR;
-    
-    cmd_to_opcode[UPGRADE_CAR_STR] = UPGRADE_CAR;
 
-    cmd_to_opcode[std::string(UPGRADE_CAR_STR) + " 0"] = UPGRADE_CAR;
-    cmd_to_opcode[std::string(UPGRADE_CAR_STR) + " 1"] = UPGRADE_CAR;
-    cmd_to_opcode[std::string(UPGRADE_CAR_STR) + " 2"] = UPGRADE_CAR;
-    cmd_to_opcode[std::string(UPGRADE_CAR_STR) + " 3"] = UPGRADE_CAR;
-
-    cmd_to_opcode[CHEAT_GOD_MODE_STR] = CHEAT_CMD;
-    cmd_to_opcode[CHEAT_DIE_STR] = CHEAT_CMD;
-    cmd_to_opcode[CHEAT_SKIP_LAP_STR] = CHEAT_CMD;
-    cmd_to_opcode[CHEAT_FULL_UPGRADE_STR] = CHEAT_CMD;
+    receive_handlers[SNAPSHOT_ACK] = [this]() { return receiveSnapshotAck(); };
+    receive_handlers[HELLO] = [this]() { return receiveHello(); };
+    receive_handlers[UDP_REQUEST] = [this]() { return receiveUdpRequest(); };
 }
 
 void Protocol::init_server_receive_handlers() {
     server_receive_handlers[UPDATE_POSITIONS] = [this](ServerMessage& out, GameJoinedResponse&) {
         out = receivePositionsUpdate();
     };
+    server_receive_handlers[UPDATE_POSITIONS_DELTA] = [this](ServerMessage& out, GameJoinedResponse&) {
+        out = receivePositionsDelta();
+    };
     server_receive_handlers[GAME_JOINED] = [this](ServerMessage&, GameJoinedResponse& joined) {
         joined = receiveGameJoinedResponse();
     };
@@ -94,16 +62,24 @@ void Protocol::init_server_receive_handlers() {
     server_receive_handlers[TOTAL_TIMES] = [this](ServerMessage& out, GameJoinedResponse&) {
         out = receiveTotalTimes();
     };
+    server_receive_handlers[HELLO] = [this](ServerMessage& out, GameJoinedResponse&) {
+        out = receiveHelloReply();
+    };
+    server_receive_handlers[UDP_OFFER] = [this](ServerMessage& out, GameJoinedResponse&) {
+        out = receiveUdpOffer();
+    };
 }
 
 ClientMessage Protocol::receiveClientMessage() {
     uint8_t opcode;
-    if (skt.recvall(&opcode, sizeof(opcode)) <= 0)
+    if (recvBytes(&opcode, sizeof(opcode)) <= 0)
         return {};
 
     auto it = receive_handlers.find(opcode);
     if (it != receive_handlers.end()) {
-        return it->second(); 
+        ClientMessage msg = it->second();
+        msg.opcode = opcode;
+        return msg;
     }
     
     return {};  // Opcode desconocido
@@ -112,7 +88,21 @@ ClientMessage Protocol::receiveClientMessage() {
 bool Protocol::receiveAnyServerPacket(ServerMessage& outServer,
                                       GameJoinedResponse& outJoined,
                                       uint8_t& outOpcode) {
-    ssize_t recv_result = skt.recvall(&outOpcode, sizeof(outOpcode));
+    // Con el canal UDP abierto se espera en los dos sockets: un snapshot por UDP
+    // no tiene que esperar a que TCP retransmita nada
+    while (udp && !hasBufferedFrame()) {
+        bool udp_readable = false;
+        bool tcp_readable = waitForServerData(udp_readable);
+        if (udp_readable && receiveDatagram(outServer, outOpcode))
+            return true;
+        if (tcp_readable)
+            break;
+    }
+
+    if (version >= PROTOCOL_VERSION_FRAMED)
+        return receiveFramedServerPacket(outServer, outJoined, outOpcode);
+
+    ssize_t recv_result = recvBytes(&outOpcode, sizeof(outOpcode));
     if (recv_result <= 0) {
         return false;
     }
@@ -127,16 +117,93 @@ bool Protocol::receiveAnyServerPacket(ServerMessage& outServer,
     return false;
 }
 
+bool Protocol::receiveFramedServerPacket(ServerMessage& outServer,
+                                         GameJoinedResponse& outJoined,
+                                         uint8_t& outOpcode) {
+    uint32_t length;
+    if (recvBytes(&length, sizeof(length)) <= 0)
+        return false;
+    length = ntohl(length);
+    if (length == 0 || length > MAX_FRAME_LENGTH) {
+        std::cerr << "[Protocol] receiveAnyServerPacket: largo de frame inválido " << length << std::endl;
+        return false;
+    }
+    if (inbound.size() - inbound_pos < length && !fillInbound(length))
+        return false;
+
+    return decodeBufferedFrame(length, outServer, outJoined, outOpcode);
+}
+
+bool Protocol::decodeBufferedFrame(size_t length, ServerMessage& outServer,
+                                   GameJoinedResponse& outJoined, uint8_t& outOpcode) {
+    // El frame entero ya está en memoria: decodificarlo no hace más syscalls
+    size_t frame_end = inbound_pos + length;
+    bool complete = true;
+    parsing_inbound = true;
+    try {
+        recvBytes(&outOpcode, sizeof(outOpcode));
+        auto it = server_receive_handlers.find(outOpcode);
+        if (it != server_receive_handlers.end()) {
+            it->second(outServer, outJoined);
+        } else {
+            // Con el largo se puede saltear un mensaje que este build no conoce
+            std::cerr << "[Protocol] receiveAnyServerPacket: opcode desconocido " << int(outOpcode) << ", se saltea" << std::endl;
+        }
+    } catch (const IncompleteFrame&) {
+        complete = false;
+    }
+    parsing_inbound = false;
+
+    if (!complete || inbound_pos > frame_end) {
+        std::cerr << "[Protocol] receiveAnyServerPacket: frame mal formado (opcode " << int(outOpcode) << ")" << std::endl;
+        return false;
+    }
+    inbound_pos = frame_end;
+    return true;
+}
+
 void Protocol::sendMessage(ServerMessage& out) {
-    auto msg = encodeServerMessage(out);
+    auto msg = encoder.encodeServerMessage(out);
     skt.sendall(msg.data(), msg.size());
 }
 
 void Protocol::sendMessage(ClientMessage& out) {
-    auto msg = encodeClientMessage(out);
+    auto msg = encoder.encodeClientMessage(out);
     skt.sendall(msg.data(), msg.size());
 }
 
+void Protocol::sendMessages(std::vector<ClientMessage>& batch) {
+    std::vector<std::vector<uint8_t>> frames;
+    frames.reserve(batch.size());
+    for (ClientMessage& msg : batch) {
+        frames.push_back(encoder.encodeClientMessage(msg));
+    }
+    std::vector<struct iovec> iov;
+    iov.reserve(frames.size());
+    for (auto& frame : frames) {
+        if (!frame.empty())
+            iov.push_back({frame.data(), frame.size()});
+    }
+    if (!iov.empty())
+        skt.sendallv(iov.data(), static_cast<int>(iov.size()));
+}
+
+void Protocol::setVersion(uint8_t protocol_version) {
+    version = protocol_version;
+    encoder.setVersion(protocol_version);
+}
+
+uint8_t Protocol::getVersion() const {
+    return version;
+}
+
+void Protocol::setNoDelay(bool enabled) {
+    skt.set_nodelay(enabled);
+}
+
+void Protocol::setSendBuffer(int bytes) {
+    skt.set_send_buffer(bytes);
+}
 
 void Protocol::shutdown() {
     try {
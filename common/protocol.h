@@ -1,53 +1,93 @@
 #ifndef PROTOCOL_H
 #define PROTOCOL_H
 
+#include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <functional>
 
 #include "constants.h"
+#include "message_encoder.h"
 #include "messages.h"
 #include "socket.h"
+#include "udp_socket.h"
 
 class Protocol
 {
 private:
     Socket skt;
-    std::vector<uint8_t> buffer;
+    MessageEncoder encoder;
+    // Versión negociada con HELLO (v1 hasta que se negocie)
+    uint8_t version;
     std::vector<uint8_t> readBuffer;
 
+    // Bytes recibidos sin decodificar (en ambos modos) y bytes pendientes de envío
+    std::vector<uint8_t> inbound;
+    size_t inbound_pos;
+    bool parsing_inbound;
+    // Los frames se encolan sin copiar: un broadcast comparte el mismo buffer entre clientes
+    std::deque<EncodedFrame> outbound;
+    size_t outbound_pos;  // bytes ya enviados del primer frame
+    size_t outbound_bytes;
+
+    // Canal UDP del cliente (ver UDP_OFFER). El receiver lo abre y lee de él;
+    // el sender solo manda máscaras de input una vez que udp_ready está en true.
+    std::unique_ptr<UdpSocket> udp;
+    std::atomic<uint32_t> udp_token;
+    int udp_bind_attempts;
+    std::atomic<bool> udp_ready;
+    uint32_t udp_input_seq;
+    // Último snapshot aceptado por UDP: los más viejos o repetidos se descartan
+    uint32_t last_datagram_seq;
+    std::vector<uint8_t> datagram;
+
+    // Snapshots ya reconstruidos (seq, estado completo) que pueden usarse como base de un delta
+    std::deque<std::pair<uint32_t, std::vector<PlayerPositionUpdate>>> snapshot_history;
+
+    // Se lanza al decodificar desde inbound cuando el frame todavía no llegó completo
+    struct IncompleteFrame {};
+
+    // Lee sz bytes de inbound. En modo bloqueante, si no alcanzan, primero lo completa
+    // desde el socket; si se está decodificando de memoria lanza IncompleteFrame.
+    int recvBytes(void* data, unsigned int sz);
+    // Bloquea hasta tener sz bytes sin consumir en inbound, pidiendo al kernel todo
+    // lo que tenga en cada recv. Retorna false si el peer cerró antes.
+    bool fillInbound(size_t sz);
+    // Vacía outbound con writev; false si el peer cerró
+    bool writeOutbound();
+    // v3: lee el largo, junta el frame completo y lo decodifica desde memoria
+    bool receiveFramedServerPacket(ServerMessage& outServer,
+                                   GameJoinedResponse& outJoined,
+                                   uint8_t& outOpcode);
+    // Decodifica los length bytes que empiezan en inbound_pos y los consume
+    bool decodeBufferedFrame(size_t length, ServerMessage& outServer,
+                             GameJoinedResponse& outJoined, uint8_t& outOpcode);
+
+    // true si inbound ya tiene un frame v3 completo
+    bool hasBufferedFrame() const;
+    // Espera a que haya algo para leer en TCP o UDP. Mientras el servidor no
+    // confirme el canal, reintenta el DATAGRAM_BIND cada tanto.
+    bool waitForServerData(bool& udp_readable);
+    // Lee un datagrama; true si trajo un snapshot nuevo
+    bool receiveDatagram(ServerMessage& outServer, uint8_t& outOpcode);
+    bool decodeDatagram(size_t size, ServerMessage& outServer, uint8_t& outOpcode);
+    void sendBind();
+
     using ClientMessageHandler = std::function<ClientMessage()>;
     std::unordered_map<uint8_t, ClientMessageHandler> receive_handlers;
     
-    using ServerEncodeHandler = std::function<void(ServerMessage&)>;
-    std::unordered_map<uint8_t, ServerEncodeHandler> server_encode_handlers;
-    
-    using ClientEncodeHandler = std::function<void(const ClientMessage&, uint8_t)>;
-    std::unordered_map<uint8_t, ClientEncodeHandler> client_encode_handlers;
-    
     using ServerReceiveHandler = std::function<void(ServerMessage&, GameJoinedResponse&)>;
     std::unordered_map<uint8_t, ServerReceiveHandler> server_receive_handlers;
     
-    using CmdToOpcodeMap = std::unordered_map<std::string, uint8_t>;
-    CmdToOpcodeMap cmd_to_opcode;
-    
     void init_handlers();
-    void init_cmd_map();
-    void init_encode_handlers();
     void init_server_receive_handlers();
 
 
-    template <typename T>
-    void appendValue(T value)
-    {
-        size_t old_size = buffer.size();
-        buffer.resize(old_size + sizeof(T));
-        std::memcpy(buffer.data() + old_size, &value, sizeof(T));
-    }
-
     template <typename T>
     T readValue(const std::vector<uint8_t> &buffer, size_t &idx)
     {
@@ -57,13 +97,6 @@ private:
         return value;
     }
 
-    void insertUint16(std::uint16_t value);
-    void insertUint32(std::uint32_t value);
-    void insertFloat(float value);
-    void insertInt(int value);
-    void insertString(const std::string& str);
-    void insertPosition(const Position& pos);
-
     uint16_t exportUint16(const std::vector<uint8_t> &buffer, size_t &idx);
     uint32_t exportUint32(const std::vector<uint8_t> &buffer, size_t &idx);
     float exportFloat(const std::vector<uint8_t> &buffer, size_t &idx);
@@ -73,34 +106,16 @@ private:
     
     bool readPosition(Position& pos);
     bool readString(std::string& str);
+    bool readHp(float& hp);
+    bool readCarType(std::string& car_type);
+    bool readUpgrades(PlayerPositionUpdate& update);
+    bool readEntityFlags(PlayerPositionUpdate& update);
     bool readPlayerPositionUpdate(PlayerPositionUpdate& update);
+    bool readEntityDelta(PlayerPositionUpdate& update, uint8_t& mask);
+    static void applyEntityDelta(PlayerPositionUpdate& target, const PlayerPositionUpdate& update, uint8_t mask);
 
-    std::vector<std::uint8_t> encodeClientMessage(const ClientMessage &msg);
-    std::vector<std::uint8_t> encodeServerMessage(ServerMessage& out);
-    std::vector<std::uint8_t> encodeGameJoinedResponse(const GameJoinedResponse& response);
-
-    std::vector<std::uint8_t> encodeOpcode(std::uint8_t opcode);
-
-    void encodeUpdatePositions(ServerMessage& out);
-    void encodeGameJoined(ServerMessage& out);
-    void encodeGamesList(ServerMessage& out);
-    void encodeRaceTimes(ServerMessage& out);
-    void encodeTotalTimes(ServerMessage& out);
-    void encodeDefaultOpcode(ServerMessage& out);
-    
-    void encodeCreateGame(const ClientMessage& msg);
-    void encodeChangeCar(const ClientMessage& msg);
-    void encodeUpgrade(const ClientMessage& msg);
-    void encodeCheat(const ClientMessage& msg);
-
-    ClientMessage receiveUpPressed();
-    ClientMessage receiveUpRealesed();
-    ClientMessage receiveDownPressed();
-    ClientMessage receiveDownReleased();
-    ClientMessage receiveLeftPressed();
-    ClientMessage receiveLeftReleased();
-    ClientMessage receiveRightPressed();
-    ClientMessage receiveRightReleased();
+    // Movimientos: solo los ids, la acción la define el opcode
+    ClientMessage receiveInput(InputAction action);
     ClientMessage receiveCreateGame();
     ClientMessage receiveJoinGame();
     ClientMessage receiveGetGames();
@@ -108,14 +123,21 @@ private:
     ClientMessage receiveChangeCar();
     ClientMessage receiveUpgradeCar();
     ClientMessage receiveCheat();
+    ClientMessage receiveSnapshotAck();
+    ClientMessage receiveHello();
+    ClientMessage receiveUdpRequest();
 
     ServerMessage receivePositionsUpdate();
+    // Reconstruye el UPDATE_POSITIONS completo a partir del delta y su baseline
+    ServerMessage receivePositionsDelta();
     ServerMessage receiveGamesList();
     GameJoinedResponse receiveGameJoinedResponse();
     ServerMessage receiveRaceTimes();
     ServerMessage receiveTotalTimes();
 
     ServerMessage receiveStartingCountdown();
+    ServerMessage receiveHelloReply();
+    ServerMessage receiveUdpOffer();
 
 public:
     explicit Protocol(Socket &&socket) noexcept;
@@ -134,9 +156,46 @@ public:
     
     void sendMessage(ServerMessage& out);
     void sendMessage(ClientMessage& out);
+    // Envía todos los mensajes con una sola escritura (writev)
+    void sendMessages(std::vector<ClientMessage>& batch);
     void sendMessage(const GameJoinedResponse& response);
 
     void shutdown();
+
+    // Desactiva Nagle: los inputs y frames chicos salen sin esperar ACKs
+    void setNoDelay(bool enabled);
+    // Buffer de envío del kernel para esta conexión (SO_SNDBUF)
+    void setSendBuffer(int bytes);
+
+    // Versión con la que se codifican y decodifican posiciones en esta conexión
+    void setVersion(uint8_t protocol_version);
+    uint8_t getVersion() const;
+
+    // ---- Canal UDP (cliente) ----
+    // Abre el socket UDP hacia el servidor y manda el token recibido en UDP_OFFER
+    // (si ya estaba abierto, al unirse a otra partida, solo cambia de token).
+    // Desde entonces receiveAnyServerPacket también devuelve snapshots que lleguen por UDP.
+    void openDatagramChannel(uint16_t port, uint32_t token);
+    // true cuando el servidor confirmó el token
+    bool datagramChannelReady() const;
+    // Teclas de movimiento apretadas (bits INPUT_MASK_*), por UDP
+    void sendInputMask(uint8_t mask);
+
+    // ---- Modo no bloqueante (lo usa el Reactor, siempre desde su thread) ----
+    void setNonBlocking();
+    int getFd() const;
+    // Lee todo lo disponible en el socket. Retorna false si el peer cerró la conexión.
+    bool readAvailable();
+    // Decodifica el próximo mensaje completo recibido; false si falta data.
+    bool nextClientMessage(ClientMessage& out);
+    // Agrega el mensaje codificado al buffer de salida
+    void queueMessage(ServerMessage& out);
+    // Encola un frame ya codificado (compartido) sin copiar sus bytes
+    void queueFrame(const EncodedFrame& frame);
+    // Envía lo que el socket acepte del buffer de salida. Retorna false si el peer cerró.
+    bool flushPending();
+    bool hasPendingOutput() const;
+    size_t pendingOutputBytes() const;
 };
 
 #endif
@@ -0,0 +1,131 @@
+#include "protocol.h"
+
+#include <iostream>
+#include <netinet/in.h>
+#include <poll.h>
+
+// Un datagrama nunca supera esto (tope de UDP sobre IPv4)
+#define DATAGRAM_BUFFER_SIZE 65536
+// Reintentos del DATAGRAM_BIND mientras el servidor no lo confirme
+#define BIND_RETRY_MS 200
+#define MAX_BIND_ATTEMPTS 10
+// tipo (1B) + seq (4B) + largo del frame (4B)
+#define SNAPSHOT_HEADER_SIZE 9
+
+void Protocol::openDatagramChannel(uint16_t port, uint32_t token) {
+    if (!udp) {
+        udp = std::make_unique<UdpSocket>(skt, port);
+        udp->set_nonblocking(true);
+        datagram.resize(DATAGRAM_BUFFER_SIZE);
+    }
+    // Token nuevo: hasta que el servidor lo confirme no se mandan inputs y la
+    // numeración de snapshots empieza de nuevo
+    udp_ready.store(false, std::memory_order_release);
+    udp_token.store(token, std::memory_order_release);
+    udp_bind_attempts = 0;
+    last_datagram_seq = 0;
+    sendBind();
+}
+
+bool Protocol::datagramChannelReady() const {
+    return udp_ready.load(std::memory_order_acquire);
+}
+
+void Protocol::sendBind() {
+    uint8_t bind[1 + sizeof(uint32_t)];
+    bind[0] = DATAGRAM_BIND;
+    uint32_t token = htonl(udp_token.load(std::memory_order_acquire));
+    std::memcpy(bind + 1, &token, sizeof(token));
+    udp->send(bind, sizeof(bind));
+    udp_bind_attempts++;
+}
+
+void Protocol::sendInputMask(uint8_t mask) {
+    if (!datagramChannelReady())
+        return;
+    uint8_t input[1 + 2 * sizeof(uint32_t) + 1];
+    input[0] = DATAGRAM_INPUT;
+    uint32_t token = htonl(udp_token.load(std::memory_order_acquire));
+    uint32_t seq = htonl(++udp_input_seq);
+    std::memcpy(input + 1, &token, sizeof(token));
+    std::memcpy(input + 1 + sizeof(token), &seq, sizeof(seq));
+    input[1 + 2 * sizeof(uint32_t)] = mask;
+    udp->send(input, sizeof(input));
+}
+
+bool Protocol::hasBufferedFrame() const {
+    size_t available = inbound.size() - inbound_pos;
+    if (version < PROTOCOL_VERSION_FRAMED)
+        return available > 0;
+    if (available < sizeof(uint32_t))
+        return false;
+    uint32_t length;
+    std::memcpy(&length, inbound.data() + inbound_pos, sizeof(length));
+    return available - sizeof(length) >= ntohl(length);
+}
+
+bool Protocol::waitForServerData(bool& udp_readable) {
+    struct pollfd fds[2];
+    fds[0] = {skt.get_fd(), POLLIN, 0};
+    fds[1] = {udp->get_fd(), POLLIN, 0};
+    bool binding = !datagramChannelReady() && udp_bind_attempts < MAX_BIND_ATTEMPTS;
+
+    int ready = poll(fds, 2, binding ? BIND_RETRY_MS : -1);
+    if (ready == 0 && binding)
+        sendBind();
+    // Si poll falla (EINTR) se vuelve a esperar
+    udp_readable = ready > 0 && (fds[1].revents & POLLIN);
+    // Un error o cierre en TCP también se atiende por el camino de TCP
+    return ready > 0 && (fds[0].revents & (POLLIN | POLLHUP | POLLERR));
+}
+
+bool Protocol::receiveDatagram(ServerMessage& outServer, uint8_t& outOpcode) {
+    // Se vacía la cola del socket: un datagrama viejo no tiene que dejar
+    // esperando a los que llegaron detrás
+    int s;
+    while ((s = udp->recv(datagram.data(), datagram.size())) >= 0) {
+        if (s > 0 && decodeDatagram(static_cast<size_t>(s), outServer, outOpcode))
+            return true;
+    }
+    return false;
+}
+
+bool Protocol::decodeDatagram(size_t size, ServerMessage& outServer, uint8_t& outOpcode) {
+
+    if (datagram[0] == DATAGRAM_BIND) {
+        uint32_t token;
+        if (size >= 1 + sizeof(token) && !datagramChannelReady()) {
+            std::memcpy(&token, datagram.data() + 1, sizeof(token));
+            if (ntohl(token) == udp_token.load(std::memory_order_acquire))
+                udp_ready.store(true, std::memory_order_release);
+        }
+        return false;
+    }
+    if (datagram[0] != DATAGRAM_SNAPSHOT || size < SNAPSHOT_HEADER_SIZE)
+        return false;
+
+    uint32_t seq;
+    uint32_t length;
+    std::memcpy(&seq, datagram.data() + 1, sizeof(seq));
+    std::memcpy(&length, datagram.data() + 1 + sizeof(seq), sizeof(length));
+    seq = ntohl(seq);
+    length = ntohl(length);
+    // Llegó tarde (ya se mostró uno más nuevo) o repetido: no se usa
+    if (seq <= last_datagram_seq || SNAPSHOT_HEADER_SIZE + length != size)
+        return false;
+
+    // El frame vino entero en el datagrama: se decodifica desde ahí como si fuese
+    // inbound, sin tocar lo que haya a medio llegar por TCP
+    std::swap(inbound, datagram);
+    size_t tcp_pos = inbound_pos;
+    inbound_pos = SNAPSHOT_HEADER_SIZE;
+    GameJoinedResponse unused{};
+    bool decoded = decodeBufferedFrame(length, outServer, unused, outOpcode);
+    std::swap(inbound, datagram);
+    inbound_pos = tcp_pos;
+
+    if (!decoded || (outOpcode != UPDATE_POSITIONS && outOpcode != UPDATE_POSITIONS_DELTA))
+        return false;
+    last_datagram_seq = seq;
+    return true;
+}
@@ -0,0 +1,151 @@
+#include "protocol.h"
+
+#include <algorithm>
+#include <sys/uio.h>
+
+#define READ_CHUNK 4096
+// Lectura bloqueante: un recv grande trae de una vez varios mensajes ya encolados
+#define BUFFERED_READ_CHUNK (16 * 1024)
+// Tope de lectura por evento para no acaparar el reactor con un solo cliente
+#define MAX_READ_PER_EVENT (64 * 1024)
+// Frames por writev al vaciar el buffer de salida
+#define MAX_IOV_PER_WRITE 64
+
+int Protocol::recvBytes(void* data, unsigned int sz) {
+    if (!parsing_inbound && inbound.size() - inbound_pos < sz && !fillInbound(sz))
+        return 0;
+
+    if (inbound.size() - inbound_pos < sz)
+        throw IncompleteFrame{};
+    std::memcpy(data, inbound.data() + inbound_pos, sz);
+    inbound_pos += sz;
+    return static_cast<int>(sz);
+}
+
+bool Protocol::fillInbound(size_t sz) {
+    // Lo consumido se descarta: acá solo queda el pedazo de un mensaje a medio llegar
+    if (inbound_pos > 0) {
+        inbound.erase(inbound.begin(), inbound.begin() + inbound_pos);
+        inbound_pos = 0;
+    }
+    while (inbound.size() < sz) {
+        size_t old_size = inbound.size();
+        size_t chunk = std::max<size_t>(BUFFERED_READ_CHUNK, sz - old_size);
+        inbound.resize(old_size + chunk);
+        int s = skt.recvsome(inbound.data() + old_size, chunk);
+        inbound.resize(old_size + (s > 0 ? s : 0));
+        if (s <= 0)
+            return false;
+    }
+    return true;
+}
+
+void Protocol::setNonBlocking() {
+    skt.set_nonblocking(true);
+}
+
+int Protocol::getFd() const {
+    return skt.get_fd();
+}
+
+bool Protocol::readAvailable() {
+    size_t total = 0;
+    while (total < MAX_READ_PER_EVENT) {
+        size_t old_size = inbound.size();
+        inbound.resize(old_size + READ_CHUNK);
+        int s = skt.recvsome(inbound.data() + old_size, READ_CHUNK);
+        inbound.resize(old_size + (s > 0 ? s : 0));
+        if (s == 0)
+            return false;
+        if (s < 0)
+            break;  // EAGAIN: no hay más por ahora
+        total += s;
+    }
+    return true;
+}
+
+bool Protocol::nextClientMessage(ClientMessage& out) {
+    if (inbound_pos >= inbound.size())
+        return false;
+
+    size_t frame_start = inbound_pos;
+    parsing_inbound = true;
+    try {
+        out = receiveClientMessage();
+    } catch (const IncompleteFrame&) {
+        // Se reintenta cuando llegue el resto del frame
+        inbound_pos = frame_start;
+        parsing_inbound = false;
+        return false;
+    }
+    parsing_inbound = false;
+
+    // Compactar cuando lo consumido supera lo pendiente
+    if (inbound_pos * 2 >= inbound.size()) {
+        inbound.erase(inbound.begin(), inbound.begin() + inbound_pos);
+        inbound_pos = 0;
+    }
+    return true;
+}
+
+void Protocol::queueMessage(ServerMessage& out) {
+    queueFrame(encoder.encodeFrame(out));
+}
+
+void Protocol::queueFrame(const EncodedFrame& frame) {
+    if (!frame || frame->empty())
+        return;
+    outbound.push_back(frame);
+    outbound_bytes += frame->size();
+}
+
+bool Protocol::flushPending() {
+    // Si no entra todo en una escritura, el cork evita mandar un segmento a medias entre una y otra
+    bool corked = outbound.size() > MAX_IOV_PER_WRITE;
+    if (corked)
+        skt.set_cork(true);
+    bool open = writeOutbound();
+    if (corked)
+        skt.set_cork(false);
+    return open;
+}
+
+bool Protocol::writeOutbound() {
+    while (!outbound.empty()) {
+        // Los frames pendientes salen juntos en un writev, sin copiarlos a un buffer contiguo
+        struct iovec iov[MAX_IOV_PER_WRITE];
+        int count = 0;
+        for (auto it = outbound.begin(); it != outbound.end() && count < MAX_IOV_PER_WRITE; ++it, ++count) {
+            size_t skip = (count == 0) ? outbound_pos : 0;
+            iov[count].iov_base = const_cast<uint8_t*>((*it)->data()) + skip;
+            iov[count].iov_len = (*it)->size() - skip;
+        }
+        int s = skt.sendsomev(iov, count);
+        if (s == 0)
+            return false;
+        if (s < 0)
+            return true;  // buffer del kernel lleno: esperar EPOLLOUT
+        outbound_bytes -= s;
+
+        size_t left = s;
+        while (left > 0) {
+            size_t remaining = outbound.front()->size() - outbound_pos;
+            if (left < remaining) {
+                outbound_pos += left;
+                break;
+            }
+            left -= remaining;
+            outbound.pop_front();
+            outbound_pos = 0;
+        }
+    }
+    return true;
+}
+
+bool Protocol::hasPendingOutput() const {
+    return outbound_bytes > 0;
+}
+
+size_t Protocol::pendingOutputBytes() const {
+    return outbound_bytes;
+}
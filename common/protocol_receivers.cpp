@@ -1,9 +1,13 @@
 #include "protocol.h"
+#include <algorithm>
+#include <iostream>
+#include <unordered_set>
+#include <netinet/in.h>
 
 void Protocol::readClientIds(ClientMessage &msg)
 {
     readBuffer.resize(sizeof(uint32_t) * 2);
-    if (skt.recvall(readBuffer.data(), readBuffer.size()) <= 0)
+    if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0)
     {
         msg.player_id = -1;
         msg.game_id = -1;
@@ -14,66 +18,10 @@ void Protocol::readClientIds(ClientMessage &msg)
     msg.game_id = static_cast<int32_t>(exportUint32(readBuffer, idx));
 }
 
-ClientMessage Protocol::receiveUpPressed()
+ClientMessage Protocol::receiveInput(InputAction action)
 {
     ClientMessage msg;
-    msg.cmd = MOVE_UP_PRESSED_STR;
-    readClientIds(msg);
-    return msg;
-}
-
-ClientMessage Protocol::receiveUpRealesed()
-{
-    ClientMessage msg;
-    msg.cmd = MOVE_UP_RELEASED_STR;
-    readClientIds(msg);
-    return msg;
-}
-
-ClientMessage Protocol::receiveDownPressed()
-{
-    ClientMessage msg;
-    msg.cmd = MOVE_DOWN_PRESSED_STR;
-    readClientIds(msg);
-    return msg;
-}
-
-ClientMessage Protocol::receiveDownReleased()
-{
-    ClientMessage msg;
-    msg.cmd = MOVE_DOWN_RELEASED_STR;
-    readClientIds(msg);
-    return msg;
-}
-
-ClientMessage Protocol::receiveLeftPressed()
-{
-    ClientMessage msg;
-    msg.cmd = MOVE_LEFT_PRESSED_STR;
-    readClientIds(msg);
-    return msg;
-}
-
-ClientMessage Protocol::receiveLeftReleased()
-{
-    ClientMessage msg;
-    msg.cmd = MOVE_LEFT_RELEASED_STR;
-    readClientIds(msg);
-    return msg;
-}
-
-ClientMessage Protocol::receiveRightPressed()
-{
-    ClientMessage msg;
-    msg.cmd = MOVE_RIGHT_PRESSED_STR;
-    readClientIds(msg);
-    return msg;
-}
-
-ClientMessage Protocol::receiveRightReleased()
-{
-    ClientMessage msg;
-    msg.cmd = MOVE_RIGHT_RELEASED_STR;
+    msg.input.action = action;
     readClientIds(msg);
     return msg;
 }
@@ -85,7 +33,7 @@ ClientMessage Protocol::receiveCreateGame()
     readClientIds(msg);
     readString(msg.game_name);
     uint8_t map_id_buf = 0;
-    if (skt.recvall(&map_id_buf, 1) > 0)
+    if (recvBytes(&map_id_buf, 1) > 0)
     {
         msg.map_id = map_id_buf;
     }
@@ -108,6 +56,14 @@ ClientMessage Protocol::receiveGetGames()
     return msg;
 }
 
+ClientMessage Protocol::receiveUdpRequest()
+{
+    ClientMessage msg;
+    msg.cmd = UDP_REQUEST_STR;
+    readClientIds(msg);
+    return msg;
+}
+
 ClientMessage Protocol::receiveStartGame()
 {
     ClientMessage msg;
@@ -122,13 +78,40 @@ ServerMessage Protocol::receiveStartingCountdown() {
     return out;
 }
 
+ServerMessage Protocol::receiveHelloReply() {
+    ServerMessage out;
+    out.opcode = HELLO;
+    if (recvBytes(&out.protocol_version, sizeof(out.protocol_version)) <= 0)
+        return out;
+    // Desde acá el servidor codifica con la versión que eligió. Solo cambia el
+    // decoder: el encoder lo usa el thread sender y los mensajes del cliente no llevan posiciones.
+    version = std::min(out.protocol_version, PROTOCOL_VERSION);
+    return out;
+}
+
+ServerMessage Protocol::receiveUdpOffer() {
+    ServerMessage out;
+    out.opcode = UDP_OFFER;
+    uint16_t port;
+    uint32_t token;
+    if (recvBytes(&port, sizeof(port)) <= 0 || recvBytes(&token, sizeof(token)) <= 0)
+        return out;
+    out.udp_port = ntohs(port);
+    out.udp_token = ntohl(token);
+    return out;
+}
+
 ClientMessage Protocol::receiveChangeCar()
 {
     ClientMessage msg;
-    msg.cmd = CHANGE_CAR_STR;
     readClientIds(msg);
-    if (readString(msg.car_type) && !msg.car_type.empty()) {
-        msg.cmd = std::string(CHANGE_CAR_STR) + " " + msg.car_type;
+    if (!readString(msg.car_type))
+        return msg;
+    // Un auto desconocido no llega a la partida
+    uint8_t index = CompactCodec::packCarType(msg.car_type);
+    if (index < CAR_TYPES_COUNT) {
+        msg.input.action = InputAction::CHANGE_CAR;
+        msg.input.arg = index;
     }
     return msg;
 }
@@ -136,49 +119,99 @@ ClientMessage Protocol::receiveChangeCar()
 ClientMessage Protocol::receiveUpgradeCar()
 {
     ClientMessage msg;
-    msg.cmd = "upgrade_car";
     readClientIds(msg);
     uint8_t upgrade_byte;
-    if (skt.recvall(&upgrade_byte, sizeof(upgrade_byte)) <= 0)
+    if (recvBytes(&upgrade_byte, sizeof(upgrade_byte)) <= 0)
         return msg;
     msg.upgrade_type = static_cast<CarUpgrade>(upgrade_byte);
-    msg.cmd = std::string("upgrade_car") + " " + std::to_string(upgrade_byte);
+
+    switch (msg.upgrade_type) {
+        case CarUpgrade::ACCELERATION_BOOST:
+            msg.input.action = InputAction::UPGRADE_ACCELERATION;
+            break;
+        case CarUpgrade::SPEED_BOOST:
+            msg.input.action = InputAction::UPGRADE_SPEED;
+            break;
+        case CarUpgrade::HANDLING_IMPROVEMENT:
+            msg.input.action = InputAction::UPGRADE_HANDLING;
+            break;
+        case CarUpgrade::DURABILITY_ENHANCEMENT:
+            msg.input.action = InputAction::UPGRADE_DURABILITY;
+            break;
+    }
     return msg;
 }
 
 ClientMessage Protocol::receiveCheat()
 {
     ClientMessage msg;
-    msg.cmd = "cheat";
     readClientIds(msg);
 
     uint8_t cheat_byte;
-    if (skt.recvall(&cheat_byte, sizeof(cheat_byte)) <= 0)
+    if (recvBytes(&cheat_byte, sizeof(cheat_byte)) <= 0)
         return msg;
     msg.cheat_type = static_cast<CheatType>(cheat_byte);
 
     switch (msg.cheat_type) {
         case CheatType::GOD_MODE:
-            msg.cmd = CHEAT_GOD_MODE_STR;
+            msg.input.action = InputAction::CHEAT_GOD_MODE;
             break;
         case CheatType::DIE:
-            msg.cmd = CHEAT_DIE_STR;
+            msg.input.action = InputAction::CHEAT_DIE;
             break;
         case CheatType::SKIP_LAP:
-            msg.cmd = CHEAT_SKIP_LAP_STR;
+            msg.input.action = InputAction::CHEAT_SKIP_LAP;
             break;
         case CheatType::FULL_UPGRADE:
-            msg.cmd = CHEAT_FULL_UPGRADE_STR;
+            msg.input.action = InputAction::CHEAT_FULL_UPGRADE;
             break;
     }
     return msg;
 }
 
+ClientMessage Protocol::receiveSnapshotAck()
+{
+    ClientMessage msg;
+    msg.cmd = SNAPSHOT_ACK_STR;
+    readClientIds(msg);
+
+    readBuffer.resize(sizeof(uint32_t));
+    if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0)
+        return msg;
+    size_t idx = 0;
+    msg.snapshot_seq = exportUint32(readBuffer, idx);
+    return msg;
+}
+
+ClientMessage Protocol::receiveHello()
+{
+    ClientMessage msg;
+    msg.cmd = HELLO_STR;
+    readClientIds(msg);
+
+    uint8_t requested;
+    if (recvBytes(&requested, sizeof(requested)) <= 0)
+        return msg;
+    msg.protocol_version = requested;
+    return msg;
+}
+
 
 bool Protocol::readPosition(Position& pos) {
+    if (version >= PROTOCOL_VERSION_COMPACT) {
+        readBuffer.resize(CompactCodec::POSITION_SIZE);
+        if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0)
+            return false;
+        size_t idx = 0;
+        CompactCodec::unpackFlags(readBuffer[idx++], pos);
+        pos.new_X = CompactCodec::unpackCoord(exportUint16(readBuffer, idx));
+        pos.new_Y = CompactCodec::unpackCoord(exportUint16(readBuffer, idx));
+        pos.angle = CompactCodec::unpackAngle(exportUint16(readBuffer, idx));
+        return true;
+    }
 
     readBuffer.resize(sizeof(uint8_t) + 2 * sizeof(int8_t) + 3 * sizeof(float));
-    if (skt.recvall(readBuffer.data(), readBuffer.size()) <= 0)
+    if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0)
         return false;
 
     size_t idx = 0;
@@ -191,9 +224,69 @@ bool Protocol::readPosition(Position& pos) {
     return true;
 }
 
+bool Protocol::readHp(float& hp) {
+    size_t idx = 0;
+    if (version >= PROTOCOL_VERSION_COMPACT) {
+        readBuffer.resize(sizeof(uint16_t));
+        if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0)
+            return false;
+        hp = CompactCodec::unpackHp(exportUint16(readBuffer, idx));
+        return true;
+    }
+    readBuffer.resize(sizeof(float));
+    if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0)
+        return false;
+    hp = exportFloat(readBuffer, idx);
+    return true;
+}
+
+bool Protocol::readCarType(std::string& car_type) {
+    if (version < PROTOCOL_VERSION_COMPACT)
+        return readString(car_type);
+
+    uint8_t index;
+    if (recvBytes(&index, sizeof(index)) <= 0)
+        return false;
+    if (index == CompactCodec::CAR_TYPE_ESCAPE)
+        return readString(car_type);
+    const char *known = CompactCodec::unpackCarType(index);
+    car_type = known ? known : "";
+    return true;
+}
+
+bool Protocol::readUpgrades(PlayerPositionUpdate& update) {
+    if (version >= PROTOCOL_VERSION_COMPACT) {
+        uint8_t packed;
+        if (recvBytes(&packed, sizeof(packed)) <= 0)
+            return false;
+        update.upgrade_speed = CompactCodec::unpackUpgrade(packed, 0);
+        update.upgrade_acceleration = CompactCodec::unpackUpgrade(packed, 1);
+        update.upgrade_handling = CompactCodec::unpackUpgrade(packed, 2);
+        update.upgrade_durability = CompactCodec::unpackUpgrade(packed, 3);
+        return true;
+    }
+    uint8_t upgrade_bytes[4];
+    if (recvBytes(upgrade_bytes, sizeof(upgrade_bytes)) <= 0)
+        return false;
+    update.upgrade_speed = upgrade_bytes[0];
+    update.upgrade_acceleration = upgrade_bytes[1];
+    update.upgrade_handling = upgrade_bytes[2];
+    update.upgrade_durability = upgrade_bytes[3];
+    return true;
+}
+
+bool Protocol::readEntityFlags(PlayerPositionUpdate& update) {
+    uint8_t flags;
+    if (recvBytes(&flags, sizeof(flags)) <= 0)
+        return false;
+    update.collision_flag = (flags & DELTA_FLAG_COLLISION) != 0;
+    update.is_stopping = (flags & DELTA_FLAG_STOPPING) != 0;
+    return true;
+}
+
 bool Protocol::readString(std::string& str) {
     readBuffer.resize(sizeof(uint16_t));
-    if (skt.recvall(readBuffer.data(), readBuffer.size()) <= 0)
+    if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0)
         return false;
     
     size_t idx = 0;
@@ -201,7 +294,7 @@ bool Protocol::readString(std::string& str) {
     
     if (len > 0) {
         std::vector<uint8_t> strBuf(len);
-        if (skt.recvall(strBuf.data(), strBuf.size()) <= 0)
+        if (recvBytes(strBuf.data(), strBuf.size()) <= 0)
             return false;
         str.assign(reinterpret_cast<char*>(strBuf.data()), strBuf.size());
     }
@@ -211,7 +304,7 @@ bool Protocol::readString(std::string& str) {
 bool Protocol::readPlayerPositionUpdate(PlayerPositionUpdate& update) {
     // player_id (4 bytes)
     readBuffer.resize(sizeof(int32_t));
-    if (skt.recvall(readBuffer.data(), readBuffer.size()) <= 0)
+    if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0)
         return false;
     size_t idx = 0;
     update.player_id = exportInt(readBuffer, idx);
@@ -222,7 +315,7 @@ bool Protocol::readPlayerPositionUpdate(PlayerPositionUpdate& update) {
 
     // Checkpoints
     uint8_t next_count = 0;
-    if (skt.recvall(&next_count, sizeof(next_count)) <= 0)
+    if (recvBytes(&next_count, sizeof(next_count)) <= 0)
         return false;
 
     for (uint8_t k = 0; k < next_count; ++k) {
@@ -233,33 +326,30 @@ bool Protocol::readPlayerPositionUpdate(PlayerPositionUpdate& update) {
     }
 
     // Car type
-    if (!readString(update.car_type))
+    if (!readCarType(update.car_type))
         return false;
 
     // HP
-    readBuffer.resize(sizeof(float));
-    if (skt.recvall(readBuffer.data(), readBuffer.size()) <= 0)
+    if (!readHp(update.hp))
         return false;
-    idx = 0;
-    update.hp = exportFloat(readBuffer, idx);
+
+    if (version >= PROTOCOL_VERSION_COMPACT) {
+        // Flags y mejoras empaquetados
+        return readEntityFlags(update) && readUpgrades(update);
+    }
 
     // Collision flag
     uint8_t collision_byte;
-    if (skt.recvall(&collision_byte, sizeof(collision_byte)) <= 0)
+    if (recvBytes(&collision_byte, sizeof(collision_byte)) <= 0)
         return false;
     update.collision_flag = (collision_byte != 0);
 
     // Upgrades
-    uint8_t upgrade_bytes[4];
-    if (skt.recvall(upgrade_bytes, sizeof(upgrade_bytes)) <= 0)
+    if (!readUpgrades(update))
         return false;
-    update.upgrade_speed = upgrade_bytes[0];
-    update.upgrade_acceleration = upgrade_bytes[1];
-    update.upgrade_handling = upgrade_bytes[2];
-    update.upgrade_durability = upgrade_bytes[3];
 
     uint8_t stopping_byte;
-    if (skt.recvall(&stopping_byte, sizeof(stopping_byte)) <= 0)
+    if (recvBytes(&stopping_byte, sizeof(stopping_byte)) <= 0)
         return false;
     update.is_stopping = (stopping_byte != 0);
 
@@ -273,7 +363,7 @@ ServerMessage Protocol::receivePositionsUpdate()
     msg.opcode = UPDATE_POSITIONS;
 
     uint8_t count;
-    if (skt.recvall(&count, sizeof(count)) <= 0)
+    if (recvBytes(&count, sizeof(count)) <= 0)
         return msg;
 
     for (int i = 0; i < count; i++) {
@@ -286,12 +376,141 @@ ServerMessage Protocol::receivePositionsUpdate()
     return msg;
 }
 
+bool Protocol::readEntityDelta(PlayerPositionUpdate& update, uint8_t& mask) {
+    readBuffer.resize(sizeof(int32_t) + sizeof(uint8_t));
+    if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0)
+        return false;
+    size_t idx = 0;
+    update.player_id = exportInt(readBuffer, idx);
+    mask = readBuffer[idx];
+
+    if ((mask & DELTA_POSITION) && !readPosition(update.new_pos))
+        return false;
+
+    if (mask & DELTA_CHECKPOINTS) {
+        uint8_t next_count = 0;
+        if (recvBytes(&next_count, sizeof(next_count)) <= 0)
+            return false;
+        for (uint8_t k = 0; k < next_count; ++k) {
+            Position cp{};
+            if (!readPosition(cp))
+                return false;
+            update.next_checkpoints.push_back(cp);
+        }
+    }
+
+    if ((mask & DELTA_CAR_TYPE) && !readCarType(update.car_type))
+        return false;
+
+    if ((mask & DELTA_HP) && !readHp(update.hp))
+        return false;
+
+    if ((mask & DELTA_UPGRADES) && !readUpgrades(update))
+        return false;
+
+    if ((mask & DELTA_FLAGS) && !readEntityFlags(update))
+        return false;
+    return true;
+}
+
+void Protocol::applyEntityDelta(PlayerPositionUpdate& target, const PlayerPositionUpdate& update, uint8_t mask) {
+    if (mask & DELTA_POSITION)
+        target.new_pos = update.new_pos;
+    if (mask & DELTA_CHECKPOINTS)
+        target.next_checkpoints = update.next_checkpoints;
+    if (mask & DELTA_CAR_TYPE)
+        target.car_type = update.car_type;
+    if (mask & DELTA_HP)
+        target.hp = update.hp;
+    if (mask & DELTA_UPGRADES) {
+        target.upgrade_speed = update.upgrade_speed;
+        target.upgrade_acceleration = update.upgrade_acceleration;
+        target.upgrade_handling = update.upgrade_handling;
+        target.upgrade_durability = update.upgrade_durability;
+    }
+    if (mask & DELTA_FLAGS) {
+        target.collision_flag = update.collision_flag;
+        target.is_stopping = update.is_stopping;
+    }
+}
+
+ServerMessage Protocol::receivePositionsDelta()
+{
+    ServerMessage msg;
+    msg.opcode = UPDATE_POSITIONS;
+
+    readBuffer.resize(sizeof(uint32_t) * 2 + sizeof(uint8_t));
+    if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0)
+        return msg;
+    size_t idx = 0;
+    uint32_t seq = exportUint32(readBuffer, idx);
+    uint32_t baseline_seq = exportUint32(readBuffer, idx);
+    uint8_t removed_count = readBuffer[idx];
+
+    std::unordered_set<int> removed;
+    for (uint8_t i = 0; i < removed_count; ++i) {
+        readBuffer.resize(sizeof(int32_t));
+        if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0)
+            return msg;
+        idx = 0;
+        removed.insert(exportInt(readBuffer, idx));
+    }
+
+    uint8_t count;
+    if (recvBytes(&count, sizeof(count)) <= 0)
+        return msg;
+    std::vector<std::pair<uint8_t, PlayerPositionUpdate>> changes(count);
+    for (auto &change : changes) {
+        if (!readEntityDelta(change.second, change.first))
+            return msg;
+    }
+
+    // El frame se consume entero aunque falte el baseline, para no desincronizar el stream
+    const std::vector<PlayerPositionUpdate>* baseline = nullptr;
+    if (baseline_seq != 0) {
+        for (const auto &snapshot : snapshot_history) {
+            if (snapshot.first == baseline_seq)
+                baseline = &snapshot.second;
+        }
+        if (!baseline) {
+            std::cerr << "[Protocol] receivePositionsDelta: baseline " << baseline_seq
+                      << " desconocido, se descarta el snapshot " << seq << std::endl;
+            return msg;
+        }
+    }
+
+    std::unordered_map<int, size_t> index_by_id;
+    if (baseline) {
+        for (const auto &prev : *baseline) {
+            if (removed.count(prev.player_id))
+                continue;
+            index_by_id[prev.player_id] = msg.positions.size();
+            msg.positions.push_back(prev);
+        }
+    }
+    for (auto &change : changes) {
+        auto it = index_by_id.find(change.second.player_id);
+        if (it != index_by_id.end()) {
+            applyEntityDelta(msg.positions[it->second], change.second, change.first);
+        } else {
+            index_by_id[change.second.player_id] = msg.positions.size();
+            msg.positions.push_back(std::move(change.second));
+        }
+    }
+
+    msg.snapshot_seq = seq;
+    snapshot_history.emplace_back(seq, msg.positions);
+    if (snapshot_history.size() > SNAPSHOT_HISTORY)
+        snapshot_history.pop_front();
+    return msg;
+}
+
 GameJoinedResponse Protocol::receiveGameJoinedResponse()
 {
     GameJoinedResponse resp;
 
     readBuffer.resize(sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint8_t));
-    if (skt.recvall(readBuffer.data(), readBuffer.size()) <= 0)
+    if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0)
     {
         resp.success = false;
         resp.game_id = 0;
@@ -318,14 +537,14 @@ ServerMessage Protocol::receiveGamesList()
     msg.opcode = GAMES_LIST;
 
     readBuffer.resize(sizeof(uint32_t));
-    if (skt.recvall(readBuffer.data(), readBuffer.size()) <= 0)
+    if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0)
         return msg;
     size_t idx = 0;
     uint32_t count = exportUint32(readBuffer, idx);
     for (uint32_t i = 0; i < count; ++i)
     {
         readBuffer.resize(sizeof(uint32_t) * 2 + sizeof(uint8_t) + sizeof(uint16_t));
-        if (skt.recvall(readBuffer.data(), readBuffer.size()) <= 0)
+        if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0)
             return msg;
         size_t j = 0;
         ServerMessage::GameSummary summary{};
@@ -336,7 +555,7 @@ ServerMessage Protocol::receiveGamesList()
         if (nameLen > 0)
         {
             std::vector<uint8_t> nb(nameLen);
-            if (skt.recvall(nb.data(), nb.size()) <= 0)
+            if (recvBytes(nb.data(), nb.size()) <= 0)
                 return msg;
             summary.name.assign(reinterpret_cast<char *>(nb.data()), nb.size());
         }
@@ -350,20 +569,20 @@ ServerMessage Protocol::receiveRaceTimes()
     ServerMessage out;
     out.opcode = RACE_TIMES;
     readBuffer.resize(sizeof(uint32_t));
-    if (skt.recvall(readBuffer.data(), readBuffer.size()) <= 0) return out;
+    if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0) return out;
     size_t idx = 0;
     uint32_t count = exportUint32(readBuffer, idx);
     out.race_times.reserve(count);
     for (uint32_t i = 0; i < count; ++i) {
         readBuffer.resize(sizeof(uint32_t) * 2);
-        if (skt.recvall(readBuffer.data(), readBuffer.size()) <= 0) return out;
+        if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0) return out;
         size_t j = 0;
         uint32_t pid = exportUint32(readBuffer, j);
         uint32_t tms = exportUint32(readBuffer, j);
         uint8_t dq = 0;
-        if (skt.recvall(&dq, sizeof(dq)) <= 0) return out;
+        if (recvBytes(&dq, sizeof(dq)) <= 0) return out;
         uint8_t round = 0;
-        if (skt.recvall(&round, sizeof(round)) <= 0) return out;
+        if (recvBytes(&round, sizeof(round)) <= 0) return out;
         out.race_times.push_back({pid, tms, dq != 0, round});
     }
     return out;
@@ -374,13 +593,13 @@ ServerMessage Protocol::receiveTotalTimes()
     ServerMessage out;
     out.opcode = TOTAL_TIMES;
     readBuffer.resize(sizeof(uint32_t));
-    if (skt.recvall(readBuffer.data(), readBuffer.size()) <= 0) return out;
+    if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0) return out;
     size_t idx = 0;
     uint32_t count = exportUint32(readBuffer, idx);
     out.total_times.reserve(count);
     for (uint32_t i = 0; i < count; ++i) {
         readBuffer.resize(sizeof(uint32_t) * 2);
-        if (skt.recvall(readBuffer.data(), readBuffer.size()) <= 0) return out;
+        if (recvBytes(readBuffer.data(), readBuffer.size()) <= 0) return out;
         size_t j = 0;
         uint32_t pid = exportUint32(readBuffer, j);
         uint32_t total = exportUint32(readBuffer, j);
@@ -0,0 +1,263 @@
+#include "reactor.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "liberror.h"
+
+#define MAX_EVENTS 64
+
+Reactor::Reactor():
+        epoll_fd(-1),
+        wake_fd(-1),
+        mtx(),
+        removed(),
+        pending_adds(),
+        pending_removes(),
+        pending_writes(),
+        wake_pending(false),
+        running(false),
+        loop_thread(),
+        handlers(),
+        waiting_output() {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd == -1)
+        throw LibError(errno, "epoll_create1 failed");
+
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd == -1) {
+        int saved_errno = errno;
+        ::close(epoll_fd);
+        throw LibError(saved_errno, "eventfd failed");
+    }
+
+    struct epoll_event ev {};
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr;  // nullptr identifica al eventfd
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev) == -1) {
+        int saved_errno = errno;
+        ::close(wake_fd);
+        ::close(epoll_fd);
+        throw LibError(saved_errno, "epoll_ctl(wake_fd) failed");
+    }
+}
+
+Reactor::~Reactor() {
+    ::close(wake_fd);
+    ::close(epoll_fd);
+}
+
+void Reactor::start() {
+    {
+        // Desde acá `remove` tiene que pasar por el loop
+        std::lock_guard<std::mutex> lk(mtx);
+        running = true;
+    }
+    Thread::start();
+}
+
+void Reactor::run() {
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        loop_thread = std::this_thread::get_id();
+    }
+
+    struct epoll_event events[MAX_EVENTS];
+    while (should_keep_running()) {
+        apply_pending();
+
+        int n = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+        if (n == -1) {
+            if (errno == EINTR)
+                continue;
+            std::cerr << "[Reactor] epoll_wait failed: " << errno << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            auto* handler = static_cast<ReactorHandler*>(events[i].data.ptr);
+            if (!handler) {
+                drain_wake_fd();
+                continue;
+            }
+            // Puede haberse cerrado por un evento anterior del mismo lote
+            if (!handlers.count(handler))
+                continue;
+
+            uint32_t ev = events[i].events;
+            bool keep = true;
+            try {
+                if (ev & (EPOLLIN | EPOLLHUP | EPOLLERR | EPOLLRDHUP))
+                    keep = handler->on_readable();
+                if (keep && (ev & EPOLLOUT))
+                    keep = handler->on_writable();
+            } catch (const std::exception& e) {
+                std::cerr << "[Reactor] Connection error: " << e.what() << std::endl;
+                keep = false;
+            }
+
+            if (!keep)
+                close_handler(handler);
+            else
+                update_interest(handler);
+        }
+    }
+
+    std::lock_guard<std::mutex> lk(mtx);
+    running = false;
+    removed.notify_all();
+}
+
+void Reactor::stop() {
+    Thread::stop();
+    // Siempre se escribe: el loop pudo haber chequeado el flag antes de resetear wake_pending
+    write_wake_fd();
+}
+
+void Reactor::add(ReactorHandler* handler) {
+    std::lock_guard<std::mutex> lk(mtx);
+    pending_adds.push_back(handler);
+    wake_locked();
+}
+
+void Reactor::remove(ReactorHandler* handler) {
+    std::unique_lock<std::mutex> lk(mtx);
+    // Un add que el loop todavía no aplicó no tiene que registrarlo después
+    pending_adds.erase(std::remove(pending_adds.begin(), pending_adds.end(), handler), pending_adds.end());
+    pending_writes.erase(std::remove(pending_writes.begin(), pending_writes.end(), handler), pending_writes.end());
+    if (!running || std::this_thread::get_id() == loop_thread) {
+        // El loop no corre (o somos el loop): se puede tocar el estado directo
+        lk.unlock();
+        detach(handler);
+        return;
+    }
+
+    pending_removes.insert(handler);
+    wake_locked();
+    removed.wait(lk, [&]() { return !running || !pending_removes.count(handler); });
+}
+
+void Reactor::request_write(ReactorHandler* handler) {
+    std::lock_guard<std::mutex> lk(mtx);
+    pending_writes.push_back(handler);
+    wake_locked();
+}
+
+void Reactor::wake_locked() {
+    // Un solo write por tanda: el loop resetea wake_pending al tomar los pendientes
+    if (wake_pending)
+        return;
+    wake_pending = true;
+    write_wake_fd();
+}
+
+void Reactor::write_wake_fd() {
+    uint64_t one = 1;
+    // eventfd no bloqueante: si está saturado ya hay un wake pendiente
+    if (::write(wake_fd, &one, sizeof(one)) < 0) {
+        return;
+    }
+}
+
+void Reactor::drain_wake_fd() {
+    uint64_t value;
+    while (::read(wake_fd, &value, sizeof(value)) > 0) {
+    }
+}
+
+void Reactor::apply_pending() {
+    std::vector<ReactorHandler*> adds;
+    std::vector<ReactorHandler*> removes;
+    std::vector<ReactorHandler*> writes;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        adds.swap(pending_adds);
+        removes.assign(pending_removes.begin(), pending_removes.end());
+        writes.swap(pending_writes);
+        wake_pending = false;
+    }
+
+    for (auto* handler: removes) {
+        detach(handler);
+    }
+    if (!removes.empty()) {
+        std::lock_guard<std::mutex> lk(mtx);
+        for (auto* handler: removes) {
+            pending_removes.erase(handler);
+        }
+        removed.notify_all();
+    }
+
+    for (auto* handler: adds) {
+        struct epoll_event ev {};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.ptr = handler;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, handler->get_fd(), &ev) == -1) {
+            std::cerr << "[Reactor] epoll_ctl(ADD) failed: " << errno << std::endl;
+            handler->on_closed();
+            continue;
+        }
+        handlers.insert(handler);
+        // Puede haber mensajes encolados antes de registrarse
+        handle_write(handler);
+    }
+
+    for (auto* handler: writes) {
+        handle_write(handler);
+    }
+}
+
+void Reactor::handle_write(ReactorHandler* handler) {
+    if (!handlers.count(handler))
+        return;
+
+    bool keep = true;
+    try {
+        keep = handler->on_writable();
+    } catch (const std::exception& e) {
+        std::cerr << "[Reactor] Connection error: " << e.what() << std::endl;
+        keep = false;
+    }
+
+    if (!keep)
+        close_handler(handler);
+    else
+        update_interest(handler);
+}
+
+void Reactor::update_interest(ReactorHandler* handler) {
+    bool wants_output = handler->has_pending_output();
+    bool has_output = waiting_output.count(handler) > 0;
+    if (wants_output == has_output)
+        return;
+
+    struct epoll_event ev {};
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    if (wants_output)
+        ev.events |= EPOLLOUT;
+    ev.data.ptr = handler;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, handler->get_fd(), &ev) == -1) {
+        std::cerr << "[Reactor] epoll_ctl(MOD) failed: " << errno << std::endl;
+        return;
+    }
+    if (wants_output)
+        waiting_output.insert(handler);
+    else
+        waiting_output.erase(handler);
+}
+
+void Reactor::detach(ReactorHandler* handler) {
+    if (!handlers.erase(handler))
+        return;
+    waiting_output.erase(handler);
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, handler->get_fd(), nullptr);
+}
+
+void Reactor::close_handler(ReactorHandler* handler) {
+    detach(handler);
+    handler->on_closed();
+}
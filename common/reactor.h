@@ -0,0 +1,86 @@
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "thread.h"
+
+/*
+ * Conexión registrada en un `Reactor`.
+ *
+ * Todos los callbacks se llaman desde el thread del reactor, nunca en
+ * paralelo para un mismo handler.
+ * */
+class ReactorHandler {
+public:
+    virtual int get_fd() const = 0;
+
+    // Hay datos para leer. Retorna false si hay que cerrar la conexión.
+    virtual bool on_readable() = 0;
+    // Se puede escribir (o alguien pidió `Reactor::request_write`).
+    // Retorna false si hay que cerrar la conexión.
+    virtual bool on_writable() = 0;
+    // true si quedaron bytes sin enviar: el reactor espera EPOLLOUT
+    virtual bool has_pending_output() const = 0;
+    // La conexión se cerró y el reactor ya no va a usar el handler
+    virtual void on_closed() = 0;
+
+    virtual ~ReactorHandler() = default;
+};
+
+/*
+ * Event loop basado en `epoll`: un solo thread atiende muchas conexiones
+ * no bloqueantes. Otros threads se comunican con él mediante `add`,
+ * `remove` y `request_write`, que lo despiertan con un `eventfd`.
+ * */
+class Reactor: public Thread {
+private:
+    int epoll_fd;
+    int wake_fd;
+
+    std::mutex mtx;
+    std::condition_variable removed;
+    std::vector<ReactorHandler*> pending_adds;
+    std::unordered_set<ReactorHandler*> pending_removes;
+    std::vector<ReactorHandler*> pending_writes;
+    bool wake_pending;
+    bool running;
+    std::thread::id loop_thread;
+
+    // Solo se accede desde el thread del reactor
+    std::unordered_set<ReactorHandler*> handlers;
+    std::unordered_set<ReactorHandler*> waiting_output;
+
+    void wake_locked();
+    void write_wake_fd();
+    void drain_wake_fd();
+    void apply_pending();
+    void detach(ReactorHandler* handler);
+    void close_handler(ReactorHandler* handler);
+    void handle_write(ReactorHandler* handler);
+    void update_interest(ReactorHandler* handler);
+
+public:
+    Reactor();
+    ~Reactor() override;
+
+    void start() override;
+    void run() override;
+    void stop() override;
+
+    // Thread-safe. El handler tiene que vivir hasta que se llame a `remove`.
+    void add(ReactorHandler* handler);
+    // Thread-safe. Al retornar el reactor ya no usa el handler.
+    void remove(ReactorHandler* handler);
+    // Thread-safe. Pide que se llame a `on_writable` del handler.
+    void request_write(ReactorHandler* handler);
+
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+};
+
+#endif
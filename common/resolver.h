@@ -38,9 +38,11 @@ public:
      * las direcciones retornadas serán aptas para hacer un `bind`
      * y poner al socket en modo escucha para recibir conexiones.
      *
+     * `socktype` elige direcciones para TCP (`SOCK_STREAM`) o UDP (`SOCK_DGRAM`).
+     *
      * En caso de error se lanza una excepción.
      * */
-    Resolver(const char* hostname, const char* servname, bool is_passive);
+    Resolver(const char* hostname, const char* servname, bool is_passive, int socktype = SOCK_STREAM);
 
     /*
      * Deshabilitamos el constructor por copia y operador asignación por copia
@@ -0,0 +1,277 @@
+#ifndef RING_QUEUE_H_
+#define RING_QUEUE_H_
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "queue.h"
+
+// Cantidad de productores que acepta la RingQueue. Con uno solo (SPSC) la
+// reserva del lugar es un store simple en vez de un CAS.
+enum class RingProducers
+{
+    SINGLE,
+    MULTI
+};
+
+/*
+ * Lock-free bounded ring buffer, single consumer (SPSC / MPSC)
+ *
+ * Alternativa a Queue para los caminos calientes (eventos del juego, outbox).
+ * Cada celda lleva un número de secuencia que indica si está libre o
+ * publicada, así productores y consumidor no comparten ningún lock.
+ *
+ * - La capacidad se redondea a la potencia de 2 siguiente.
+ * - push/pop son move-only: el valor se mueve solo si la operación tuvo éxito.
+ * - try_push/try_pop no bloquean; push/pop esperan con atomic wait/notify, que
+ *   solo se paga cuando hay alguien esperando.
+ * - Mismas reglas de cierre que Queue: push sobre una cola cerrada lanza
+ *   ClosedQueue, y pop lanza ClosedQueue cuando está cerrada y vacía.
+ *
+ * Un único thread puede consumir (try_pop/pop/try_pop_all).
+ * */
+template <typename T, RingProducers P = RingProducers::MULTI>
+class RingQueue
+{
+private:
+    // Tamaño de línea de cache: tail (productores) y head (consumidor) no
+    // comparten línea para no invalidarse mutuamente
+    static constexpr size_t CACHE_LINE = 64;
+
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    const size_t mask;
+    std::unique_ptr<Cell[]> cells;
+
+    alignas(CACHE_LINE) std::atomic<size_t> tail;
+    alignas(CACHE_LINE) size_t head;
+
+    alignas(CACHE_LINE) std::atomic<bool> closed;
+    // Contadores para atomic wait: avanzan solo cuando alguien se anotó para
+    // esperar, y solo el primero que baja la marca hace la syscall de notify
+    std::atomic<uint32_t> pushed_epoch;
+    std::atomic<uint32_t> popped_epoch;
+    std::atomic<bool> consumer_waiting;
+    std::atomic<bool> producers_waiting;
+
+    static size_t round_capacity(size_t capacity)
+    {
+        return std::bit_ceil(capacity < 2 ? size_t(2) : capacity);
+    }
+
+    bool try_pop_one(T &val)
+    {
+        Cell &cell = cells[head & mask];
+        if (cell.seq.load(std::memory_order_acquire) != head + 1)
+        {
+            return false;
+        }
+        val = std::move(cell.value);
+        cell.seq.store(head + mask + 1, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+    bool has_room() const
+    {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        return cells[pos & mask].seq.load(std::memory_order_acquire) == pos;
+    }
+
+    void wake_consumer()
+    {
+        // Pareado con el fence de pop(): o el consumidor ve el dato o nosotros
+        // vemos que está esperando
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumer_waiting.load(std::memory_order_relaxed) &&
+            consumer_waiting.exchange(false, std::memory_order_relaxed))
+        {
+            pushed_epoch.fetch_add(1, std::memory_order_release);
+            pushed_epoch.notify_one();
+        }
+    }
+
+    void wake_producers()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (producers_waiting.load(std::memory_order_relaxed) &&
+            producers_waiting.exchange(false, std::memory_order_relaxed))
+        {
+            popped_epoch.fetch_add(1, std::memory_order_release);
+            popped_epoch.notify_all();
+        }
+    }
+
+public:
+    explicit RingQueue(size_t capacity)
+        : mask(round_capacity(capacity) - 1),
+          cells(std::make_unique<Cell[]>(mask + 1)),
+          tail(0),
+          head(0),
+          closed(false),
+          pushed_epoch(0),
+          popped_epoch(0),
+          consumer_waiting(false),
+          producers_waiting(false)
+    {
+        for (size_t i = 0; i <= mask; ++i)
+        {
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    size_t capacity() const
+    {
+        return mask + 1;
+    }
+
+    bool try_push(T &&val)
+    {
+        if (closed.load(std::memory_order_acquire))
+        {
+            throw ClosedQueue();
+        }
+
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Cell *cell;
+        while (true)
+        {
+            cell = &cells[pos & mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0)
+            {
+                if constexpr (P == RingProducers::SINGLE)
+                {
+                    tail.store(pos + 1, std::memory_order_relaxed);
+                    break;
+                }
+                else if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // La celda todavía tiene un valor de la vuelta anterior: llena
+                return false;
+            }
+            else
+            {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(val);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        wake_consumer();
+        return true;
+    }
+
+    bool try_pop(T &val)
+    {
+        if (try_pop_one(val))
+        {
+            wake_producers();
+            return true;
+        }
+        if (closed.load(std::memory_order_acquire))
+        {
+            // Lo publicado antes del cierre se entrega igual
+            if (try_pop_one(val))
+            {
+                return true;
+            }
+            throw ClosedQueue();
+        }
+        return false;
+    }
+
+    // Saca hasta max elementos de una vez y los agrega al final de out.
+    // Despierta a los productores una sola vez por lote.
+    size_t try_pop_all(std::vector<T> &out, size_t max = std::numeric_limits<size_t>::max())
+    {
+        size_t count = 0;
+        T val;
+        while (count < max && try_pop_one(val))
+        {
+            out.push_back(std::move(val));
+            ++count;
+        }
+        if (count > 0)
+        {
+            wake_producers();
+            return count;
+        }
+        if (closed.load(std::memory_order_acquire))
+        {
+            if (try_pop_one(val))
+            {
+                out.push_back(std::move(val));
+                return 1;
+            }
+            throw ClosedQueue();
+        }
+        return 0;
+    }
+
+    void push(T &&val)
+    {
+        while (!try_push(std::move(val)))
+        {
+            uint32_t epoch = popped_epoch.load(std::memory_order_acquire);
+            producers_waiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            // Si se liberó lugar (o se cerró) entre el intento y el registro, no esperamos
+            if (!has_room() && !closed.load(std::memory_order_acquire))
+            {
+                popped_epoch.wait(epoch, std::memory_order_acquire);
+            }
+        }
+    }
+
+    T pop()
+    {
+        T val;
+        while (!try_pop(val))
+        {
+            uint32_t epoch = pushed_epoch.load(std::memory_order_acquire);
+            consumer_waiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            Cell &cell = cells[head & mask];
+            if (cell.seq.load(std::memory_order_acquire) != head + 1 &&
+                !closed.load(std::memory_order_acquire))
+            {
+                pushed_epoch.wait(epoch, std::memory_order_acquire);
+            }
+            consumer_waiting.store(false, std::memory_order_relaxed);
+        }
+        return val;
+    }
+
+    void close()
+    {
+        if (closed.exchange(true, std::memory_order_acq_rel))
+        {
+            throw std::runtime_error("The queue is already closed.");
+        }
+        pushed_epoch.fetch_add(1, std::memory_order_release);
+        pushed_epoch.notify_all();
+        popped_epoch.fetch_add(1, std::memory_order_release);
+        popped_epoch.notify_all();
+    }
+
+    RingQueue(const RingQueue &) = delete;
+    RingQueue &operator=(const RingQueue &) = delete;
+};
+
+#endif
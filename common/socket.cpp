@@ -5,11 +5,15 @@
 #include <arpa/inet.h>
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include "liberror.h"
@@ -259,6 +263,12 @@ int Socket::recvsome(void* data, unsigned int sz) {
         stream_status |= STREAM_RECV_CLOSED;
         return 0;
     } else if (s == -1) {
+        /*
+         * En modo no bloqueante no hay datos todavía: no es un error.
+         * */
+        if (errno == EAGAIN)  // en Linux EWOULDBLOCK == EAGAIN
+            return -1;
+
         /*
          * 99% casi seguro que es un error real
          * */
@@ -304,6 +314,12 @@ int Socket::sendsome(const void* data, unsigned int sz) {
             return 0;
         }
 
+        /*
+         * En modo no bloqueante el buffer de envío está lleno: no es un error.
+         * */
+        if (errno == EAGAIN)  // en Linux EWOULDBLOCK == EAGAIN
+            return -1;
+
         /* En cualquier otro caso supondremos un error
          * y lanzamos una excepción.
          * */
@@ -375,6 +391,112 @@ int Socket::sendall(const void* data, unsigned int sz) {
     return sz;
 }
 
+int Socket::sendsomev(const struct iovec* iov, int iovcnt) {
+    chk_skt_or_fail();
+    /*
+     * `writev` no acepta flags: con `sendmsg` se puede pasar `MSG_NOSIGNAL`
+     * igual que en `Socket::sendsome`.
+     * */
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = const_cast<struct iovec*>(iov);
+    msg.msg_iovlen = iovcnt;
+
+    ssize_t s = sendmsg(this->skt, &msg, MSG_NOSIGNAL);
+    if (s == -1) {
+        /* Véase los comentarios de `Socket::sendsome` */
+        if (errno == EPIPE) {
+            stream_status |= STREAM_SEND_CLOSED;
+            return 0;
+        }
+        if (errno == EAGAIN)
+            return -1;
+        throw LibError(errno, "socket sendmsg failed");
+    } else if (s == 0 && iovcnt > 0) {
+        stream_status |= STREAM_SEND_CLOSED;
+        return 0;
+    }
+    return static_cast<int>(s);
+}
+
+int Socket::sendallv(struct iovec* iov, int iovcnt) {
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; ++i)
+        total += iov[i].iov_len;
+
+    size_t sent = 0;
+    while (sent < total) {
+        /* Saltear los buffers ya enviados por completo */
+        while (iovcnt > 0 && iov->iov_len == 0) {
+            ++iov;
+            --iovcnt;
+        }
+
+        int s = sendsomev(iov, iovcnt);
+
+        /* Véase los comentarios de `Socket::recvall` */
+        if (s <= 0) {
+            assert(s == 0);
+            if (sent)
+                throw LibError(EPIPE, "socket sent only %zu of %zu bytes", sent, total);
+            else
+                return 0;
+        }
+
+        sent += s;
+        /* Avanzar sobre lo que el kernel aceptó: puede cortar en medio de un buffer */
+        size_t left = s;
+        while (left > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            iov->iov_len = 0;
+            ++iov;
+            --iovcnt;
+        }
+        if (left > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
+    }
+
+    return static_cast<int>(total);
+}
+
+void Socket::set_nodelay(bool enabled) {
+    chk_skt_or_fail();
+    int optval = enabled ? 1 : 0;
+    if (setsockopt(this->skt, IPPROTO_TCP, TCP_NODELAY, &optval, sizeof(optval)) == -1)
+        throw LibError(errno, "socket setsockopt(TCP_NODELAY) failed");
+}
+
+void Socket::set_cork(bool enabled) {
+    chk_skt_or_fail();
+    int optval = enabled ? 1 : 0;
+    if (setsockopt(this->skt, IPPROTO_TCP, TCP_CORK, &optval, sizeof(optval)) == -1)
+        throw LibError(errno, "socket setsockopt(TCP_CORK) failed");
+}
+
+void Socket::set_send_buffer(int bytes) {
+    chk_skt_or_fail();
+    if (setsockopt(this->skt, SOL_SOCKET, SO_SNDBUF, &bytes, sizeof(bytes)) == -1)
+        throw LibError(errno, "socket setsockopt(SO_SNDBUF) failed");
+}
+
+void Socket::set_nonblocking(bool enabled) {
+    chk_skt_or_fail();
+    int flags = fcntl(this->skt, F_GETFL, 0);
+    if (flags == -1)
+        throw LibError(errno, "socket fcntl(F_GETFL) failed");
+
+    flags = enabled ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    if (fcntl(this->skt, F_SETFL, flags) == -1)
+        throw LibError(errno, "socket fcntl(F_SETFL) failed");
+}
+
+int Socket::get_fd() const {
+    chk_skt_or_fail();
+    return this->skt;
+}
+
 Socket::Socket(int skt) {
     this->skt = skt;
     this->closed = false;
@@ -1,6 +1,8 @@
 #ifndef SOCKET_H
 #define SOCKET_H
 
+struct iovec;
+
 /*
  * TDA Socket.
  * Por simplificación este TDA se enfocará solamente
@@ -113,6 +115,9 @@ public:
      * Retorna 0 si se cerro el socket,
      * o positivo que indicara cuantos bytes realmente se enviaron/recibieron.
      *
+     * Si el socket esta en modo no bloqueante (ver `Socket::set_nonblocking`)
+     * y la operación tendría que bloquearse (`EAGAIN`), se retorna -1.
+     *
      * Si hay un error se lanza una excepción.
      *
      * Lease manpage de `send` y `recv`
@@ -143,6 +148,53 @@ public:
     int sendall(const void* data, unsigned int sz);
     int recvall(void* data, unsigned int sz);
 
+    /*
+     * Versiones "scatter-gather" de `sendsome` y `sendall`: envían en una sola
+     * llamada al sistema los `iovcnt` buffers de `iov`, uno detrás del otro,
+     * como si estuviesen contiguos (lease manpage de `writev`).
+     *
+     * `Socket::sendsomev` retorna lo mismo que `sendsome`.
+     *
+     * `Socket::sendallv` envía todos los buffers y se comporta como `sendall`.
+     * Si el kernel acepta solo una parte, ajusta `iov` para seguir desde ahí,
+     * así que el arreglo queda modificado.
+     * */
+    int sendsomev(const struct iovec* iov, int iovcnt);
+    int sendallv(struct iovec* iov, int iovcnt);
+
+    /*
+     * Opciones de TCP del socket:
+     *
+     *  - `set_nodelay` desactiva el algoritmo de Nagle (`TCP_NODELAY`): un
+     *    mensaje chico sale enseguida en vez de esperar el ACK del anterior.
+     *  - `set_cork` (`TCP_CORK`): mientras está activo el kernel junta lo
+     *    enviado en segmentos llenos; al desactivarlo envía lo que quede.
+     *  - `set_send_buffer` fija el tamaño del buffer de envío del kernel
+     *    (`SO_SNDBUF`).
+     *
+     * En caso de error, se lanza una excepción.
+     * */
+    void set_nodelay(bool enabled);
+    void set_cork(bool enabled);
+    void set_send_buffer(int bytes);
+
+    /*
+     * Pone el socket en modo no bloqueante (o lo vuelve a bloqueante).
+     *
+     * En modo no bloqueante `Socket::sendall` y `Socket::recvall` no tienen
+     * sentido: hay que usar `sendsome`/`recvsome` y esperar a que el socket
+     * este listo con algún mecanismo de multiplexación (`epoll`, véase `Reactor`).
+     *
+     * En caso de error, se lanza una excepción.
+     * */
+    void set_nonblocking(bool enabled);
+
+    /*
+     * Retorna el file descriptor para registrarlo en un `epoll`.
+     * El ownership sigue siendo del `Socket`: no hay que cerrarlo.
+     * */
+    int get_fd() const;
+
     /*
      * Acepta una conexión entrante y retorna un nuevo socket
      * construido a partir de ella.
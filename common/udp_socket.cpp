@@ -0,0 +1,169 @@
+#include "udp_socket.h"
+
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "liberror.h"
+#include "resolver.h"
+#include "socket.h"
+
+bool UdpEndpoint::operator==(const UdpEndpoint& other) const {
+    return addr.sin_addr.s_addr == other.addr.sin_addr.s_addr && addr.sin_port == other.addr.sin_port;
+}
+
+UdpSocket::UdpSocket(const char* servname): skt(-1) {
+    Resolver resolver(nullptr, servname, true, SOCK_DGRAM);
+
+    while (resolver.has_next()) {
+        struct addrinfo* addr = resolver.next();
+
+        skt = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+        if (skt == -1)
+            continue;
+
+        if (bind(skt, addr->ai_addr, addr->ai_addrlen) == 0)
+            return;
+
+        ::close(skt);
+        skt = -1;
+    }
+
+    throw LibError(errno, "udp socket construction failed (bind to %s)", (servname ? servname : ""));
+}
+
+UdpSocket::UdpSocket(const Socket& tcp_peer, uint16_t port): skt(-1) {
+    /*
+     * El servidor UDP está en la misma máquina que el TCP al que ya
+     * estamos conectados: se toma su IP en vez de volver a resolver.
+     * */
+    struct sockaddr_in peer;
+    socklen_t len = sizeof(peer);
+    if (getpeername(tcp_peer.get_fd(), (struct sockaddr*)&peer, &len) == -1)
+        throw LibError(errno, "udp socket getpeername failed");
+    peer.sin_port = htons(port);
+
+    skt = socket(AF_INET, SOCK_DGRAM, 0);
+    if (skt == -1)
+        throw LibError(errno, "udp socket construction failed");
+
+    if (connect(skt, (struct sockaddr*)&peer, sizeof(peer)) == -1) {
+        int saved_errno = errno;
+        ::close(skt);
+        skt = -1;
+        throw LibError(saved_errno, "udp socket connect failed");
+    }
+}
+
+int UdpSocket::send_to(const void* data, size_t sz, const UdpEndpoint& to) {
+    chk_skt_or_fail();
+    ssize_t s = sendto(skt, data, sz, MSG_NOSIGNAL, (const struct sockaddr*)&to.addr, sizeof(to.addr));
+    if (s == -1) {
+        /*
+         * Buffer lleno en modo no bloqueante: el datagrama se pierde,
+         * como se perdería en la red.
+         * */
+        if (errno == EAGAIN || errno == ENOBUFS)
+            return -1;
+        throw LibError(errno, "udp socket sendto failed");
+    }
+    return static_cast<int>(s);
+}
+
+int UdpSocket::send_to(const struct iovec* iov, int iovcnt, const UdpEndpoint& to) {
+    chk_skt_or_fail();
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = const_cast<struct sockaddr_in*>(&to.addr);
+    msg.msg_namelen = sizeof(to.addr);
+    msg.msg_iov = const_cast<struct iovec*>(iov);
+    msg.msg_iovlen = iovcnt;
+
+    ssize_t s = sendmsg(skt, &msg, MSG_NOSIGNAL);
+    if (s == -1) {
+        if (errno == EAGAIN || errno == ENOBUFS)
+            return -1;
+        throw LibError(errno, "udp socket sendmsg failed");
+    }
+    return static_cast<int>(s);
+}
+
+int UdpSocket::recv_from(void* data, size_t sz, UdpEndpoint& from) {
+    chk_skt_or_fail();
+    socklen_t len = sizeof(from.addr);
+    ssize_t s = recvfrom(skt, data, sz, 0, (struct sockaddr*)&from.addr, &len);
+    if (s == -1) {
+        if (errno == EAGAIN)
+            return -1;
+        throw LibError(errno, "udp socket recvfrom failed");
+    }
+    return static_cast<int>(s);
+}
+
+int UdpSocket::send(const void* data, size_t sz) {
+    chk_skt_or_fail();
+    ssize_t s = ::send(skt, data, sz, MSG_NOSIGNAL);
+    if (s == -1) {
+        /*
+         * En un socket UDP conectado, un ICMP "port unreachable" de un envío
+         * anterior vuelve como ECONNREFUSED: para nosotros es un datagrama perdido.
+         * */
+        if (errno == EAGAIN || errno == ENOBUFS || errno == ECONNREFUSED)
+            return -1;
+        throw LibError(errno, "udp socket send failed");
+    }
+    return static_cast<int>(s);
+}
+
+int UdpSocket::recv(void* data, size_t sz) {
+    chk_skt_or_fail();
+    ssize_t s = ::recv(skt, data, sz, 0);
+    if (s == -1) {
+        if (errno == EAGAIN || errno == ECONNREFUSED)
+            return -1;
+        throw LibError(errno, "udp socket recv failed");
+    }
+    return static_cast<int>(s);
+}
+
+void UdpSocket::set_nonblocking(bool enabled) {
+    chk_skt_or_fail();
+    int flags = fcntl(skt, F_GETFL, 0);
+    if (flags == -1)
+        throw LibError(errno, "udp socket fcntl(F_GETFL) failed");
+
+    flags = enabled ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    if (fcntl(skt, F_SETFL, flags) == -1)
+        throw LibError(errno, "udp socket fcntl(F_SETFL) failed");
+}
+
+int UdpSocket::get_fd() const {
+    chk_skt_or_fail();
+    return skt;
+}
+
+uint16_t UdpSocket::get_local_port() const {
+    chk_skt_or_fail();
+    struct sockaddr_in local;
+    socklen_t len = sizeof(local);
+    if (getsockname(skt, (struct sockaddr*)&local, &len) == -1)
+        throw LibError(errno, "udp socket getsockname failed");
+    return ntohs(local.sin_port);
+}
+
+UdpSocket::~UdpSocket() {
+    if (skt != -1)
+        ::close(skt);
+}
+
+void UdpSocket::chk_skt_or_fail() const {
+    if (skt == -1) {
+        throw std::runtime_error("udp socket with invalid file descriptor (-1)");
+    }
+}
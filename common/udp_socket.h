@@ -0,0 +1,76 @@
+#ifndef UDP_SOCKET_H
+#define UDP_SOCKET_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <netinet/in.h>
+
+class Socket;
+struct iovec;
+
+/*
+ * Dirección (IPv4 y puerto) del otro extremo de un datagrama.
+ * */
+struct UdpEndpoint {
+    struct sockaddr_in addr;
+
+    bool operator==(const UdpEndpoint& other) const;
+};
+
+/*
+ * TDA Socket UDP. Igual que `Socket`, solo IPv4.
+ *
+ * No hay conexión ni stream: cada envío es un datagrama completo que puede
+ * perderse, duplicarse o llegar desordenado. Quien lo usa tiene que tolerarlo.
+ * */
+class UdpSocket {
+private:
+    int skt;
+
+    /* Véase `Socket::chk_skt_or_fail` */
+    void chk_skt_or_fail() const;
+
+public:
+    /*
+     * Servidor: recibe datagramas de cualquier peer en el puerto <servname>.
+     * Cliente: se "conecta" a la IP del peer de `tcp_peer` en el puerto `port`,
+     * así el kernel descarta los datagramas que lleguen de otro lado.
+     *
+     * En caso de error los constructores lanzan una excepción.
+     * */
+    explicit UdpSocket(const char* servname);
+    UdpSocket(const Socket& tcp_peer, uint16_t port);
+
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    /*
+     * Envían o reciben un datagrama. `send`/`recv` son para el socket del
+     * cliente (conectado); `send_to`/`recv_from` para el del servidor.
+     *
+     * Retornan la cantidad de bytes, o -1 si el datagrama no se pudo enviar
+     * o no hay ninguno esperando (modo no bloqueante o peer que todavía no
+     * escucha). Un datagrama más grande que `sz` se trunca.
+     *
+     * `send_to` también acepta varios buffers que salen juntos en un solo
+     * datagrama (véase `Socket::sendsomev`).
+     *
+     * Si hay un error se lanza una excepción.
+     * */
+    int send_to(const void* data, size_t sz, const UdpEndpoint& to);
+    int send_to(const struct iovec* iov, int iovcnt, const UdpEndpoint& to);
+    int recv_from(void* data, size_t sz, UdpEndpoint& from);
+    int send(const void* data, size_t sz);
+    int recv(void* data, size_t sz);
+
+    /* Véase `Socket::set_nonblocking` */
+    void set_nonblocking(bool enabled);
+
+    int get_fd() const;
+    uint16_t get_local_port() const;
+
+    ~UdpSocket();
+};
+
+#endif
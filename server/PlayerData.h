@@ -1,8 +1,11 @@
 #ifndef PLAYER_DATA_H
 #define PLAYER_DATA_H
 #include "event.h"
+#include "car_physics_config.h"
+#include "gameloop/bridge/bridge_contacts.h"
 #include <box2d/b2_body.h>
 #include <chrono>
+#include <string>
 #include <vector>
 
 struct UpgradeLevels
@@ -15,7 +18,8 @@ struct UpgradeLevels
 
 struct CarInfo
 {
-    std::string car_name;
+    // Parámetros del modelo elegido: la física del tick no busca por nombre
+    const CarPhysics *physics = nullptr;
     float speed;
     float acceleration;
     float hp;
@@ -23,16 +27,18 @@ struct CarInfo
     float handling;
 };
 
+// Datos de cada tick de un jugador. No tiene strings ni vectores: se guardan
+// contiguos en PlayerStore y los recorridos del tick no saltan por el heap.
 struct PlayerData
 {
-    b2Body *body;
-    std::string state;
+    b2Body *body = nullptr;
+    // Último movimiento recibido: resuelve press/release cruzados del mismo eje
+    InputAction state = InputAction::MOVE_UP_RELEASED;
     CarInfo car;
-    UpgradeLevels upgrades;
     Position position;
+    BridgeContacts bridge;
 
     int next_checkpoint = 0;
-    std::chrono::steady_clock::time_point lap_start_time;
 
     bool race_finished = false;
     bool is_dead = false;
@@ -40,8 +46,6 @@ struct PlayerData
     bool collision_this_frame = false;
     bool mark_body_for_removal = false;
 
-    std::vector<uint32_t> round_times_ms{0, 0, 0};
-    uint32_t total_time_ms = 0;
     int rounds_completed = 0;
     bool disqualified = false;
     bool is_stopping = false;
@@ -49,4 +53,15 @@ struct PlayerData
     bool pending_disqualification = false;
     bool pending_race_complete = false;
 };
-#endif
\ No newline at end of file
+
+// Datos fríos de un jugador: se usan al cerrar vueltas, en mejoras y al
+// armar el snapshot, no en la física. Van en un arreglo aparte del store.
+struct PlayerRecord
+{
+    std::string car_name;
+    UpgradeLevels upgrades;
+    std::chrono::steady_clock::time_point lap_start_time;
+    std::vector<uint32_t> round_times_ms{0, 0, 0};
+    uint32_t total_time_ms = 0;
+};
+#endif
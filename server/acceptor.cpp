@@ -1,15 +1,21 @@
 #include "acceptor.h"
 #include "lobby_handler.h"
+#include "server_config.h"
 #include <algorithm>
+#include <iostream>
 
 Acceptor::Acceptor(Socket &acc, LobbyHandler &msg_admin) 
-    : acceptor(std::move(acc)), message_handler(msg_admin) {}
+    : acceptor(std::move(acc)), message_handler(msg_admin), udp_channel(), reactors(), next_reactor(0) {}
 
 Acceptor::Acceptor(const char *port, LobbyHandler &msg_admin) 
-    : acceptor(Socket(port)), message_handler(msg_admin) {}
+    : acceptor(Socket(port)), message_handler(msg_admin), udp_channel(), reactors(), next_reactor(0)
+{
+    start_udp_channel(port);
+}
 
 void Acceptor::run()
 {
+    start_reactors();
     while (should_keep_running())
     {
         try
@@ -18,7 +24,8 @@ void Acceptor::run()
 
             Socket peer = acceptor.accept();
 
-            auto c = std::make_unique<ClientHandler>(std::move(peer), message_handler);
+            Reactor &reactor = *reactors[next_reactor++ % reactors.size()];
+            auto c = std::make_unique<ClientHandler>(std::move(peer), message_handler, reactor, udp_channel.get());
             c->start();
 
             clients.push_back(std::move(c));
@@ -30,6 +37,12 @@ void Acceptor::run()
         }
     }
     kill_all();
+    stop_reactors();
+    if (udp_channel)
+    {
+        udp_channel->stop();
+        udp_channel->join();
+    }
 }
 
 void Acceptor::stop()
@@ -45,6 +58,46 @@ void Acceptor::stop()
     }
 }
 
+void Acceptor::start_udp_channel(const char *port)
+{
+    if (!ServerConfig::getInstance().isUdpEnabled())
+        return;
+    try
+    {
+        udp_channel = std::make_unique<UdpChannel>(port, message_handler);
+        udp_channel->start();
+    }
+    catch (const std::exception &e)
+    {
+        // Sin UDP los clientes siguen recibiendo todo por TCP
+        std::cerr << "[Acceptor] No se pudo abrir el canal UDP: " << e.what() << std::endl;
+        udp_channel.reset();
+    }
+}
+
+void Acceptor::start_reactors()
+{
+    int io_threads = std::max(1, ServerConfig::getInstance().getIoThreads());
+    for (int i = 0; i < io_threads; ++i)
+    {
+        reactors.push_back(std::make_unique<Reactor>());
+        reactors.back()->start();
+    }
+}
+
+void Acceptor::stop_reactors()
+{
+    for (auto &reactor : reactors)
+    {
+        reactor->stop();
+    }
+    for (auto &reactor : reactors)
+    {
+        reactor->join();
+    }
+    reactors.clear();
+}
+
 void Acceptor::kill_all()
 {
     for (auto &client : clients)
@@ -6,12 +6,13 @@
 #include <vector>
 #include <list>
 #include "../common/protocol.h"
-#include "../common/queue.h"
+#include "../common/reactor.h"
 #include "../common/socket.h"
 #include "../common/thread.h"
 
 #include "client_handler.h"
 #include "client_handler_msg.h"
+#include "udp_channel.h"
 
 // Forward declaration para evitar dependencia circular
 class LobbyHandler;
@@ -20,6 +21,11 @@ class Acceptor : public Thread
 {
     Socket acceptor;
     LobbyHandler &message_handler;
+    // Canal UDP de snapshots en el mismo puerto (nullptr si está deshabilitado)
+    std::unique_ptr<UdpChannel> udp_channel;
+    // Event loops que atienden a todos los clientes (asignados round-robin)
+    std::vector<std::unique_ptr<Reactor>> reactors;
+    size_t next_reactor;
     std::vector<std::unique_ptr<ClientHandler>> clients;
 
 public:
@@ -30,6 +36,9 @@ public:
     void stop() override;
 
 private:
+    void start_udp_channel(const char *port);
+    void start_reactors();
+    void stop_reactors();
     void kill_all();
     void reap();
 };
@@ -61,7 +61,7 @@ bool CarPhysicsConfig::loadFromFile(const std::string &path)
 
 bool CarPhysicsConfig::reload()
 {
-    car_configs.clear();
+    // Sin clear: los jugadores guardan punteros a estas entradas (CarInfo::physics)
     return loadFromFile(config_path);
 }
 
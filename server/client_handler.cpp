@@ -1,57 +1,230 @@
 #include "client_handler.h"
 #include "lobby_handler.h"
+#include "server_config.h"
+#include "udp_channel.h"
+#include <algorithm>
+#include <iostream>
+
+#define OUTBOX_SIZE 100
+// Bytes encolados en el socket a partir de los cuales se deja de vaciar el outbox
+// (si el cliente no lee, el juego reemplaza snapshots y termina desconectándolo)
+#define MAX_PENDING_OUTPUT (64 * 1024)
 
 // Inicialización del contador estático
 int ClientHandler::next_id = 0;
 
 // ---------------- ClientHandler ----------------
-ClientHandler::ClientHandler(Socket &&p, LobbyHandler &msg_admin) 
+ClientHandler::ClientHandler(Socket &&p, LobbyHandler &msg_admin, Reactor &reactor, UdpChannel *udp_channel)
     : protocol(std::move(p)),
-      outbox(std::make_shared<Queue<ServerMessage>>(100)), // bounded queue tamaño 100
+      outbox(std::make_shared<Outbox>(OUTBOX_SIZE)), // bounded queue tamaño 100
       message_handler(msg_admin),
-      sender(protocol, *outbox),
+      reactor(reactor),
       client_id(next_id++),  // Auto-asigna ID
-      receiver(protocol, client_id, msg_admin, outbox)  // Pasar outbox a receiver
+      alive(false),
+      registered(false),
+      leave_pending(false),
+      udp_channel(udp_channel),
+      udp_token(0)
 {}
 
-ClientHandler::~ClientHandler() = default;
+ClientHandler::~ClientHandler()
+{
+    stop();
+}
 
 void ClientHandler::start()
 {
-    sender.start();
-    receiver.start();
+    protocol.setNonBlocking();
+    protocol.setNoDelay(true);
+    int send_buffer = ServerConfig::getInstance().getSocketSendBufferBytes();
+    if (send_buffer > 0)
+        protocol.setSendBuffer(send_buffer);
+    outbox->set_on_push([this]() { reactor.request_write(this); });
+    alive = true;
+    registered = true;
+    leave_pending = true;
+    reactor.add(this);
 }
 
 void ClientHandler::stop()
 {
-    try
+    if (registered)
     {
-        protocol.shutdown();
+        registered = false;
+        // Al retornar, el reactor ya no llama a ningún callback nuestro
+        reactor.remove(this);
     }
-    catch (...)
+    // Reap o cierre del servidor sin que el reactor haya cerrado la conexión
+    notify_disconnect();
+    if (udp_token != 0)
     {
+        udp_channel->unregister_client(udp_token);
+        udp_token = 0;
     }
-    try
+    if (outbox)
     {
-        if (outbox) {
-            try { outbox->close(); } catch (...) {}
+        outbox->set_on_push(nullptr);
+        outbox->close();
+    }
+    protocol.shutdown();
+    alive = false;
+}
+
+bool ClientHandler::is_alive() { return alive; }
+
+std::shared_ptr<Outbox> ClientHandler::get_outbox() { return outbox; }
+
+int ClientHandler::get_id() { return client_id; }
+
+int ClientHandler::get_fd() const { return protocol.getFd(); }
+
+bool ClientHandler::on_readable()
+{
+    bool open = protocol.readAvailable();
+
+    ClientMessage client_msg;
+    while (protocol.nextClientMessage(client_msg))
+    {
+        if (client_msg.opcode == 0)
+        {
+            // Opcode desconocido: el stream quedó desincronizado
+            open = false;
+            break;
+        }
+        if (client_msg.opcode == SNAPSHOT_ACK)
+        {
+            // Estado del transporte: no pasa por el lobby ni por la cola del juego
+            outbox->ack_snapshot(client_msg.snapshot_seq);
+            continue;
         }
+        if (client_msg.opcode == HELLO)
+        {
+            negotiate_version(client_msg.protocol_version);
+            continue;
+        }
+        if (client_msg.opcode == UDP_REQUEST)
+        {
+            offer_datagram_channel(client_msg.game_id);
+            continue;
+        }
+        dispatch(client_msg);
+    }
+
+    if (!open)
+        return false; // on_closed avisa la desconexión
+    // Las respuestas del lobby quedaron en el outbox
+    return on_writable();
+}
+
+bool ClientHandler::on_writable()
+{
+    if (outbox->is_dropped())
+    {
+        // La partida nos sacó por no leer a tiempo: se corta la conexión
+        std::cerr << "[ClientHandler] Cliente " << client_id << " desconectado por lento" << std::endl;
+        return false;
     }
-    catch (...)
+    bool outbox_empty = false;
+    while (!outbox_empty)
     {
+        outbox_empty = drain_outbox(MAX_PENDING_OUTPUT);
+        if (!protocol.flushPending())
+            return false;
+        if (protocol.hasPendingOutput())
+            break; // el socket no acepta más: seguimos con EPOLLOUT
     }
+    return true;
+}
+
+bool ClientHandler::has_pending_output() const
+{
+    return protocol.hasPendingOutput();
+}
+
+void ClientHandler::on_closed()
+{
+    alive = false;
+    notify_disconnect();
+}
 
-    sender.stop();
-    receiver.stop();
+void ClientHandler::dispatch(const ClientMessage &client_msg)
+{
+    // Un comando del lobby responde por el outbox: se le hace lugar sin pasar
+    // MAX_PENDING_OUTPUT (si aun así está lleno, el lobby desconecta al cliente).
+    // Los inputs no responden: vaciar acá sacaría snapshots del outbox antes de
+    // que se puedan pisar.
+    if (client_msg.input.action == InputAction::NONE)
+        drain_outbox(MAX_PENDING_OUTPUT);
 
-    sender.join();
-    receiver.join();
+    ClientHandlerMessage msg;
+    msg.client_id = client_id;
+    msg.msg = client_msg;
+    msg.outbox = outbox;  // Pasar outbox
 
-    outbox.reset();
+    message_handler.handle_message(msg);
 }
 
-bool ClientHandler::is_alive() { return sender.is_alive() && receiver.is_alive(); }
+void ClientHandler::notify_disconnect()
+{
+    // on_closed (EOF, error de escritura, lento, excepción) y stop() llegan acá: un solo LEAVE_GAME
+    if (!leave_pending.exchange(false))
+        return;
+    ClientHandlerMessage leave_msg;
+    leave_msg.client_id = client_id;
+    leave_msg.msg.cmd = LEAVE_GAME_STR;
+    leave_msg.msg.player_id = -1;
+    leave_msg.msg.game_id = -1;
+    leave_msg.outbox = outbox;  // Pasar outbox
 
-std::shared_ptr<Queue<ServerMessage>> ClientHandler::get_outbox() { return outbox; }
+    // Procesar directamente el mensaje de desconexión
+    message_handler.handle_message(leave_msg);
+}
 
-int ClientHandler::get_id() { return client_id; }
+void ClientHandler::negotiate_version(uint8_t requested)
+{
+    uint8_t version = std::clamp(requested, PROTOCOL_VERSION_LEGACY, PROTOCOL_VERSION);
+    // Lo que ya estaba encolado sale con la versión anterior, antes de la respuesta.
+    // El cliente manda HELLO al conectarse, antes de entrar a una partida, así que
+    // todavía no hay broadcasts codificados para la versión vieja en camino.
+    drain_outbox(MAX_PENDING_OUTPUT);
+    protocol.setVersion(version);
+    outbox->set_wire_version(version);
+
+    ServerMessage reply;
+    reply.opcode = HELLO;
+    reply.protocol_version = version;
+    protocol.queueMessage(reply);
+}
+
+void ClientHandler::offer_datagram_channel(int game_id)
+{
+    // Sin canal, o con un cliente que no manda largos en TCP, se sigue todo por TCP
+    if (!udp_channel || protocol.getVersion() < PROTOCOL_VERSION_FRAMED)
+        return;
+    // Al cambiar de partida se pide de nuevo: el token anterior deja de valer
+    if (udp_token != 0)
+        udp_channel->unregister_client(udp_token);
+    udp_token = udp_channel->register_client(client_id, game_id, outbox);
+
+    drain_outbox(MAX_PENDING_OUTPUT);
+    ServerMessage offer;
+    offer.opcode = UDP_OFFER;
+    offer.udp_port = udp_channel->get_port();
+    offer.udp_token = udp_token;
+    protocol.queueMessage(offer);
+}
+
+bool ClientHandler::drain_outbox(size_t max_pending_bytes)
+{
+    OutboundMessage response;
+    while (protocol.pendingOutputBytes() < max_pending_bytes)
+    {
+        if (!outbox->try_pop(response))
+            return true;
+        if (auto *frame = std::get_if<EncodedFrame>(&response))
+            protocol.queueFrame(*frame);
+        else
+            protocol.queueMessage(std::get<ServerMessage>(response));
+    }
+    return false;
+}
@@ -1,45 +1,70 @@
 #ifndef CLIENT_HANDLER_H
 #define CLIENT_HANDLER_H
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <utility>
 
 #include "../common/protocol.h"
-#include "../common/queue.h"
+#include "../common/reactor.h"
 #include "../common/socket.h"
-#include "../common/thread.h"
 #include "../common/messages.h"
 
 #include "client_handler_msg.h"
-#include "client_receiver.h"
-#include "client_sender.h"
+#include "outbox.h"
 
 // Forward declaration
 class LobbyHandler;
+class UdpChannel;
 
 // ---------------- ClientHandler ----------------
-class ClientHandler
+// Conexión de un cliente atendida por un Reactor: lee y decodifica los
+// mensajes a medida que llegan y vacía el outbox en el buffer de escritura.
+class ClientHandler : public ReactorHandler
 {
     Protocol protocol;
-    std::shared_ptr<Queue<ServerMessage>> outbox;
+    std::shared_ptr<Outbox> outbox;
     LobbyHandler &message_handler;
-    ClientSender sender;
+    Reactor &reactor;
     int client_id;
-    ClientReceiver receiver;
+    std::atomic<bool> alive;
+    bool registered;
+    // Falta mandar el LEAVE_GAME de esta conexión (se manda una sola vez)
+    std::atomic<bool> leave_pending;
+    // nullptr si el servidor no ofrece UDP
+    UdpChannel *udp_channel;
+    uint32_t udp_token;
 
     static int next_id;
 
+    void dispatch(const ClientMessage &client_msg);
+    // Manda LEAVE_GAME al lobby la primera vez que se llama
+    void notify_disconnect();
+    // Responde al HELLO del cliente con la versión elegida
+    void negotiate_version(uint8_t requested);
+    // Responde a UDP_REQUEST con el puerto y el token del canal UDP
+    void offer_datagram_channel(int game_id);
+    // Pasa al buffer de escritura lo encolado en el outbox. Retorna true si lo vació.
+    bool drain_outbox(size_t max_pending_bytes);
+
 public:
-    ClientHandler(Socket &&p, LobbyHandler &msg_handler);
-    ~ClientHandler();
+    ClientHandler(Socket &&p, LobbyHandler &msg_handler, Reactor &reactor, UdpChannel *udp_channel = nullptr);
+    ~ClientHandler() override;
 
     void start();
     void stop();
     bool is_alive();
 
-    std::shared_ptr<Queue<ServerMessage>> get_outbox();
+    std::shared_ptr<Outbox> get_outbox();
     int get_id();
+
+    // ReactorHandler
+    int get_fd() const override;
+    bool on_readable() override;
+    bool on_writable() override;
+    bool has_pending_output() const override;
+    void on_closed() override;
 };
 
 #endif // CLIENT_HANDLER_H
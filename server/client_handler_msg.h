@@ -3,6 +3,7 @@
 
 #include "../common/messages.h"
 #include "../common/queue.h"
+#include "outbox.h"
 #include <memory>
 
 struct ClientHandlerMessage
@@ -10,7 +11,7 @@ struct ClientHandlerMessage
     int client_id;
     ClientMessage msg;
     int game_id;
-    std::shared_ptr<Queue<ServerMessage>> outbox;  // Cola de salida del cliente
+    std::shared_ptr<Outbox> outbox;  // Cola de salida del cliente
 };
 
 #endif
@@ -0,0 +1,184 @@
+#include "collision_merger.h"
+#include <algorithm>
+#include <cmath>
+
+void CollisionMerger::merge(std::vector<MapLayout::CollisionPolygon> &polygons)
+{
+    std::vector<MapLayout::CollisionPolygon> result;
+    std::vector<uint16_t> categories;
+    std::vector<std::vector<Rect>> rects_by_category;
+
+    for (auto &polygon : polygons)
+    {
+        Rect rect;
+        if (!is_mergeable(polygon.category) || !as_rect(polygon, rect))
+        {
+            result.push_back(std::move(polygon));
+            continue;
+        }
+        auto it = std::find(categories.begin(), categories.end(), polygon.category);
+        if (it == categories.end())
+        {
+            categories.push_back(polygon.category);
+            rects_by_category.emplace_back();
+            it = categories.end() - 1;
+        }
+        rects_by_category[it - categories.begin()].push_back(rect);
+    }
+
+    for (size_t c = 0; c < categories.size(); ++c)
+    {
+        const std::vector<Rect> &rects = rects_by_category[c];
+        // Se prueba barriendo por filas y por columnas; si ninguna mejora a
+        // lo dibujado en Tiled, quedan los rectángulos originales
+        std::vector<Rect> merged = rects;
+        for (bool by_columns : {false, true})
+        {
+            std::vector<Rect> candidate;
+            if (merge_rects(by_columns ? transposed(rects) : rects, candidate) && candidate.size() < merged.size())
+                merged = by_columns ? transposed(candidate) : candidate;
+        }
+        for (const Rect &r : merged)
+        {
+            result.push_back({categories[c],
+                              {b2Vec2(r.min_x, r.min_y), b2Vec2(r.max_x, r.min_y),
+                               b2Vec2(r.max_x, r.max_y), b2Vec2(r.min_x, r.max_y)}});
+        }
+    }
+
+    polygons = std::move(result);
+}
+
+bool CollisionMerger::is_mergeable(uint16_t category)
+{
+    // Los sensores cuentan contactos por fixture (BridgeContacts): no se tocan
+    return category == COLLISION_FLOOR || category == COLLISION_BRIDGE || category == COLLISION_UNDER;
+}
+
+bool CollisionMerger::as_rect(const MapLayout::CollisionPolygon &polygon, Rect &out)
+{
+    if (polygon.vertices.size() != 4)
+        return false;
+
+    out = {polygon.vertices[0].x, polygon.vertices[0].y, polygon.vertices[0].x, polygon.vertices[0].y};
+    for (const auto &v : polygon.vertices)
+    {
+        out.min_x = std::min(out.min_x, v.x);
+        out.min_y = std::min(out.min_y, v.y);
+        out.max_x = std::max(out.max_x, v.x);
+        out.max_y = std::max(out.max_y, v.y);
+    }
+    if (out.max_x - out.min_x <= SNAP_M || out.max_y - out.min_y <= SNAP_M)
+        return false;
+
+    // Cada vértice tiene que estar en una esquina, y cada esquina usada una vez
+    int corners = 0;
+    for (const auto &v : polygon.vertices)
+    {
+        bool on_x = std::abs(v.x - out.min_x) <= SNAP_M || std::abs(v.x - out.max_x) <= SNAP_M;
+        bool on_y = std::abs(v.y - out.min_y) <= SNAP_M || std::abs(v.y - out.max_y) <= SNAP_M;
+        if (!on_x || !on_y)
+            return false;
+        int corner = (std::abs(v.x - out.max_x) <= SNAP_M ? 1 : 0) | (std::abs(v.y - out.max_y) <= SNAP_M ? 2 : 0);
+        corners |= 1 << corner;
+    }
+    return corners == 0xF;
+}
+
+std::vector<CollisionMerger::Rect> CollisionMerger::transposed(const std::vector<Rect> &rects)
+{
+    std::vector<Rect> out;
+    out.reserve(rects.size());
+    for (const Rect &r : rects)
+        out.push_back({r.min_y, r.min_x, r.max_y, r.max_x});
+    return out;
+}
+
+std::vector<float> CollisionMerger::grid_lines(const std::vector<Rect> &rects, bool x_axis)
+{
+    std::vector<float> values;
+    values.reserve(rects.size() * 2);
+    for (const Rect &r : rects)
+    {
+        values.push_back(x_axis ? r.min_x : r.min_y);
+        values.push_back(x_axis ? r.max_x : r.max_y);
+    }
+    std::sort(values.begin(), values.end());
+
+    std::vector<float> lines;
+    for (float v : values)
+    {
+        if (lines.empty() || v - lines.back() > SNAP_M)
+            lines.push_back(v);
+    }
+    return lines;
+}
+
+size_t CollisionMerger::line_index(const std::vector<float> &lines, float value)
+{
+    // La línea más cercana: value está a menos de SNAP_M de alguna
+    auto it = std::lower_bound(lines.begin(), lines.end(), value - SNAP_M);
+    return static_cast<size_t>(it - lines.begin());
+}
+
+bool CollisionMerger::merge_rects(const std::vector<Rect> &rects, std::vector<Rect> &out)
+{
+    std::vector<float> xs = grid_lines(rects, true);
+    std::vector<float> ys = grid_lines(rects, false);
+    if (xs.size() < 2 || ys.size() < 2)
+        return false;
+    size_t cols = xs.size() - 1;
+    size_t rows = ys.size() - 1;
+    if (cols * rows > MAX_GRID_CELLS)
+        return false;
+
+    // Marcar las celdas cubiertas con un arreglo de diferencias 2D
+    std::vector<int> cover((cols + 1) * (rows + 1), 0);
+    for (const Rect &r : rects)
+    {
+        size_t x0 = line_index(xs, r.min_x), x1 = line_index(xs, r.max_x);
+        size_t y0 = line_index(ys, r.min_y), y1 = line_index(ys, r.max_y);
+        cover[y0 * (cols + 1) + x0] += 1;
+        cover[y0 * (cols + 1) + x1] -= 1;
+        cover[y1 * (cols + 1) + x0] -= 1;
+        cover[y1 * (cols + 1) + x1] += 1;
+    }
+    std::vector<uint8_t> filled(cols * rows, 0);
+    std::vector<int> column_sum(cols + 1, 0);
+    for (size_t y = 0; y < rows; ++y)
+    {
+        int row_sum = 0;
+        for (size_t x = 0; x < cols; ++x)
+        {
+            column_sum[x] += cover[y * (cols + 1) + x];
+            row_sum += column_sum[x];
+            filled[y * cols + x] = row_sum > 0;
+        }
+    }
+
+    // Rectángulos maximales: la corrida horizontal más larga desde cada celda
+    // libre y después tantas filas hacia abajo como cubran esa corrida entera
+    for (size_t y = 0; y < rows; ++y)
+    {
+        for (size_t x = 0; x < cols; ++x)
+        {
+            if (!filled[y * cols + x])
+                continue;
+
+            size_t x_end = x;
+            while (x_end < cols && filled[y * cols + x_end])
+                ++x_end;
+
+            size_t y_end = y + 1;
+            while (y_end < rows &&
+                   std::all_of(filled.begin() + y_end * cols + x, filled.begin() + y_end * cols + x_end,
+                               [](uint8_t cell) { return cell != 0; }))
+                ++y_end;
+
+            for (size_t fy = y; fy < y_end; ++fy)
+                std::fill(filled.begin() + fy * cols + x, filled.begin() + fy * cols + x_end, 0);
+            out.push_back({xs[x], ys[y], xs[x_end], ys[y_end]});
+        }
+    }
+    return true;
+}
@@ -0,0 +1,45 @@
+#ifndef COLLISION_MERGER_H
+#define COLLISION_MERGER_H
+
+#include <cstdint>
+#include <vector>
+#include "map_layout.h"
+
+/*
+ * Preproceso de la geometría estática del mapa
+ *
+ * Los muros de Tiled son en su mayoría rectángulos chicos pegados entre sí.
+ * Por cada categoría sólida se unen los rectángulos alineados a los ejes
+ * (compresión de coordenadas sobre una grilla) y la unión se vuelve a partir
+ * en rectángulos maximales: misma área cubierta, sin solapamientos ni aristas
+ * internas entre bloques vecinos. Si la partición no tiene menos rectángulos
+ * que los originales, se conservan los originales.
+ *
+ * Los sensores de puente y los polígonos que no son rectángulos alineados se
+ * dejan como están.
+ * */
+class CollisionMerger
+{
+public:
+    static void merge(std::vector<MapLayout::CollisionPolygon> &polygons);
+
+private:
+    struct Rect
+    {
+        float min_x, min_y, max_x, max_y;
+    };
+
+    // Coordenadas a menos de esto (metros) se consideran la misma línea de la grilla
+    static constexpr float SNAP_M = 1e-4f;
+    // Tope de celdas por categoría; por encima no se une esa categoría
+    static constexpr size_t MAX_GRID_CELLS = size_t(1) << 24;
+
+    static bool is_mergeable(uint16_t category);
+    static bool as_rect(const MapLayout::CollisionPolygon &polygon, Rect &out);
+    static std::vector<Rect> transposed(const std::vector<Rect> &rects);
+    static std::vector<float> grid_lines(const std::vector<Rect> &rects, bool x_axis);
+    static size_t line_index(const std::vector<float> &lines, float value);
+    static bool merge_rects(const std::vector<Rect> &rects, std::vector<Rect> &out);
+};
+
+#endif
@@ -1,7 +1,6 @@
 #include "event.h"
 
-Event::Event(int client, std::string act)
-    : client_id(client), action(act)
+Event::Event(int client, InputEvent input)
+    : client_id(client), input(input)
 {
 }
-
@@ -1,19 +1,20 @@
 #ifndef EVENT_H
 #define EVENT_H
-#include <string>
-#include "../common/position.h"
+#include "../common/messages.h"
+#include "../common/ring_queue.h"
 
+// Acción de un jugador hacia su partida. Es POD: se copia por las colas sin allocar.
 struct Event
 {
-    int client_id = -1;      // Valor por defecto
-    std::string action = ""; // Valor por defecto
+    int client_id = -1;
+    InputEvent input;
 
-    // Constructor sin parámetros (por defecto)
     Event() = default;
 
-    // Constructor con parámetros
-    Event(int client, std::string act);
-
-    virtual ~Event() = default;
+    Event(int client, InputEvent input);
 };
-#endif
\ No newline at end of file
+
+// Cola de eventos de una partida: la llenan los reactores (varios productores)
+// y la vacía solo el tick de esa partida
+using EventQueue = RingQueue<Event>;
+#endif
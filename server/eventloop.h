@@ -1,7 +1,8 @@
 #ifndef EVENTLOOP_EVENTLOOP_H
 #define EVENTLOOP_EVENTLOOP_H
 #include <string>
-#include "../common/queue.h"
+#include <vector>
+#include "event.h"
 #include "game_event_handler.h"
 #include "game_state.h"
 
@@ -9,12 +10,14 @@ class EventLoop
 {
 private:
     std::mutex &players_map_mutex;
-    std::unordered_map<int, PlayerData> &players;
-    std::shared_ptr<Queue<Event>> &event_queue;
+    PlayerStore &players;
+    std::shared_ptr<EventQueue> &event_queue;
+    // Lote del tick actual, se reusa para no allocar en cada tick
+    std::vector<Event> pending;
     GameEventHandler dispatcher;
 
 public:
-    explicit EventLoop(std::mutex &map_mutex, std::unordered_map<int, PlayerData> &map, std::shared_ptr<Queue<Event>> &global_inb);
+    explicit EventLoop(std::mutex &map_mutex, PlayerStore &map, std::shared_ptr<EventQueue> &global_inb);
     void process_available_events(GameState state);
 
     ~EventLoop() = default;
@@ -1,6 +1,7 @@
 #include "game_event_handler.h"
 #include "../common/constants.h"
 #include "gameloop/gameloop_constants.h"
+#include "gameloop/world/entity_tag.h"
 #include <box2d/b2_world.h>
 #include <box2d/b2_body.h>
 #include <box2d/b2_polygon_shape.h>
@@ -8,175 +9,195 @@
 
 void GameEventHandler::init_handlers()
 {
-    listeners[MOVE_UP_PRESSED_STR] = [this](Event &e)
-    { move_up(e); };
-    listeners[MOVE_UP_RELEASED_STR] = [this](Event &e)
-    { move_up_released(e); };
-    listeners[MOVE_DOWN_PRESSED_STR] = [this](Event &e)
-    { move_down(e); };
-    listeners[MOVE_DOWN_RELEASED_STR] = [this](Event &e)
-    { move_down_released(e); };
-    listeners[MOVE_LEFT_PRESSED_STR] = [this](Event &e)
-    { move_left(e); };
-    listeners[MOVE_LEFT_RELEASED_STR] = [this](Event &e)
-    { move_left_released(e); };
-    listeners[MOVE_RIGHT_PRESSED_STR] = [this](Event &e)
-    { move_right(e); };
-    listeners[MOVE_RIGHT_RELEASED_STR] = [this](Event &e)
-    { move_right_released(e); };
-    listeners[std::string(CHANGE_CAR_STR) + " " + GREEN_CAR] = [this](Event &e)
-    { select_car(e, GREEN_CAR); };
-    listeners[std::string(CHANGE_CAR_STR) + " " + RED_SQUARED_CAR] = [this](Event &e)
-    { select_car(e, RED_SQUARED_CAR); };
-    listeners[std::string(CHANGE_CAR_STR) + " " + RED_SPORTS_CAR] = [this](Event &e)
-    { select_car(e, RED_SPORTS_CAR); };
-    listeners[std::string(CHANGE_CAR_STR) + " " + LIGHT_BLUE_CAR] = [this](Event &e)
-    { select_car(e, LIGHT_BLUE_CAR); };
-    listeners[std::string(CHANGE_CAR_STR) + " " + RED_JEEP_CAR] = [this](Event &e)
-    { select_car(e, RED_JEEP_CAR); };
-    listeners[std::string(CHANGE_CAR_STR) + " " + PURPLE_TRUCK] = [this](Event &e)
-    { select_car(e, PURPLE_TRUCK); };
-    listeners[std::string(CHANGE_CAR_STR) + " " + LIMOUSINE_CAR] = [this](Event &e)
-    { select_car(e, LIMOUSINE_CAR); };
-    listeners[std::string(UPGRADE_CAR_STR) + " " + std::to_string(int(CarUpgrade::ACCELERATION_BOOST))] = [this](Event &e)
+    move_listeners[index(InputAction::MOVE_UP_PRESSED)] = &GameEventHandler::move_up;
+    move_listeners[index(InputAction::MOVE_UP_RELEASED)] = &GameEventHandler::move_up_released;
+    move_listeners[index(InputAction::MOVE_DOWN_PRESSED)] = &GameEventHandler::move_down;
+    move_listeners[index(InputAction::MOVE_DOWN_RELEASED)] = &GameEventHandler::move_down_released;
+    move_listeners[index(InputAction::MOVE_LEFT_PRESSED)] = &GameEventHandler::move_left;
+    move_listeners[index(InputAction::MOVE_LEFT_RELEASED)] = &GameEventHandler::move_left_released;
+    move_listeners[index(InputAction::MOVE_RIGHT_PRESSED)] = &GameEventHandler::move_right;
+    move_listeners[index(InputAction::MOVE_RIGHT_RELEASED)] = &GameEventHandler::move_right_released;
+    listeners[index(InputAction::CHANGE_CAR)] = [this](Event &e)
+    { select_car(e); };
+    listeners[index(InputAction::UPGRADE_ACCELERATION)] = [this](Event &e)
     { upgrade_max_acceleration(e); };
-    listeners[std::string(UPGRADE_CAR_STR) + " " + std::to_string(int(CarUpgrade::SPEED_BOOST))] = [this](Event &e)
+    listeners[index(InputAction::UPGRADE_SPEED)] = [this](Event &e)
     { upgrade_max_speed(e); };
-    listeners[std::string(UPGRADE_CAR_STR) + " " + std::to_string(int(CarUpgrade::HANDLING_IMPROVEMENT))] = [this](Event &e)
+    listeners[index(InputAction::UPGRADE_HANDLING)] = [this](Event &e)
     { upgrade_handling(e); };
-    listeners[std::string(UPGRADE_CAR_STR) + " " + std::to_string(int(CarUpgrade::DURABILITY_ENHANCEMENT))] = [this](Event &e)
+    listeners[index(InputAction::UPGRADE_DURABILITY)] = [this](Event &e)
     { upgrade_durability(e); };
-    listeners[CHEAT_GOD_MODE_STR] = [this](Event &e)
+    listeners[index(InputAction::CHEAT_GOD_MODE)] = [this](Event &e)
     { cheat_god_mode(e); };
-    listeners[CHEAT_DIE_STR] = [this](Event &e)
+    listeners[index(InputAction::CHEAT_DIE)] = [this](Event &e)
     { cheat_die(e); };
-    listeners[CHEAT_SKIP_LAP_STR] = [this](Event &e)
+    listeners[index(InputAction::CHEAT_SKIP_LAP)] = [this](Event &e)
     { cheat_skip_round(e); };
-    listeners[CHEAT_FULL_UPGRADE_STR] = [this](Event &e)
+    listeners[index(InputAction::CHEAT_FULL_UPGRADE)] = [this](Event &e)
     { cheat_full_upgrade(e); };
 }
 
-void GameEventHandler::move_up(Event &event)
+size_t GameEventHandler::index(InputAction action)
 {
-    if (current_state != GameState::PLAYING)
-    {
-        return;
-    }
-    std::lock_guard<std::mutex> lock(players_map_mutex);
-    players[event.client_id].position.direction_y = up;
-    players[event.client_id].state = event.action;
+    return static_cast<size_t>(action);
 }
 
-void GameEventHandler::move_up_released(Event &event)
+void GameEventHandler::handle_batch(std::vector<Event> &events)
 {
-    if (current_state != GameState::PLAYING)
+    if (events.empty())
     {
         return;
     }
     std::lock_guard<std::mutex> lock(players_map_mutex);
-    if (players[event.client_id].state != MOVE_DOWN_PRESSED_STR)
+    for (auto &event : events)
     {
-        players[event.client_id].position.direction_y = not_vertical;
-        players[event.client_id].state = event.action;
+        try
+        {
+            apply(event);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "[GameEventHandler] Error procesando evento: " << e.what() << std::endl;
+        }
     }
+    flush_moves();
 }
 
-void GameEventHandler::move_down(Event &event)
+void GameEventHandler::apply(Event &event)
 {
-    if (current_state != GameState::PLAYING)
+    size_t i = index(event.input.action);
+    if (i >= listeners.size())
     {
         return;
     }
-    std::lock_guard<std::mutex> lock(players_map_mutex);
-    players[event.client_id].position.direction_y = down;
-    players[event.client_id].state = event.action;
+    if (move_listeners[i])
+    {
+        fold_move(event, move_listeners[i]);
+    }
+    else if (listeners[i])
+    {
+        listeners[i](event);
+    }
 }
 
-void GameEventHandler::move_down_released(Event &event)
+void GameEventHandler::fold_move(Event &event, const std::function<void(PendingMove &)> &transition)
 {
     if (current_state != GameState::PLAYING)
     {
         return;
     }
-    std::lock_guard<std::mutex> lock(players_map_mutex);
-    if (players[event.client_id].state != MOVE_UP_PRESSED_STR)
+    auto pending = pending_moves.find(event.client_id);
+    if (pending == pending_moves.end())
     {
-        players[event.client_id].position.direction_y = not_vertical;
-        players[event.client_id].state = event.action;
+        PlayerData *player = players.find(event.client_id);
+        if (!player)
+        {
+            return;
+        }
+        pending = pending_moves.emplace(event.client_id,
+                                        PendingMove{player, player->position.direction_x,
+                                                    player->position.direction_y, player->state})
+                      .first;
     }
+    transition(pending->second);
 }
 
-void GameEventHandler::move_left(Event &event)
+void GameEventHandler::flush_moves()
 {
-    if (current_state != GameState::PLAYING)
+    // Un press y su release dentro del mismo tick quedan plegados: el jugador
+    // recibe solo el resultado neto, igual que si se aplicaran de a uno
+    for (auto &[client_id, move] : pending_moves)
     {
-        return;
+        move.player->position.direction_x = move.direction_x;
+        move.player->position.direction_y = move.direction_y;
+        move.player->state = move.state;
     }
-    std::lock_guard<std::mutex> lock(players_map_mutex);
-    players[event.client_id].position.direction_x = left;
-    players[event.client_id].state = event.action;
+    pending_moves.clear();
 }
 
-void GameEventHandler::move_left_released(Event &event)
+void GameEventHandler::move_up(PendingMove &move)
 {
-    if (current_state != GameState::PLAYING)
-    {
-        return;
-    }
-    std::lock_guard<std::mutex> lock(players_map_mutex);
-    if (players[event.client_id].state != MOVE_RIGHT_PRESSED_STR)
+    move.direction_y = up;
+    move.state = InputAction::MOVE_UP_PRESSED;
+}
+
+void GameEventHandler::move_up_released(PendingMove &move)
+{
+    if (move.state != InputAction::MOVE_DOWN_PRESSED)
     {
-        players[event.client_id].position.direction_x = not_horizontal;
-        players[event.client_id].state = event.action;
+        move.direction_y = not_vertical;
+        move.state = InputAction::MOVE_UP_RELEASED;
     }
 }
 
-void GameEventHandler::move_right(Event &event)
+void GameEventHandler::move_down(PendingMove &move)
 {
-    if (current_state != GameState::PLAYING)
+    move.direction_y = down;
+    move.state = InputAction::MOVE_DOWN_PRESSED;
+}
+
+void GameEventHandler::move_down_released(PendingMove &move)
+{
+    if (move.state != InputAction::MOVE_UP_PRESSED)
     {
-        return;
+        move.direction_y = not_vertical;
+        move.state = InputAction::MOVE_DOWN_RELEASED;
     }
-    std::lock_guard<std::mutex> lock(players_map_mutex);
-    players[event.client_id].position.direction_x = right;
-    players[event.client_id].state = event.action;
 }
 
-void GameEventHandler::move_right_released(Event &event)
+void GameEventHandler::move_left(PendingMove &move)
 {
-    if (current_state != GameState::PLAYING)
+    move.direction_x = left;
+    move.state = InputAction::MOVE_LEFT_PRESSED;
+}
+
+void GameEventHandler::move_left_released(PendingMove &move)
+{
+    if (move.state != InputAction::MOVE_RIGHT_PRESSED)
     {
-        return;
+        move.direction_x = not_horizontal;
+        move.state = InputAction::MOVE_LEFT_RELEASED;
     }
-    std::lock_guard<std::mutex> lock(players_map_mutex);
-    if (players[event.client_id].state != MOVE_LEFT_PRESSED_STR)
+}
+
+void GameEventHandler::move_right(PendingMove &move)
+{
+    move.direction_x = right;
+    move.state = InputAction::MOVE_RIGHT_PRESSED;
+}
+
+void GameEventHandler::move_right_released(PendingMove &move)
+{
+    if (move.state != InputAction::MOVE_LEFT_PRESSED)
     {
-        players[event.client_id].position.direction_x = not_horizontal;
-        players[event.client_id].state = event.action;
+        move.direction_x = not_horizontal;
+        move.state = InputAction::MOVE_RIGHT_RELEASED;
     }
 }
-void GameEventHandler::select_car(Event &event, const std::string &car_type)
+
+void GameEventHandler::select_car(Event &event)
 {
-    if (current_state != GameState::LOBBY)
+    if (current_state != GameState::LOBBY || event.input.arg >= CAR_TYPES_COUNT)
     {
         return;
     }
-    std::lock_guard<std::mutex> lock(players_map_mutex);
-    auto it = players.find(event.client_id);
-    if (it == players.end())
+    const std::string car_type = CAR_TYPES[event.input.arg];
+    PlayerData *player = players.find(event.client_id);
+    if (!player)
     {
         return;
     }
     const CarPhysics &phys = CarPhysicsConfig::getInstance().getCarPhysics(car_type);
-    it->second.car.car_name = car_type;
+    player->car.physics = &phys;
+    players.find_record(event.client_id)->car_name = car_type;
 
-    it->second.car.speed = phys.max_speed;
-    it->second.car.acceleration = phys.max_acceleration;
-    it->second.car.hp = phys.max_hp;
-    it->second.car.durability = phys.collision_damage_multiplier;
-    it->second.car.handling = phys.torque;
+    player->car.speed = phys.max_speed;
+    player->car.acceleration = phys.max_acceleration;
+    player->car.hp = phys.max_hp;
+    player->car.durability = phys.collision_damage_multiplier;
+    player->car.handling = phys.torque;
 
-    b2Body *oldBody = it->second.body;
+    b2Body *oldBody = player->body;
     if (oldBody)
     {
         b2World *world = oldBody->GetWorld();
@@ -191,6 +212,7 @@ void GameEventHandler::select_car(Event &event, const std::string &car_type)
         bd.position = prevPos;
         bd.angle = prevAngle;
         b2Body *newBody = world->CreateBody(&bd);
+        EntityTag::set(newBody, EntityKind::PLAYER, event.client_id);
 
         const float SCALE_LOCAL = 32.0f;
         float halfW = phys.width / (2.0f * SCALE_LOCAL);
@@ -221,18 +243,9 @@ void GameEventHandler::select_car(Event &event, const std::string &car_type)
         newBody->SetLinearVelocity(prevLinearVel);
         newBody->SetAngularVelocity(prevAngularVel);
 
-        it->second.body = newBody;
+        player->body = newBody;
     }
 }
-void GameEventHandler::handle_event(Event &event)
-{
-    auto it = listeners.find(event.action);
-    if (it != listeners.end())
-    {
-        it->second(event);
-    }
-}
-
 void GameEventHandler::upgrade_max_speed(Event &event)
 {
     if (current_state != GameState::STARTING)
@@ -240,23 +253,23 @@ void GameEventHandler::upgrade_max_speed(Event &event)
         return;
     }
 
-    std::lock_guard<std::mutex> lock(players_map_mutex);
-    auto it = players.find(event.client_id);
-    int rounds = it->second.rounds_completed;
-    if (it == players.end() || rounds == 0 || it->second.upgrades.speed >= MAX_UPGRADES_PER_STAT)
+    PlayerData *player = players.find(event.client_id);
+    PlayerRecord *record = players.find_record(event.client_id);
+    if (!player || player->rounds_completed == 0 || record->upgrades.speed >= MAX_UPGRADES_PER_STAT)
     {
         return;
     }
+    int rounds = player->rounds_completed;
 
-    it->second.car.speed *= SPEED_UPGRADE_MULTIPLIER;
-    it->second.upgrades.speed++;
-    uint32_t old_time = it->second.round_times_ms[rounds];
+    player->car.speed *= SPEED_UPGRADE_MULTIPLIER;
+    record->upgrades.speed++;
+    uint32_t old_time = record->round_times_ms[rounds];
 
     uint64_t penalization = uint64_t(PENALIZATION_TIME) + uint64_t(old_time);
 
-    it->second.round_times_ms[rounds] = uint32_t(penalization);
+    record->round_times_ms[rounds] = uint32_t(penalization);
 
-    it->second.total_time_ms = it->second.total_time_ms - old_time + uint32_t(penalization);
+    record->total_time_ms = record->total_time_ms - old_time + uint32_t(penalization);
 }
 
 void GameEventHandler::upgrade_max_acceleration(Event &event)
@@ -266,20 +279,20 @@ void GameEventHandler::upgrade_max_acceleration(Event &event)
         return;
     }
 
-    std::lock_guard<std::mutex> lock(players_map_mutex);
-    auto it = players.find(event.client_id);
-    int rounds = it->second.rounds_completed;
-    if (it == players.end() || rounds == 0 || it->second.upgrades.acceleration >= MAX_UPGRADES_PER_STAT)
+    PlayerData *player = players.find(event.client_id);
+    PlayerRecord *record = players.find_record(event.client_id);
+    if (!player || player->rounds_completed == 0 || record->upgrades.acceleration >= MAX_UPGRADES_PER_STAT)
     {
         return;
     }
-    it->second.car.acceleration *= ACCELERATION_UPGRADE_MULTIPLIER;
-    it->second.upgrades.acceleration++;
-    uint32_t old_time = it->second.round_times_ms[rounds];
+    int rounds = player->rounds_completed;
+    player->car.acceleration *= ACCELERATION_UPGRADE_MULTIPLIER;
+    record->upgrades.acceleration++;
+    uint32_t old_time = record->round_times_ms[rounds];
     uint64_t penalization = uint64_t(PENALIZATION_TIME) + uint64_t(old_time);
-    it->second.round_times_ms[rounds] = uint32_t(penalization);
+    record->round_times_ms[rounds] = uint32_t(penalization);
 
-    it->second.total_time_ms = it->second.total_time_ms - old_time + uint32_t(penalization);
+    record->total_time_ms = record->total_time_ms - old_time + uint32_t(penalization);
 }
 
 void GameEventHandler::upgrade_durability(Event &event)
@@ -287,21 +300,21 @@ void GameEventHandler::upgrade_durability(Event &event)
     if (current_state != GameState::STARTING)
         return;
 
-    std::lock_guard<std::mutex> lock(players_map_mutex);
-    auto it = players.find(event.client_id);
-    int rounds = it->second.rounds_completed;
-    if (it == players.end() || rounds == 0 || it->second.upgrades.durability >= MAX_UPGRADES_PER_STAT)
+    PlayerData *player = players.find(event.client_id);
+    PlayerRecord *record = players.find_record(event.client_id);
+    if (!player || player->rounds_completed == 0 || record->upgrades.durability >= MAX_UPGRADES_PER_STAT)
     {
         return;
     }
+    int rounds = player->rounds_completed;
 
-    it->second.car.durability -= DURABILITY_UPGRADE_REDUCTION;
-    it->second.upgrades.durability++;
+    player->car.durability -= DURABILITY_UPGRADE_REDUCTION;
+    record->upgrades.durability++;
 
-    uint32_t old_time = it->second.round_times_ms[rounds];
+    uint32_t old_time = record->round_times_ms[rounds];
     uint64_t penalization = uint64_t(PENALIZATION_TIME) + uint64_t(old_time);
-    it->second.round_times_ms[rounds] = uint32_t(penalization);
-    it->second.total_time_ms = it->second.total_time_ms - old_time + uint32_t(penalization);
+    record->round_times_ms[rounds] = uint32_t(penalization);
+    record->total_time_ms = record->total_time_ms - old_time + uint32_t(penalization);
 }
 
 void GameEventHandler::upgrade_handling(Event &event)
@@ -312,86 +325,83 @@ void GameEventHandler::upgrade_handling(Event &event)
         return;
     }
 
-    std::lock_guard<std::mutex> lock(players_map_mutex);
-    auto it = players.find(event.client_id);
-    int rounds = it->second.rounds_completed;
-    if (it == players.end() || rounds == 0 || it->second.upgrades.handling >= MAX_UPGRADES_PER_STAT)
+    PlayerData *player = players.find(event.client_id);
+    PlayerRecord *record = players.find_record(event.client_id);
+    if (!player || player->rounds_completed == 0 || record->upgrades.handling >= MAX_UPGRADES_PER_STAT)
     {
         return;
     }
-    it->second.car.handling *= HANDLING_UPGRADE_MULTIPLIER;
-    it->second.upgrades.handling++;
+    int rounds = player->rounds_completed;
+    player->car.handling *= HANDLING_UPGRADE_MULTIPLIER;
+    record->upgrades.handling++;
 
-    uint32_t old_time = it->second.round_times_ms[rounds];
+    uint32_t old_time = record->round_times_ms[rounds];
     uint64_t penalization = uint64_t(PENALIZATION_TIME) + uint64_t(old_time);
-    it->second.round_times_ms[rounds] = uint32_t(penalization);
+    record->round_times_ms[rounds] = uint32_t(penalization);
 
-    it->second.total_time_ms = it->second.total_time_ms - old_time + uint32_t(penalization);
+    record->total_time_ms = record->total_time_ms - old_time + uint32_t(penalization);
 }
 
 void GameEventHandler::cheat_god_mode(Event &event)
 {
-    std::lock_guard<std::mutex> lock(players_map_mutex);
-    auto it = players.find(event.client_id);
-    if (it == players.end())
+    PlayerData *player = players.find(event.client_id);
+    if (!player)
     {
         return;
     }
 
-    it->second.god_mode = !it->second.god_mode;
+    player->god_mode = !player->god_mode;
 }
 
 void GameEventHandler::cheat_die(Event &event)
 {
-    std::lock_guard<std::mutex> lock(players_map_mutex);
-    auto it = players.find(event.client_id);
-    if (it == players.end())
+    PlayerData *player = players.find(event.client_id);
+    if (!player)
     {
         return;
     }
 
-    it->second.pending_disqualification = true;
-    it->second.god_mode = false;
+    player->pending_disqualification = true;
+    player->god_mode = false;
 }
 
 void GameEventHandler::cheat_skip_round(Event &event)
 {
-    std::lock_guard<std::mutex> lock(players_map_mutex);
-    auto it = players.find(event.client_id);
-    if (it == players.end())
+    PlayerData *player = players.find(event.client_id);
+    if (!player)
     {
         return;
     }
-    it->second.pending_race_complete = true;
+    player->pending_race_complete = true;
 }
 
 void GameEventHandler::cheat_full_upgrade(Event &event)
 {
-    std::lock_guard<std::mutex> lock(players_map_mutex);
-    auto it = players.find(event.client_id);
-    if (it == players.end())
+    PlayerData *player = players.find(event.client_id);
+    PlayerRecord *record = players.find_record(event.client_id);
+    if (!player)
     {
         return;
     }
 
-    while (it->second.upgrades.speed < MAX_UPGRADES_PER_STAT)
+    while (record->upgrades.speed < MAX_UPGRADES_PER_STAT)
     {
-        it->second.car.speed *= SPEED_UPGRADE_MULTIPLIER;
-        it->second.upgrades.speed++;
+        player->car.speed *= SPEED_UPGRADE_MULTIPLIER;
+        record->upgrades.speed++;
     }
-    while (it->second.upgrades.acceleration < MAX_UPGRADES_PER_STAT)
+    while (record->upgrades.acceleration < MAX_UPGRADES_PER_STAT)
     {
-        it->second.car.acceleration *= ACCELERATION_UPGRADE_MULTIPLIER;
-        it->second.upgrades.acceleration++;
+        player->car.acceleration *= ACCELERATION_UPGRADE_MULTIPLIER;
+        record->upgrades.acceleration++;
     }
-    while (it->second.upgrades.handling < MAX_UPGRADES_PER_STAT)
+    while (record->upgrades.handling < MAX_UPGRADES_PER_STAT)
     {
-        it->second.car.handling *= HANDLING_UPGRADE_MULTIPLIER;
-        it->second.upgrades.handling++;
+        player->car.handling *= HANDLING_UPGRADE_MULTIPLIER;
+        record->upgrades.handling++;
     }
-    while (it->second.upgrades.durability < MAX_UPGRADES_PER_STAT)
+    while (record->upgrades.durability < MAX_UPGRADES_PER_STAT)
     {
-        it->second.car.durability -= DURABILITY_UPGRADE_REDUCTION;
-        it->second.upgrades.durability++;
+        player->car.durability -= DURABILITY_UPGRADE_REDUCTION;
+        record->upgrades.durability++;
     }
 }
\ No newline at end of file
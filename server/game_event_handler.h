@@ -2,33 +2,54 @@
 #define GAME_EVENT_HANDLER_H
 
 #include <iostream>
+#include <array>
 #include <unordered_map>
 #include <functional>
 #include <mutex>
+#include <vector>
 #include "event.h"
 #include "../common/constants.h"
-#include "PlayerData.h"
+#include "player_store.h"
 #include "car_physics_config.h"
 #include "game_state.h"
 
 class GameEventHandler
 {
 private:
-    std::unordered_map<std::string, std::function<void(Event &)>> listeners;
+    // Movimiento de un jugador mientras se procesa un lote: los press/release
+    // del mismo cliente se pliegan acá y se escriben una sola vez al final
+    struct PendingMove
+    {
+        PlayerData *player;
+        MovementDirectionX direction_x;
+        MovementDirectionY direction_y;
+        InputAction state;
+    };
+
+    // Indexados por InputAction: despachar un evento no hashea ni aloca
+    std::array<std::function<void(PendingMove &)>, static_cast<size_t>(InputAction::COUNT)> move_listeners;
+    std::array<std::function<void(Event &)>, static_cast<size_t>(InputAction::COUNT)> listeners;
     std::mutex &players_map_mutex;
-    std::unordered_map<int, PlayerData> &players;
+    PlayerStore &players;
+    std::unordered_map<int, PendingMove> pending_moves;
     GameState current_state{GameState::LOBBY};
 
     void init_handlers();
+    static size_t index(InputAction action);
+
+    // Requieren players_map_mutex tomado
+    void apply(Event &event);
+    void fold_move(Event &event, const std::function<void(PendingMove &)> &transition);
+    void flush_moves();
 
-    void move_up(Event &event);
-    void move_up_released(Event &event);
-    void move_down(Event &event);
-    void move_down_released(Event &event);
-    void move_left(Event &event);
-    void move_left_released(Event &event);
-    void move_right(Event &event);
-    void move_right_released(Event &event);
+    static void move_up(PendingMove &move);
+    static void move_up_released(PendingMove &move);
+    static void move_down(PendingMove &move);
+    static void move_down_released(PendingMove &move);
+    static void move_left(PendingMove &move);
+    static void move_left_released(PendingMove &move);
+    static void move_right(PendingMove &move);
+    static void move_right_released(PendingMove &move);
 
     void upgrade_max_speed(Event &event);
     void upgrade_max_acceleration(Event &event);
@@ -40,16 +61,18 @@ private:
     void cheat_skip_round(Event &event);
     void cheat_full_upgrade(Event &event);
 
-    void select_car(Event &event, const std::string &car_type);
+    void select_car(Event &event);
 
 public:
-    GameEventHandler(std::mutex &map_mutex, std::unordered_map<int, PlayerData> &map) : players_map_mutex(map_mutex), players(map)
+    GameEventHandler(std::mutex &map_mutex, PlayerStore &map)
+        : move_listeners(), listeners(), players_map_mutex(map_mutex), players(map), pending_moves()
     {
         init_handlers();
     }
 
     inline void set_game_state(GameState s) { current_state = s; }
-    void handle_event(Event &event);
+    // Aplica todo el lote con una sola toma de players_map_mutex
+    void handle_batch(std::vector<Event> &events);
 };
 
 #endif
\ No newline at end of file
@@ -1,18 +1,35 @@
 #include "game_monitor.h"
+#include "server_config.h"
+#include "install_paths.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
 #define OUTBOX_NOT_FOUND "Outbox not found for creator client"
 #define GAME_NOT_FOUND "Game not found"
 #define GAME_DEFAULT_NAME "Game "
+// Eventos pendientes por partida antes de descartar inputs nuevos
+#define GAME_EVENTS_CAPACITY 4096
 GameMonitor::GameMonitor()
-    : games(), games_queues(), game_names(), game_maps(), games_mutex(), next_id(STARTING_ID)
+    : games(), games_queues(), game_names(), game_maps(), games_mutex(), next_id(STARTING_ID), scheduler(load_server_config().getMatchWorkers())
 {
 }
 
-int GameMonitor::add_game(int client_id, std::shared_ptr<Queue<ServerMessage>> player_outbox, const std::string &name, uint8_t map_id)
+ServerConfig &GameMonitor::load_server_config()
+{
+    ServerConfig &config = ServerConfig::getInstance();
+    if (!config.loadFromFile(std::string(CONFIG_DIR) + "/server.yaml"))
+    {
+        std::cerr << "[GameMonitor] WARNING: Failed to load server config, using defaults" << std::endl;
+    }
+    return config;
+}
+
+int GameMonitor::add_game(int client_id, std::shared_ptr<Outbox> player_outbox, const std::string &name, uint8_t map_id)
 {
     std::lock_guard<std::mutex> lock(games_mutex);
 
     int game_id = next_id++;
-    auto new_queue = std::make_shared<Queue<Event>>();
+    auto new_queue = std::make_shared<EventQueue>(GAME_EVENTS_CAPACITY);
     games_queues[game_id] = new_queue;
 
     auto new_game = std::make_unique<GameLoop>(new_queue, map_id);
@@ -22,7 +39,7 @@ int GameMonitor::add_game(int client_id, std::shared_ptr<Queue<ServerMessage>> p
         throw std::runtime_error(OUTBOX_NOT_FOUND);
     }
     new_game->add_player(client_id, player_outbox);
-    new_game->start();
+    scheduler.add_match(new_game.get());
 
     games[game_id] = std::move(new_game);
     game_names[game_id] = name.empty() ? (std::string{GAME_DEFAULT_NAME} + std::to_string(game_id)) : name;
@@ -58,7 +75,7 @@ std::vector<ServerMessage::GameSummary> GameMonitor::list_games()
     return result;
 }
 
-void GameMonitor::join_player(int player_id, int game_id, std::shared_ptr<Queue<ServerMessage>> player_outbox)
+void GameMonitor::join_player(int player_id, int game_id, std::shared_ptr<Outbox> player_outbox)
 {
     std::lock_guard<std::mutex> lock(games_mutex);
     auto it = games.find(game_id);
@@ -81,12 +98,41 @@ void GameMonitor::remove_player(int client_id)
         if (game && game->has_player(client_id))
         {
             game->remove_player(client_id);
-            return;
+            break;
+        }
+    }
+
+    // La partida pudo haberlo sacado antes (cliente lento o que cerró su
+    // outbox): se revisan todas, no solo la que lo tenía
+    for (auto it = games.begin(); it != games.end();)
+    {
+        if (it->second && it->second->get_player_count() == 0)
+        {
+            // Sin jugadores la partida no sigue corriendo: se saca del pool antes de destruirla
+            scheduler.remove_match(it->second.get());
+            games_queues.erase(it->first);
+            game_names.erase(it->first);
+            game_maps.erase(it->first);
+            it = games.erase(it);
         }
+        else
+            ++it;
+    }
+}
+
+bool GameMonitor::start_game(int game_id)
+{
+    std::lock_guard<std::mutex> lock(games_mutex);
+    auto it = games.find(game_id);
+    if (it == games.end() || !it->second)
+    {
+        return false;
     }
+    it->second->start_game();
+    return true;
 }
 
-std::shared_ptr<Queue<Event>> GameMonitor::get_game_queue(int game_id)
+std::shared_ptr<EventQueue> GameMonitor::get_game_queue(int game_id)
 {
     std::lock_guard<std::mutex> lock(games_mutex);
     auto it = games_queues.find(game_id);
@@ -119,12 +165,82 @@ uint8_t GameMonitor::get_game_map_id(int game_id)
     return 0;
 }
 
-GameMonitor::~GameMonitor()
+bool GameMonitor::set_snapshot_rate(int game_id, int snapshot_rate_hz)
+{
+    std::lock_guard<std::mutex> lock(games_mutex);
+    auto it = games.find(game_id);
+    if (it == games.end() || !it->second)
+    {
+        return false;
+    }
+    it->second->set_snapshot_rate(snapshot_rate_hz);
+    return true;
+}
+
+void GameMonitor::print_stats(std::ostream &out)
+{
+    std::lock_guard<std::mutex> lock(games_mutex);
+    if (games.empty())
+    {
+        out << "No hay partidas" << std::endl;
+        return;
+    }
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    for (auto &[game_id, game] : games)
+    {
+        if (!game)
+            continue;
+        TickStats ticks = game->get_tick_stats();
+        TickProfiler::Report profile = game->get_profile();
+        out << "Partida " << game_id << " (" << game_names[game_id] << "): " << ticks.ticks << " ticks, "
+            << std::fixed << std::setprecision(3) << "trabajo prom " << ticks.avg_work_ms << " ms, max "
+            << ticks.max_work_ms << " ms, " << ticks.missed_deadlines << " deadlines perdidos, "
+            << game->get_snapshot_rate() << " snapshots/s" << std::endl;
+        for (size_t p = 0; p < TickProfiler::PHASES; ++p)
+        {
+            const TickProfiler::PhaseStats &phase = profile.phases[p];
+            if (phase.count == 0)
+                continue;
+            out << "  " << std::left << std::setw(14) << TickProfiler::phase_name(static_cast<TickPhase>(p))
+                << std::right << " n=" << phase.count << " prom " << phase.total_us / phase.count
+                << " us, p50 <" << phase.p50_us << " us, p99 <" << phase.p99_us << " us, max "
+                << phase.max_us << " us" << std::endl;
+        }
+        out << "  codificado: " << profile.encoded_bytes << " bytes en " << profile.encoded_frames
+            << " frames, " << profile.slow_disconnects << " clientes desconectados por lentos" << std::endl;
+        for (const GameLoop::OutboxStats &outbox : game->get_outbox_stats())
+        {
+            out << "  outbox " << outbox.player_id << ": " << outbox.pending << " pendientes, "
+                << outbox.replaced_snapshots << " snapshots pisados, atraso " << outbox.snapshot_lag_ms
+                << " ms" << std::endl;
+        }
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+bool GameMonitor::write_trace(const std::string &path)
 {
+    std::ofstream file(path);
+    if (!file)
+    {
+        return false;
+    }
     std::lock_guard<std::mutex> lock(games_mutex);
-    for (auto &[id, game] : games)
+    file << "{\"traceEvents\":[\n";
+    bool first = true;
+    for (auto &[game_id, game] : games)
     {
-        game->stop();
-        game->join();
+        if (game)
+            game->write_trace_events(file, game_id, first);
     }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+GameMonitor::~GameMonitor()
+{
+    // Frenar los workers antes de destruir las partidas
+    scheduler.stop();
 }
\ No newline at end of file
@@ -4,28 +4,43 @@
 #include <memory>
 #include <string>
 #include "gameloop.h"
+#include "match_scheduler.h"
+#include "server_config.h"
 #include <mutex>
+#include <ostream>
 #define STARTING_ID 1
 class GameMonitor
 {
 private:
     std::unordered_map<int, std::unique_ptr<GameLoop>> games;
-    std::unordered_map<int, std::shared_ptr<Queue<Event>>> games_queues;
+    std::unordered_map<int, std::shared_ptr<EventQueue>> games_queues;
     std::unordered_map<int, std::string> game_names;
     std::unordered_map<int, uint8_t> game_maps;
     std::mutex games_mutex;
     int next_id;
+    // Workers que corren los ticks de todas las partidas
+    MatchScheduler scheduler;
+
+    static ServerConfig &load_server_config();
 
 public:
     ~GameMonitor();
     explicit GameMonitor();
-    int add_game(int client_id, std::shared_ptr<Queue<ServerMessage>> player_outbox, const std::string &name = "", uint8_t map_id = 0); // Devuelve el game_id asignado
-    void join_player(int player_id, int game_id, std::shared_ptr<Queue<ServerMessage>> player_outbox);
-    void remove_player(int client_id);  // Remueve al jugador de cualquier partida donde esté
+    int add_game(int client_id, std::shared_ptr<Outbox> player_outbox, const std::string &name = "", uint8_t map_id = 0); // Devuelve el game_id asignado
+    void join_player(int player_id, int game_id, std::shared_ptr<Outbox> player_outbox);
+    void remove_player(int client_id);  // Remueve al jugador de cualquier partida donde esté; la partida que queda vacía se destruye
+    bool start_game(int game_id);       // false si la partida no existe
     std::vector<ServerMessage::GameSummary> list_games();
+    // El puntero deja de ser válido cuando la partida se queda sin jugadores
     GameLoop *get_game(int game_id);
-    std::shared_ptr<Queue<Event>> get_game_queue(int game_id);
+    std::shared_ptr<EventQueue> get_game_queue(int game_id);
     uint8_t get_game_map_id(int game_id);
+    // Cambia los snapshots por segundo de una partida; false si no existe
+    bool set_snapshot_rate(int game_id, int snapshot_rate_hz);
+    // Tiempos por fase, bytes codificados y outboxes de cada partida (consola)
+    void print_stats(std::ostream &out);
+    // Vuelca las últimas fases de todas las partidas como trace de Chrome
+    bool write_trace(const std::string &path);
 };
 
 #endif
\ No newline at end of file
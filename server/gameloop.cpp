@@ -1,14 +1,13 @@
 #include "gameloop.h"
 #include "../common/constants.h"
+#include "server_config.h"
+#include <algorithm>
 #include <thread>
 #include <chrono>
 #include <iostream>
 
-void GameLoop::run()
+void GameLoop::init()
 {
-    auto last_tick = std::chrono::steady_clock::now();
-    float acum = 0.0f;
-
     state_manager.set_on_starting_callback([this]() {
         ServerMessage msg;
         msg.opcode = STARTING_COUNTDOWN;
@@ -20,30 +19,56 @@ void GameLoop::run()
 
     setup_manager.setup_world(current_round);
 
-    while (should_keep_running())
+    last_tick = std::chrono::steady_clock::now();
+    tick_scheduler.start();
+}
+
+void GameLoop::tick()
+{
+    tick_scheduler.begin_tick();
+    process_tick();
+    tick_scheduler.end_tick();
+}
+
+TickScheduler::clock::time_point GameLoop::next_tick_deadline() const
+{
+    return tick_scheduler.next_deadline();
+}
+
+void GameLoop::process_tick()
+{
+    try
     {
-        try
+        state_manager.check_and_finish_starting();
         {
-            state_manager.check_and_finish_starting();
+            TickProfiler::Scope phase(profiler, TickPhase::EVENTS);
             event_loop.process_available_events(state_manager.get_state());
+        }
 
-            auto now = std::chrono::steady_clock::now();
-            float dt = std::chrono::duration<float>(now - last_tick).count();
-            last_tick = now;
-            acum += dt;
+        auto now = std::chrono::steady_clock::now();
+        float dt = std::chrono::duration<float>(now - last_tick).count();
+        last_tick = now;
+        // Acotar lo que se recupera para no entrar en una espiral de pasos de física
+        acum = std::min(acum + dt, tick_scheduler.max_catchup_seconds());
 
-            tick_processor.process(state_manager.get_state(), acum);
-            perform_race_reset();
-        }
-        catch (const ClosedQueue &)
-        {
-        }
-        catch (const std::exception &e)
-        {
-            std::cerr << "[GameLoop] Unexpected exception: " << e.what() << std::endl;
-        }
+        tick_processor.process(state_manager.get_state(), acum);
+        perform_race_reset();
+        remove_disconnected_players();
+    }
+    catch (const ClosedQueue &)
+    {
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "[GameLoop] Unexpected exception: " << e.what() << std::endl;
+    }
+}
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+void GameLoop::remove_disconnected_players()
+{
+    for (int id : broadcast_manager.take_disconnected())
+    {
+        remove_player(id);
     }
 }
 
@@ -91,9 +116,9 @@ void GameLoop::advance_round_or_reset_to_lobby()
         totals.opcode = TOTAL_TIMES;
         {
             std::lock_guard<std::mutex> lk(players_map_mutex);
-            for (auto &entry : players)
+            for (auto [id, player_data, record] : players)
             {
-                totals.total_times.push_back({static_cast<uint32_t>(entry.first), entry.second.total_time_ms});
+                totals.total_times.push_back({static_cast<uint32_t>(id), record.total_time_ms});
             }
         }
         broadcast_manager.broadcast(totals);
@@ -108,36 +133,32 @@ void GameLoop::advance_round_or_reset_to_lobby()
 }
 
 // Constructor para poder setear el contact listener del world
-GameLoop::GameLoop(std::shared_ptr<Queue<Event>> events, uint8_t map_id_param)
-    : world_manager(CarPhysicsConfig::getInstance()), players_map_mutex(), players(), players_messanger(), event_queue(events), event_loop(players_map_mutex, players, event_queue), started(false), state_manager(), next_id(INITIAL_ID), map_id(map_id_param), map_layout(world_manager.get_world()), npc_manager(world_manager.get_world()), physics_config(CarPhysicsConfig::getInstance()), player_manager(players_map_mutex, players, players_messanger, player_order, world_manager, physics_config), broadcast_manager(players_map_mutex, players, players_messanger), tick_processor(players_map_mutex, players, state_manager, player_manager, npc_manager, world_manager, broadcast_manager, checkpoint_centers), contact_handler(players_map_mutex, players, checkpoint_fixtures, checkpoint_centers, state_manager.get_pending_race_reset(), [this]() { return state_manager.get_state(); }), setup_manager(map_id, map_layout, world_manager, npc_manager, checkpoint_sets, spawn_points, checkpoint_fixtures, checkpoint_centers)
+GameLoop::GameLoop(std::shared_ptr<EventQueue> events, uint8_t map_id_param)
+    : world_manager(CarPhysicsConfig::getInstance()), players_map_mutex(), players(), players_messanger(), event_queue(events), event_loop(players_map_mutex, players, event_queue), started(false), state_manager(), next_id(INITIAL_ID), map_id(map_id_param), compiled_map(MapCache::getInstance().get(map_id_param)), map_layout(world_manager.get_world()), npc_manager(world_manager.get_world(), compiled_map->roads), physics_config(CarPhysicsConfig::getInstance()), player_manager(players_map_mutex, players, players_messanger, player_order, world_manager, physics_config), profiler(), broadcast_manager(players_map_mutex, players, players_messanger, profiler), interest_manager(), contact_handler(players_map_mutex, players, checkpoint_centers, state_manager.get_pending_race_reset(), [this]() { return state_manager.get_state(); }), tick_processor(players_map_mutex, players, state_manager, player_manager, npc_manager, world_manager, broadcast_manager, interest_manager, contact_handler, checkpoint_centers, profiler), setup_manager(*compiled_map, map_layout, world_manager, npc_manager, checkpoint_bodies, checkpoint_centers), tick_scheduler(ServerConfig::getInstance().getTickRateHz(), ServerConfig::getInstance().getMaxCatchupTicks())
 {
     if (!physics_config.loadFromFile(std::string(CONFIG_DIR) + "/car_physics.yaml"))
     {
         std::cerr << "[GameLoop] WARNING: Failed to load car physics config, using defaults" << std::endl;
     }
 
-    // Inicializar rutas según el mapa seleccionado
-    uint8_t safe_map_id = (map_id < MAP_COUNT) ? map_id : 0;
-    for (int i = 0; i < 3; ++i)
-    {
-        checkpoint_sets[i] = getMapCheckpointPath(safe_map_id, i);
-    }
-
-    // Cargar spawn points del mapa correspondiente
-    map_layout.extract_spawn_points(getMapSpawnPointsPath(safe_map_id), spawn_points);
+    // Spawn points del mapa correspondiente
+    spawn_points = compiled_map->spawn_points;
 
     // Configurar el callback de contacto
     world_manager.set_contact_callback([this](b2Fixture *a, b2Fixture *b) {
         this->contact_handler.handle_begin_contact(a, b);
     });
+    world_manager.set_end_contact_callback([this](b2Fixture *a, b2Fixture *b) {
+        this->contact_handler.handle_end_contact(a, b);
+    });
 }
 
 void GameLoop::on_playing_started()
 {
     auto race_start_time = std::chrono::steady_clock::now();
-    for (auto &[id, player_data] : players)
+    for (auto [id, player_data, record] : players)
     {
-        player_data.lap_start_time = race_start_time;
+        record.lap_start_time = race_start_time;
     }
     broadcast_manager.broadcast_game_started();
 }
@@ -160,7 +181,7 @@ void GameLoop::start_game()
             int total_players = static_cast<int>(players.size());
             int dead_count = 0;
 
-            for (const auto &[id, player_data] : players)
+            for (auto [id, player_data, record] : players)
             {
                 if (player_data.is_dead)
                 {
@@ -193,6 +214,46 @@ void GameLoop::start_game()
     started = true;
 }
 
+TickStats GameLoop::get_tick_stats() const
+{
+    return tick_scheduler.get_stats();
+}
+
+void GameLoop::set_snapshot_rate(int snapshot_rate_hz)
+{
+    tick_processor.set_snapshot_rate(snapshot_rate_hz);
+}
+
+int GameLoop::get_snapshot_rate() const
+{
+    return tick_processor.get_snapshot_rate();
+}
+
+TickProfiler::Report GameLoop::get_profile() const
+{
+    return profiler.report();
+}
+
+std::vector<GameLoop::OutboxStats> GameLoop::get_outbox_stats() const
+{
+    std::vector<OutboxStats> stats;
+    std::lock_guard<std::mutex> lk(players_map_mutex);
+    stats.reserve(players_messanger.size());
+    for (const auto &[id, outbox] : players_messanger)
+    {
+        if (!outbox)
+            continue;
+        double lag_ms = std::chrono::duration<double, std::milli>(outbox->snapshot_lag()).count();
+        stats.push_back({id, outbox->pending(), outbox->get_replaced_snapshots(), lag_ms});
+    }
+    return stats;
+}
+
+void GameLoop::write_trace_events(std::ostream &out, int tid, bool &first) const
+{
+    profiler.write_trace_events(out, tid, first);
+}
+
 size_t GameLoop::get_player_count() const
 {
     return player_manager.get_player_count();
@@ -208,7 +269,7 @@ bool GameLoop::is_joinable() const
     return state_manager.is_joinable();
 }
 
-void GameLoop::add_player(int id, std::shared_ptr<Queue<ServerMessage>> player_outbox)
+void GameLoop::add_player(int id, std::shared_ptr<Outbox> player_outbox)
 {
     player_manager.add_player(id, player_outbox, spawn_points);
 }
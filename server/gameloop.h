@@ -1,17 +1,18 @@
 #ifndef GAMELOOP_H
 #define GAMELOOP_H
-#include "../common/thread.h"
 #include <unordered_map>
 #include <array>
 #include <random>
 #include "eventloop.h"
-#include "PlayerData.h"
+#include "player_store.h"
 #include "../common/messages.h"
 #include "client_handler_msg.h"
 #include <box2d/b2_world.h>
 #include <box2d/b2_polygon_shape.h>
 #include <box2d/b2_fixture.h>
 #include "map_layout.h"
+#include "map_cache.h"
+#include "match_scheduler.h"
 #include "car_physics_config.h"
 #include <atomic>
 #include <chrono>
@@ -25,19 +26,24 @@
 #include "gameloop/player/player_manager.h"
 #include "gameloop/state/game_state_manager.h"
 #include "gameloop/broadcast/broadcast_manager.h"
+#include "gameloop/interest/interest_manager.h"
 #include "gameloop/tick/tick_processor.h"
+#include "gameloop/tick/tick_scheduler.h"
+#include "gameloop/tick/tick_profiler.h"
 #include "gameloop/contact/contact_handler.h"
 #include "gameloop/setup/setup_manager.h"
 #define INITIAL_ID 1
 
-class GameLoop : public Thread
+// Una partida. No tiene thread propio: el MatchScheduler llama a init() una
+// vez y después a tick() en cada next_tick_deadline().
+class GameLoop : public ScheduledMatch
 {
 private:
     WorldManager world_manager;
     mutable std::mutex players_map_mutex;
-    std::unordered_map<int, PlayerData> players;
-    std::unordered_map<int, std::shared_ptr<Queue<ServerMessage>>> players_messanger;
-    std::shared_ptr<Queue<Event>> event_queue;
+    PlayerStore players;
+    std::unordered_map<int, std::shared_ptr<Outbox>> players_messanger;
+    std::shared_ptr<EventQueue> event_queue;
     EventLoop event_loop;
     bool started;
     GameStateManager state_manager;
@@ -66,31 +72,46 @@ private:
     std::vector<int> player_order; // IDs de jugadores en orden de llegada
 
     uint8_t map_id{0}; // 0=LibertyCity, 1=SanAndreas, 2=ViceCity
+    // Datos del mapa (colisiones, NPCs, spawns y recorridos), compartidos con
+    // las demás partidas del mismo mapa
+    std::shared_ptr<const CompiledMap> compiled_map;
 
     MapLayout map_layout;
-    // Mapa de fixtures de checkpoints a sus índices
-    std::unordered_map<b2Fixture *, int> checkpoint_fixtures;
+    // Bodies de los checkpoints de la ronda (cada uno etiquetado con su índice)
+    std::vector<b2Body *> checkpoint_bodies;
     // Centros de los checkpoints en metros del mundo, indexados por índice de checkpoint
     std::vector<b2Vec2> checkpoint_centers;
 
     // ----- Multi-race support (3 carreras en mismo mapa con distintos recorridos) -----
     int current_round{0}; // 0..2
-    // Archivos de recorridos - se inicializan según map_id
-    std::array<std::string, 3> checkpoint_sets;
 
     // ---------------- NPC Support ----------------
     NPCManager npc_manager;
 
     CarPhysicsConfig &physics_config;
     PlayerManager player_manager;
+    // Tiempos por fase del tick y bytes codificados (comando "stats" de la consola)
+    TickProfiler profiler;
     BroadcastManager broadcast_manager;
-    TickProcessor tick_processor;
+    InterestManager interest_manager;
     ContactHandler contact_handler;
+    TickProcessor tick_processor;
     SetupManager setup_manager;
+    TickScheduler tick_scheduler;
+
+    // Estado del paso fijo de física
+    std::chrono::steady_clock::time_point last_tick;
+    float acum{0.0f};
+
+    // Trabajo de un tick: eventos, simulación y broadcast
+    void process_tick();
 
     // Ejecuta el reset al lobby cuando es seguro (fuera del callback de Box2D)
     void perform_race_reset();
     void advance_round_or_reset_to_lobby();
+    // Saca a los que el broadcast desconectó; el GameMonitor cierra la partida
+    // cuando le llega su LEAVE_GAME
+    void remove_disconnected_players();
 
 
 
@@ -98,13 +119,30 @@ private:
     void on_playing_started();
 
 public:
-    explicit GameLoop(std::shared_ptr<Queue<Event>> events, uint8_t map_id = 0);
-    void run() override;
+    explicit GameLoop(std::shared_ptr<EventQueue> events, uint8_t map_id = 0);
+    void init() override;
+    void tick() override;
+    TickScheduler::clock::time_point next_tick_deadline() const override;
     void start_game();
-    void add_player(int id, std::shared_ptr<Queue<ServerMessage>> player_outbox);
+    void add_player(int id, std::shared_ptr<Outbox> player_outbox);
     void remove_player(int client_id);
     bool has_player(int client_id) const;
     size_t get_player_count() const;
     bool is_joinable() const;
+    TickStats get_tick_stats() const;
+    // Snapshots por segundo de esta partida, independiente del tick de física
+    void set_snapshot_rate(int snapshot_rate_hz);
+    int get_snapshot_rate() const;
+    TickProfiler::Report get_profile() const;
+    // Estado del outbox de un jugador, para detectar clientes lentos
+    struct OutboxStats
+    {
+        int player_id;
+        size_t pending;              // mensajes confiables esperando
+        uint64_t replaced_snapshots; // snapshots pisados sin llegar a enviarse
+        double snapshot_lag_ms;      // hace cuánto espera el snapshot sin enviar
+    };
+    std::vector<OutboxStats> get_outbox_stats() const;
+    void write_trace_events(std::ostream &out, int tid, bool &first) const;
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,16 @@
+#ifndef BRIDGE_CONTACTS_H
+#define BRIDGE_CONTACTS_H
+
+// Sensores de puente que está tocando un vehículo. Lo mantienen los eventos
+// Begin/EndContact de Box2D, así no hace falta recorrer la lista de contactos.
+struct BridgeContacts
+{
+    int start_sensors = 0; // SENSOR_START_BRIDGE
+    int end_sensors = 0;   // SENSOR_END_BRIDGE
+    // Tocó el sensor desde la última evaluación, aunque ya haya salido: un
+    // auto rápido puede cruzarlo entero dentro de un mismo tick
+    bool touched_start = false;
+    bool touched_end = false;
+};
+
+#endif
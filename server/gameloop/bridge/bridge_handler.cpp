@@ -1,6 +1,39 @@
 #include "bridge_handler.h"
 #include <iostream>
 
+uint16 BridgeHandler::bridge_sensor_category(b2Fixture *fixture)
+{
+    if (!fixture || !fixture->IsSensor())
+        return 0;
+
+    uint16 category = fixture->GetFilterData().categoryBits;
+    if (category == SENSOR_START_BRIDGE || category == SENSOR_END_BRIDGE)
+        return category;
+    return 0;
+}
+
+void BridgeHandler::count_sensor_contact(BridgeContacts &contacts, uint16 sensor, bool touching)
+{
+    bool is_start = (sensor == SENSOR_START_BRIDGE);
+    int &count = is_start ? contacts.start_sensors : contacts.end_sensors;
+    count += touching ? 1 : -1;
+    if (count < 0)
+        count = 0;
+
+    if (touching)
+        (is_start ? contacts.touched_start : contacts.touched_end) = true;
+}
+
+BridgeHandler::BridgeTransition BridgeHandler::take_transition(BridgeContacts &contacts)
+{
+    BridgeTransition transition;
+    transition.entering_bridge = contacts.start_sensors > 0 || contacts.touched_start;
+    transition.leaving_bridge = contacts.end_sensors > 0 || contacts.touched_end;
+    contacts.touched_start = false;
+    contacts.touched_end = false;
+    return transition;
+}
+
 bool BridgeHandler::update_bridge_state(PlayerData &player_data)
 {
     if (!player_data.body)
@@ -8,15 +41,15 @@ bool BridgeHandler::update_bridge_state(PlayerData &player_data)
         return player_data.position.on_bridge;
     }
 
-    BridgeContactResult result = analyze_bridge_contacts(player_data.body);
+    BridgeTransition transition = take_transition(player_data.bridge);
 
     // Actualizar el estado del puente
-    if (result.entering_bridge && !player_data.position.on_bridge)
+    if (transition.entering_bridge && !player_data.position.on_bridge)
     {
         set_collision_category(player_data, CAR_BRIDGE);
         player_data.position.on_bridge = true;
     }
-    else if (result.leaving_bridge && player_data.position.on_bridge)
+    else if (transition.leaving_bridge && player_data.position.on_bridge)
     {
         set_collision_category(player_data, CAR_GROUND);
         player_data.position.on_bridge = false;
@@ -32,57 +65,21 @@ void BridgeHandler::update_bridge_state(NPCData &npc_data)
         return;
     }
 
-    BridgeContactResult result = analyze_bridge_contacts(npc_data.body);
+    BridgeTransition transition = take_transition(npc_data.bridge);
 
     // Actualizar el estado del puente
-    if (result.entering_bridge && !npc_data.on_bridge)
+    if (transition.entering_bridge && !npc_data.on_bridge)
     {
         set_collision_category(npc_data, CAR_BRIDGE);
         npc_data.on_bridge = true;
     }
-    else if (result.leaving_bridge && npc_data.on_bridge)
+    else if (transition.leaving_bridge && npc_data.on_bridge)
     {
         set_collision_category(npc_data, CAR_GROUND);
         npc_data.on_bridge = false;
     }
 }
 
-BridgeHandler::BridgeContactResult BridgeHandler::analyze_bridge_contacts(b2Body *body)
-{
-    BridgeContactResult result;
-
-    b2ContactEdge *ce = body->GetContactList();
-    while (ce)
-    {
-        b2Contact *c = ce->contact;
-
-        if (c->IsTouching())
-        {
-            b2Fixture *a = c->GetFixtureA();
-            b2Fixture *b = c->GetFixtureB();
-
-            uint16 fcA = a->GetFilterData().categoryBits;
-            uint16 fcB = b->GetFilterData().categoryBits;
-
-            // Detectar entrada al puente
-            if (fcA == SENSOR_START_BRIDGE || fcB == SENSOR_START_BRIDGE)
-            {
-                result.entering_bridge = true;
-            }
-
-            // Detectar salida del puente
-            if (fcA == SENSOR_END_BRIDGE || fcB == SENSOR_END_BRIDGE)
-            {
-                result.leaving_bridge = true;
-            }
-        }
-
-        ce = ce->next;
-    }
-
-    return result;
-}
-
 void BridgeHandler::set_collision_category(PlayerData &player_data, uint16 new_category)
 {
     b2Body *body = player_data.body;
@@ -7,22 +7,31 @@
 #include "../../PlayerData.h"
 #include "../npc/npc_data.h"
 #include "../gameloop_constants.h"
+#include "bridge_contacts.h"
 
 
 // BridgeHandler - Maneja la lógica de transición de vehículos entre suelo y puente.
 class BridgeHandler
 {
 public:
+    // Categoría del sensor de puente (entrada o salida), 0 si el fixture no es uno
+    static uint16 bridge_sensor_category(b2Fixture *fixture);
+
+    // Suma (touching) o resta un contacto con un sensor de puente
+    static void count_sensor_contact(BridgeContacts &contacts, uint16 sensor, bool touching);
+
+    // Cambia de capa según los sensores que el vehículo está tocando
     static bool update_bridge_state(PlayerData &player_data);
     static void update_bridge_state(NPCData &npc_data);
 
 private:
-    struct BridgeContactResult
+    struct BridgeTransition
     {
         bool entering_bridge{false};
         bool leaving_bridge{false};
     };
-    static BridgeContactResult analyze_bridge_contacts(b2Body *body);
+    // Lee los sensores tocados y limpia las marcas de esta evaluación
+    static BridgeTransition take_transition(BridgeContacts &contacts);
     static void set_collision_category(PlayerData &player_data, uint16 new_category);
     static void set_collision_category(NPCData &npc_data, uint16 new_category);
     static void apply_category_filter(b2Fixture *fixture, uint16 new_category);
@@ -1,35 +1,94 @@
 #include "broadcast_manager.h"
 #include "../gameloop_constants.h"
+#include "../../server_config.h"
+#include <algorithm>
 #include <iostream>
 
+// Cada cuánto se manda un keyframe a todos
+#define SNAPSHOT_KEYFRAME_INTERVAL_MS 2000
+
+std::atomic<uint32_t> BroadcastManager::next_snapshot_seq{1};
+
 BroadcastManager::BroadcastManager(
     std::mutex &players_map_mutex,
-    std::unordered_map<int, PlayerData> &players,
-    std::unordered_map<int, std::shared_ptr<Queue<ServerMessage>>> &players_messanger)
+    PlayerStore &players,
+    std::unordered_map<int, std::shared_ptr<Outbox>> &players_messanger,
+    TickProfiler &profiler)
     : players_map_mutex(players_map_mutex),
       players(players),
-      players_messanger(players_messanger)
+      players_messanger(players_messanger),
+      profiler(profiler),
+      disconnected_mutex(),
+      disconnected(),
+      encoder_mutex(),
+      encoder(),
+      snapshot_history(),
+      client_rates(),
+      client_min_rate_hz(std::max(1, ServerConfig::getInstance().getClientSnapshotMinRateHz())),
+      snapshots_since_keyframe(0),
+      slow_client_timeout(std::chrono::milliseconds(ServerConfig::getInstance().getSlowClientTimeoutMs()))
 {
 }
 
-void BroadcastManager::broadcast(ServerMessage &msg)
+EncodedFrame BroadcastManager::encode(const ServerMessage &msg, uint8_t version)
+{
+    std::lock_guard<std::mutex> lk(encoder_mutex);
+    encoder.setVersion(version);
+    EncodedFrame frame = encoder.encodeFrame(msg);
+    profiler.add_encoded(frame->size());
+    return frame;
+}
+
+std::vector<EncodedFrame> BroadcastManager::encode_per_version(const Recipients &recipients, const ServerMessage &msg)
+{
+    std::array<EncodedFrame, PROTOCOL_VERSION + 1> by_version;
+    std::vector<EncodedFrame> frames;
+    frames.reserve(recipients.size());
+    for (auto &p : recipients)
+    {
+        uint8_t version = p.second ? p.second->get_wire_version() : PROTOCOL_VERSION_LEGACY;
+        if (!by_version[version])
+            by_version[version] = encode(msg, version);
+        frames.push_back(by_version[version]);
+    }
+    return frames;
+}
+
+const BroadcastManager::Snapshot *BroadcastManager::find_snapshot(const std::deque<Snapshot> &history, uint32_t seq) const
+{
+    for (const auto &snapshot : history)
+    {
+        if (snapshot.seq == seq)
+            return &snapshot;
+    }
+    return nullptr;
+}
+
+BroadcastManager::Recipients BroadcastManager::collect_recipients()
 {
     // Snapshot de destinatarios para evitar iterar el mapa mientras puede cambiar
-    std::vector<std::pair<int, std::shared_ptr<Queue<ServerMessage>>>> recipients;
+    Recipients recipients;
+    auto lk = profiler.lock_timed(players_map_mutex);
+    recipients.reserve(players_messanger.size());
+    for (auto &entry : players_messanger)
     {
-        std::lock_guard<std::mutex> lk(players_map_mutex);
-        recipients.reserve(players_messanger.size());
-        for (auto &entry : players_messanger)
-        {
-            recipients.emplace_back(entry.first, entry.second);
-        }
+        recipients.emplace_back(entry.first, entry.second);
     }
+    return recipients;
+}
 
+bool BroadcastManager::is_slow(const Outbox &outbox, bool delivered) const
+{
+    return !delivered || outbox.snapshot_lag() > slow_client_timeout;
+}
+
+void BroadcastManager::deliver(const Recipients &recipients, const std::vector<EncodedFrame> &frames, bool snapshot)
+{
     std::vector<int> to_remove;
-    for (auto &p : recipients)
+    for (size_t i = 0; i < recipients.size(); ++i)
     {
-        int id = p.first;
-        auto &queue = p.second;
+        int id = recipients[i].first;
+        auto &queue = recipients[i].second;
         if (!queue)
         {
             to_remove.push_back(id);
@@ -37,7 +96,22 @@ void BroadcastManager::broadcast(ServerMessage &msg)
         }
         try
         {
-            queue->push(msg);
+            bool delivered = true;
+            if (snapshot)
+            {
+                if (frames[i])
+                    queue->offer_snapshot(frames[i]);
+            }
+            else
+                delivered = queue->offer(frames[i]);
+
+            if (is_slow(*queue, delivered))
+            {
+                std::cerr << "[BroadcastManager] Cliente " << id << " no lee sus mensajes: se lo desconecta" << std::endl;
+                profiler.add_slow_disconnect();
+                queue->drop_client();
+                to_remove.push_back(id);
+            }
         }
         catch (const ClosedQueue &)
         {
@@ -47,35 +121,111 @@ void BroadcastManager::broadcast(ServerMessage &msg)
     }
     if (!to_remove.empty())
     {
-        // Remover jugadores desconectados
-        std::lock_guard<std::mutex> lk(players_map_mutex);
+        // Los saca la partida en su thread (body, orden de llegada y partida vacía)
+        std::lock_guard<std::mutex> lk(disconnected_mutex);
         for (int id : to_remove)
         {
-            players_messanger.erase(id);
-            players.erase(id);
+            if (std::find(disconnected.begin(), disconnected.end(), id) == disconnected.end())
+                disconnected.push_back(id);
         }
     }
 }
 
-void BroadcastManager::broadcast_game_started()
+std::vector<int> BroadcastManager::take_disconnected()
 {
-    ServerMessage msg;
-    msg.opcode = GAME_STARTED;
+    std::lock_guard<std::mutex> lk(disconnected_mutex);
+    std::vector<int> ids;
+    ids.swap(disconnected);
+    return ids;
+}
 
-    for (auto &entry : players_messanger)
+void BroadcastManager::broadcast(ServerMessage &msg)
+{
+    Recipients recipients = collect_recipients();
+    deliver(recipients, encode_per_version(recipients, msg), false);
+}
+
+void BroadcastManager::broadcast_snapshot(ServerMessage &msg, InterestManager &interest, int snapshot_rate_hz)
+{
+    Recipients recipients = collect_recipients();
+    std::vector<EncodedFrame> frames;
+    frames.reserve(recipients.size());
     {
-        auto &queue = entry.second;
-        if (queue)
+        std::lock_guard<std::mutex> lk(encoder_mutex);
+        uint32_t seq = next_snapshot_seq++;
+        snapshot_rate_hz = std::max(snapshot_rate_hz, 1);
+        int keyframe_interval = std::max(1, snapshot_rate_hz * SNAPSHOT_KEYFRAME_INTERVAL_MS / 1000);
+        bool keyframe = ++snapshots_since_keyframe >= keyframe_interval;
+        if (keyframe)
+            snapshots_since_keyframe = 0;
+        // Un cliente lento baja hasta client_min_rate_hz; sube un paso tras snapshot_rate_hz envíos sin pisados
+        int max_divisor = std::max(1, snapshot_rate_hz / client_min_rate_hz);
+
+        const std::vector<PlayerPositionUpdate> no_baseline;
+        std::vector<int> ids;
+        ids.reserve(recipients.size());
+
+        // Cada cliente ve un subconjunto distinto: un encode por cliente
+        for (auto &p : recipients)
         {
-            try
+            ids.push_back(p.first);
+            if (p.second && !client_rates[p.first].due(p.second->get_replaced_snapshots(), max_divisor, snapshot_rate_hz))
+            {
+                frames.push_back(nullptr);
+                continue;
+            }
+            auto view = std::make_shared<const std::vector<PlayerPositionUpdate>>(interest.view_for(p.first, msg.positions));
+            std::deque<Snapshot> &history = snapshot_history[p.first];
+            uint8_t version = p.second ? p.second->get_wire_version() : PROTOCOL_VERSION_LEGACY;
+            encoder.setVersion(version);
+
+            if (!p.second || !p.second->wants_deltas())
             {
-                queue->push(msg);
+                ServerMessage full;
+                full.opcode = UPDATE_POSITIONS;
+                full.positions = *view;
+                frames.push_back(encoder.encodeFrame(full));
             }
-            catch (const ClosedQueue &)
+            else
             {
+                const Snapshot *base = keyframe ? nullptr : find_snapshot(history, p.second->acked_snapshot());
+                frames.push_back(encoder.encodeSnapshotDelta(
+                    seq, base ? base->seq : 0, base ? *base->positions : no_baseline, *view));
             }
+
+            profiler.add_encoded(frames.back()->size());
+            history.push_back({seq, std::move(view)});
+            if (history.size() > SNAPSHOT_HISTORY)
+                history.pop_front();
+        }
+
+        // Olvidar a los que ya no están
+        for (auto it = snapshot_history.begin(); it != snapshot_history.end();)
+        {
+            if (std::find(ids.begin(), ids.end(), it->first) == ids.end())
+                it = snapshot_history.erase(it);
+            else
+                ++it;
+        }
+        for (auto it = client_rates.begin(); it != client_rates.end();)
+        {
+            if (std::find(ids.begin(), ids.end(), it->first) == ids.end())
+                it = client_rates.erase(it);
+            else
+                ++it;
         }
+        interest.retain(ids);
     }
+    deliver(recipients, frames, true);
+}
+
+void BroadcastManager::broadcast_game_started()
+{
+    ServerMessage msg;
+    msg.opcode = GAME_STARTED;
+
+    Recipients recipients = collect_recipients();
+    deliver(recipients, encode_per_version(recipients, msg), false);
 }
 
 void BroadcastManager::broadcast_race_end_message(uint8_t current_round)
@@ -86,17 +236,15 @@ void BroadcastManager::broadcast_race_end_message(uint8_t current_round)
     {
         std::lock_guard<std::mutex> lk(players_map_mutex);
         uint8_t round_index = current_round;
-        for (auto &entry : players)
+        for (auto [pid, pd, record] : players)
         {
-            int pid = entry.first;
-            PlayerData &pd = entry.second;
             uint32_t time_ms = 10u * 60u * 1000u;
             bool dq = pd.disqualified || pd.is_dead;
 
             int completed_round_idx = pd.rounds_completed - 1;
             if (completed_round_idx >= 0 && completed_round_idx < TOTAL_ROUNDS)
             {
-                time_ms = pd.round_times_ms[completed_round_idx];
+                time_ms = record.round_times_ms[completed_round_idx];
             }
             msg.race_times.push_back({static_cast<uint32_t>(pid), time_ms, dq, round_index});
         }
@@ -1,34 +1,102 @@
 #ifndef BROADCAST_MANAGER_H
 #define BROADCAST_MANAGER_H
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <mutex>
 #include <unordered_map>
 #include <memory>
-#include "../../PlayerData.h"
+#include <vector>
+#include "../../player_store.h"
 #include "../../../common/queue.h"
+#include "../../../common/message_encoder.h"
 #include "../../../common/messages.h"
+#include "../../outbox.h"
+#include "../interest/interest_manager.h"
+#include "../tick/tick_profiler.h"
+#include "../tick/snapshot_pacer.h"
 
 class BroadcastManager
 {
 public:
     BroadcastManager(
         std::mutex &players_map_mutex,
-        std::unordered_map<int, PlayerData> &players,
-        std::unordered_map<int, std::shared_ptr<Queue<ServerMessage>>> &players_messanger);
+        PlayerStore &players,
+        std::unordered_map<int, std::shared_ptr<Outbox>> &players_messanger,
+        TickProfiler &profiler);
 
-    // Envio mensaje a todos los jugadores conectados
+    // Envio mensaje a todos los jugadores conectados: se codifica una sola vez
+    // y todos los outbox comparten el mismo frame. Ningún envío bloquea: un
+    // snapshot pisa al anterior que el cliente no recibió y el cliente que no
+    // lee se desconecta, así un jugador lento no frena la partida.
     void broadcast(ServerMessage &msg);
 
+    // Envio el snapshot de posiciones del tick. Cada cliente recibe solo lo que
+    // interest deja en su área de interés (interest.update() ya se llamó con msg.positions).
+    // Los clientes que confirman snapshots reciben un delta contra el último que
+    // confirmaron y keyframes periódicos; el resto recibe el UPDATE_POSITIONS completo.
+    // snapshot_rate_hz es la frecuencia de la partida: a un cliente que no da
+    // abasto se le saltean snapshots (ver ClientSnapshotRate).
+    void broadcast_snapshot(ServerMessage &msg, InterestManager &interest, int snapshot_rate_hz);
+
     // Envio mensaje GAME_STARTED a todos los jugadores
     void broadcast_game_started();
 
     // Envio mensaje de tiempos de carrera a todos los jugadores
     void broadcast_race_end_message(uint8_t current_round);
 
+    // Jugadores que cerraron su outbox o se desconectaron por lentos desde la
+    // última llamada. Siguen en la partida: el GameLoop los saca en su thread.
+    std::vector<int> take_disconnected();
+
 private:
     std::mutex &players_map_mutex;
-    std::unordered_map<int, PlayerData> &players;
-    std::unordered_map<int, std::shared_ptr<Queue<ServerMessage>>> &players_messanger;
+    PlayerStore &players;
+    std::unordered_map<int, std::shared_ptr<Outbox>> &players_messanger;
+    TickProfiler &profiler;
+
+    // Se desconectan desde cualquier broadcast (también el del thread del lobby)
+    std::mutex disconnected_mutex;
+    std::vector<int> disconnected;
+
+    // start_game corre en el thread del lobby y también puede broadcastear
+    std::mutex encoder_mutex;
+    MessageEncoder encoder;
+
+    struct Snapshot
+    {
+        uint32_t seq;
+        std::shared_ptr<const std::vector<PlayerPositionUpdate>> positions;
+    };
+    // Últimos snapshots enviados a cada cliente: base posible de sus deltas
+    // (protegido por encoder_mutex)
+    std::unordered_map<int, std::deque<Snapshot>> snapshot_history;
+    // Frecuencia propia de cada cliente (protegido por encoder_mutex)
+    std::unordered_map<int, ClientSnapshotRate> client_rates;
+    int client_min_rate_hz;
+    int snapshots_since_keyframe;
+    std::chrono::steady_clock::duration slow_client_timeout;
+    // Secuencia compartida por todas las partidas: el ack de un cliente que viene
+    // de otra partida nunca coincide con un snapshot de esta
+    static std::atomic<uint32_t> next_snapshot_seq;
+
+    using Recipients = std::vector<std::pair<int, std::shared_ptr<Outbox>>>;
+
+    EncodedFrame encode(const ServerMessage &msg, uint8_t version);
+    // Frame de msg para la versión de cada outbox (un encode por versión presente)
+    std::vector<EncodedFrame> encode_per_version(const Recipients &recipients, const ServerMessage &msg);
+    const Snapshot *find_snapshot(const std::deque<Snapshot> &history, uint32_t seq) const;
+
+    Recipients collect_recipients();
+    // Encola frames[i] en el outbox recipients[i] sin bloquear (un snapshot nulo
+    // es un cliente salteado en este tick); desconecta a los lentos (ver
+    // is_slow) y anota en disconnected a ellos y a los que cerraron su outbox
+    void deliver(const Recipients &recipients, const std::vector<EncodedFrame> &frames, bool snapshot);
+    // Lento: no tiene lugar para un mensaje confiable o hace más de
+    // slow_client_timeout que no recibe snapshots
+    bool is_slow(const Outbox &outbox, bool delivered) const;
 };
 
 #endif
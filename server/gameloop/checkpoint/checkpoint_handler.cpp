@@ -3,16 +3,12 @@
 #include "../../../common/constants.h"
 #include <iostream>
 
-void CheckpointHandler::setup_checkpoints_from_file(
-    const std::string &json_path,
+void CheckpointHandler::setup_checkpoints(
+    const std::vector<b2Vec2> &checkpoints,
     b2World &world,
-    MapLayout &map_layout,
     std::vector<b2Vec2> &checkpoint_centers,
-    std::unordered_map<b2Fixture *, int> &checkpoint_fixtures)
+    std::vector<b2Body *> &checkpoint_bodies)
 {
-    std::vector<b2Vec2> checkpoints;
-    map_layout.extract_checkpoints(json_path, checkpoints);
-
     if (checkpoints.empty())
         return;
 
@@ -23,6 +19,7 @@ void CheckpointHandler::setup_checkpoints_from_file(
         bd.type = b2_staticBody;
         bd.position = checkpoint_centers[i];
         b2Body *checkpoint_body = world.CreateBody(&bd);
+        EntityTag::set(checkpoint_body, EntityKind::CHECKPOINT, static_cast<int>(i));
 
         b2CircleShape shape;
         shape.m_p.Set(0.0f, 0.0f);
@@ -32,68 +29,48 @@ void CheckpointHandler::setup_checkpoints_from_file(
         fd.shape = &shape;
         fd.isSensor = true;
 
-        b2Fixture *fixture = checkpoint_body->CreateFixture(&fd);
-        checkpoint_fixtures[fixture] = static_cast<int>(i);
+        checkpoint_body->CreateFixture(&fd);
+        checkpoint_bodies.push_back(checkpoint_body);
     }
 }
 
 void CheckpointHandler::load_round_checkpoints(
     int current_round,
-    const std::array<std::string, 3> &checkpoint_sets,
+    const std::array<std::vector<b2Vec2>, 3> &checkpoint_sets,
     b2World &world,
-    MapLayout &map_layout,
     std::vector<b2Vec2> &checkpoint_centers,
-    std::unordered_map<b2Fixture *, int> &checkpoint_fixtures)
+    std::vector<b2Body *> &checkpoint_bodies)
 {
-    // Limpiar checkpoints previos y fixtures
-    for (auto &pair : checkpoint_fixtures)
+    // Limpiar checkpoints previos
+    for (b2Body *body : checkpoint_bodies)
     {
-        b2Body *body = pair.first->GetBody();
         if (body)
         {
             world.DestroyBody(body);
         }
     }
-    checkpoint_fixtures.clear();
+    checkpoint_bodies.clear();
     checkpoint_centers.clear();
 
-    std::string json_path = checkpoint_sets[current_round];
-    setup_checkpoints_from_file(json_path, world, map_layout, checkpoint_centers, checkpoint_fixtures);
-}
-
-int CheckpointHandler::find_player_by_body(
-    b2Body *body,
-    const std::unordered_map<int, PlayerData> &players)
-{
-    for (const auto &entry : players)
-    {
-        if (entry.second.body == body)
-            return entry.first; // player id
-    }
-    return -1;
+    setup_checkpoints(checkpoint_sets[current_round], world, checkpoint_centers, checkpoint_bodies);
 }
 
 bool CheckpointHandler::is_valid_checkpoint_collision(
-    b2Fixture *player_fixture,
-    b2Fixture *checkpoint_fixture,
-    const std::unordered_map<int, PlayerData> &players,
-    const std::unordered_map<b2Fixture *, int> &checkpoint_fixtures,
+    const EntityTag &player_tag,
+    const EntityTag &checkpoint_tag,
+    const PlayerStore &players,
     int &out_player_id,
     int &out_checkpoint_index)
 {
-    if (!player_fixture || !checkpoint_fixture)
-        return false;
-
-    b2Body *player_body = player_fixture->GetBody();
-    out_player_id = find_player_by_body(player_body, players);
-    if (out_player_id < 0)
+    if (player_tag.kind != EntityKind::PLAYER || checkpoint_tag.kind != EntityKind::CHECKPOINT)
         return false;
 
-    auto it = checkpoint_fixtures.find(checkpoint_fixture);
-    if (it == checkpoint_fixtures.end())
+    // El body puede quedar vivo un instante después de que el jugador salió
+    if (!players.contains(player_tag.index))
         return false;
 
-    out_checkpoint_index = it->second;
+    out_player_id = player_tag.index;
+    out_checkpoint_index = checkpoint_tag.index;
     return true;
 }
 
@@ -5,40 +5,35 @@
 #include <box2d/b2_fixture.h>
 #include <box2d/b2_world.h>
 #include <box2d/b2_circle_shape.h>
-#include <unordered_map>
 #include <vector>
-#include <string>
 #include <array>
-#include "../../PlayerData.h"
-#include "../../map_layout.h"
+#include "../../player_store.h"
 #include "../gameloop_constants.h"
+#include "../world/entity_tag.h"
 
 class CheckpointHandler
 {
 public:
-    // Configura los checkpoints desde un archivo JSON
-    static void setup_checkpoints_from_file(
-        const std::string &json_path,
+    // Crea un sensor por checkpoint (centros en metros, del mapa compilado)
+    static void setup_checkpoints(
+        const std::vector<b2Vec2> &checkpoints,
         b2World &world,
-        MapLayout &map_layout,
         std::vector<b2Vec2> &checkpoint_centers,
-        std::unordered_map<b2Fixture *, int> &checkpoint_fixtures);
+        std::vector<b2Body *> &checkpoint_bodies);
 
     // Limpia y recarga los checkpoints para una nueva ronda
     static void load_round_checkpoints(
         int current_round,
-        const std::array<std::string, 3> &checkpoint_sets,
+        const std::array<std::vector<b2Vec2>, 3> &checkpoint_sets,
         b2World &world,
-        MapLayout &map_layout,
         std::vector<b2Vec2> &checkpoint_centers,
-        std::unordered_map<b2Fixture *, int> &checkpoint_fixtures);
+        std::vector<b2Body *> &checkpoint_bodies);
 
-    // Valida si una colisión es un checkpoint válido
+    // Valida si un contacto es entre un jugador y un checkpoint
     static bool is_valid_checkpoint_collision(
-        b2Fixture *player_fixture,
-        b2Fixture *checkpoint_fixture,
-        const std::unordered_map<int, PlayerData> &players,
-        const std::unordered_map<b2Fixture *, int> &checkpoint_fixtures,
+        const EntityTag &player_tag,
+        const EntityTag &checkpoint_tag,
+        const PlayerStore &players,
         int &out_player_id,
         int &out_checkpoint_index);
 
@@ -48,12 +43,6 @@ public:
         PlayerData &player_data,
         int checkpoint_index,
         int total_checkpoints);
-
-private:
-    // Encuentra el ID del jugador por su body de Box2D
-    static int find_player_by_body(
-        b2Body *body,
-        const std::unordered_map<int, PlayerData> &players);
 };
 
 #endif
@@ -1,53 +1,161 @@
 #include "contact_handler.h"
+#include <algorithm>
 
 ContactHandler::ContactHandler(
     std::mutex &players_map_mutex,
-    std::unordered_map<int, PlayerData> &players,
-    std::unordered_map<b2Fixture *, int> &checkpoint_fixtures,
+    PlayerStore &players,
     std::vector<b2Vec2> &checkpoint_centers,
     std::atomic<bool> &pending_race_reset,
     std::function<GameState()> get_state)
     : players_map_mutex(players_map_mutex),
       players(players),
-      checkpoint_fixtures(checkpoint_fixtures),
       checkpoint_centers(checkpoint_centers),
       pending_race_reset(pending_race_reset),
-      get_state(get_state)
+      get_state(get_state),
+      bridge_mutex(),
+      bridge_events(),
+      applying_bridge_events(),
+      touched_vehicles()
 {
 }
 
 void ContactHandler::handle_begin_contact(b2Fixture *fixture_a, b2Fixture *fixture_b)
 {
+    // Cada fixture se resuelve una sola vez por su etiqueta
+    EntityTag tag_a = EntityTag::of(fixture_a);
+    EntityTag tag_b = EntityTag::of(fixture_b);
+
+    record_bridge_contact(fixture_a, tag_a, fixture_b, tag_b, true);
+
     std::lock_guard<std::mutex> lk(players_map_mutex);
 
     // Checkeo checkpoint
-    process_pair(fixture_a, fixture_b);
-    process_pair(fixture_b, fixture_a);
+    process_pair(tag_a, tag_b);
+    process_pair(tag_b, tag_a);
 
     // Checkeo colisiones entre autos
-    bool any_death = CollisionHandler::handle_car_collision(fixture_a, fixture_b, players, get_state());
+    bool any_death = CollisionHandler::handle_car_collision(fixture_a, tag_a, fixture_b, tag_b,
+                                                            players, get_state());
     if (any_death)
     {
         RaceManager::check_race_completion(players, pending_race_reset);
     }
 }
 
-void ContactHandler::process_pair(b2Fixture *maybePlayerFix, b2Fixture *maybeCheckpointFix)
+void ContactHandler::process_pair(const EntityTag &maybe_player, const EntityTag &maybe_checkpoint)
 {
     int player_id, checkpoint_index;
     if (!CheckpointHandler::is_valid_checkpoint_collision(
-            maybePlayerFix, maybeCheckpointFix, players, checkpoint_fixtures,
-            player_id, checkpoint_index))
+            maybe_player, maybe_checkpoint, players, player_id, checkpoint_index))
         return;
 
-    PlayerData &player_data = players[player_id];
+    PlayerData &player_data = *players.find(player_id);
     int total = static_cast<int>(checkpoint_centers.size());
     bool completed_lap = CheckpointHandler::handle_checkpoint_reached(
         player_data, checkpoint_index, total);
 
     if (completed_lap)
     {
-        RaceManager::complete_player_race(player_data, pending_race_reset, players);
+        RaceManager::complete_player_race(player_data, *players.find_record(player_id), pending_race_reset, players);
     }
 }
 
+void ContactHandler::handle_end_contact(b2Fixture *fixture_a, b2Fixture *fixture_b)
+{
+    record_bridge_contact(fixture_a, EntityTag::of(fixture_a), fixture_b, EntityTag::of(fixture_b), false);
+}
+
+void ContactHandler::record_bridge_contact(b2Fixture *fixture_a, const EntityTag &tag_a,
+                                           b2Fixture *fixture_b, const EntityTag &tag_b, bool touching)
+{
+    uint16 sensor_a = BridgeHandler::bridge_sensor_category(fixture_a);
+    uint16 sensor_b = BridgeHandler::bridge_sensor_category(fixture_b);
+
+    BridgeContactEvent ev{};
+    ev.touching = touching;
+    if (sensor_b && (tag_a.kind == EntityKind::PLAYER || tag_a.kind == EntityKind::NPC))
+    {
+        ev.vehicle = tag_a;
+        ev.sensor = sensor_b;
+    }
+    else if (sensor_a && (tag_b.kind == EntityKind::PLAYER || tag_b.kind == EntityKind::NPC))
+    {
+        ev.vehicle = tag_b;
+        ev.sensor = sensor_a;
+    }
+    else
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lk(bridge_mutex);
+    bridge_events.push_back(ev);
+}
+
+BridgeContacts *ContactHandler::find_bridge_contacts(const EntityTag &vehicle, std::vector<NPCData> &npcs)
+{
+    if (vehicle.kind == EntityKind::PLAYER)
+    {
+        PlayerData *player_data = players.find(vehicle.index);
+        return player_data ? &player_data->bridge : nullptr;
+    }
+    if (vehicle.index >= 0 && vehicle.index < static_cast<int>(npcs.size()))
+    {
+        return &npcs[vehicle.index].bridge;
+    }
+    return nullptr;
+}
+
+void ContactHandler::update_layer(const EntityTag &vehicle, std::vector<NPCData> &npcs)
+{
+    if (vehicle.kind == EntityKind::PLAYER)
+    {
+        PlayerData *player_data = players.find(vehicle.index);
+        if (player_data)
+            BridgeHandler::update_bridge_state(*player_data);
+    }
+    else if (vehicle.index >= 0 && vehicle.index < static_cast<int>(npcs.size()))
+    {
+        BridgeHandler::update_bridge_state(npcs[vehicle.index]);
+    }
+}
+
+void ContactHandler::apply_bridge_contacts(std::vector<NPCData> &npcs)
+{
+    applying_bridge_events.clear();
+    {
+        std::lock_guard<std::mutex> lk(bridge_mutex);
+        std::swap(applying_bridge_events, bridge_events);
+    }
+    if (applying_bridge_events.empty())
+        return;
+
+    std::lock_guard<std::mutex> lk(players_map_mutex);
+
+    // Primero se cuentan todos los eventos y después se evalúa cada vehículo
+    // una vez: un body destruido en el medio suma y resta sin cambiar de capa
+    touched_vehicles.clear();
+    for (const BridgeContactEvent &ev : applying_bridge_events)
+    {
+        BridgeContacts *contacts = find_bridge_contacts(ev.vehicle, npcs);
+        if (!contacts)
+            continue;
+        BridgeHandler::count_sensor_contact(*contacts, ev.sensor, ev.touching);
+        touched_vehicles.push_back(ev.vehicle);
+    }
+
+    std::sort(touched_vehicles.begin(), touched_vehicles.end(),
+              [](const EntityTag &a, const EntityTag &b) {
+                  return a.kind != b.kind ? a.kind < b.kind : a.index < b.index;
+              });
+    auto same_vehicle = [](const EntityTag &a, const EntityTag &b) {
+        return a.kind == b.kind && a.index == b.index;
+    };
+    touched_vehicles.erase(std::unique(touched_vehicles.begin(), touched_vehicles.end(), same_vehicle),
+                           touched_vehicles.end());
+
+    for (const EntityTag &vehicle : touched_vehicles)
+    {
+        update_layer(vehicle, npcs);
+    }
+}
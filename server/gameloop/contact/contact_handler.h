@@ -5,36 +5,63 @@
 #include <unordered_map>
 #include <atomic>
 #include <functional>
+#include <vector>
 #include <box2d/b2_fixture.h>
-#include "../../PlayerData.h"
+#include "../../player_store.h"
 #include "../../game_state.h"
 #include "../checkpoint/checkpoint_handler.h"
 #include "../collision/collision_handler.h"
 #include "../race/race_manager.h"
+#include "../world/entity_tag.h"
+#include "../bridge/bridge_handler.h"
+#include "../npc/npc_data.h"
 
 class ContactHandler
 {
 public:
     ContactHandler(
         std::mutex &players_map_mutex,
-        std::unordered_map<int, PlayerData> &players,
-        std::unordered_map<b2Fixture *, int> &checkpoint_fixtures,
+        PlayerStore &players,
         std::vector<b2Vec2> &checkpoint_centers,
         std::atomic<bool> &pending_race_reset,
         std::function<GameState()> get_state);
 
     // Main contact handler - llamado por Box2D
     void handle_begin_contact(b2Fixture *fixture_a, b2Fixture *fixture_b);
+    // Fin de contacto: también llega desde DestroyBody con players_map_mutex
+    // tomado, por eso solo encola y no toca a los jugadores
+    void handle_end_contact(b2Fixture *fixture_a, b2Fixture *fixture_b);
+
+    // Aplica los contactos con sensores de puente encolados desde el último
+    // llamado y cambia de capa solo a los vehículos involucrados
+    void apply_bridge_contacts(std::vector<NPCData> &npcs);
 
 private:
-    void process_pair(b2Fixture *maybePlayerFix, b2Fixture *maybeCheckpointFix);
+    // Un vehículo empezó (touching) o dejó de tocar un sensor de puente
+    struct BridgeContactEvent
+    {
+        EntityTag vehicle;
+        uint16 sensor;
+        bool touching;
+    };
+
+    void process_pair(const EntityTag &maybe_player, const EntityTag &maybe_checkpoint);
+    void record_bridge_contact(b2Fixture *fixture_a, const EntityTag &tag_a,
+                               b2Fixture *fixture_b, const EntityTag &tag_b, bool touching);
+    BridgeContacts *find_bridge_contacts(const EntityTag &vehicle, std::vector<NPCData> &npcs);
+    void update_layer(const EntityTag &vehicle, std::vector<NPCData> &npcs);
 
     std::mutex &players_map_mutex;
-    std::unordered_map<int, PlayerData> &players;
-    std::unordered_map<b2Fixture *, int> &checkpoint_fixtures;
+    PlayerStore &players;
     std::vector<b2Vec2> &checkpoint_centers;
     std::atomic<bool> &pending_race_reset;
     std::function<GameState()> get_state;
+
+    std::mutex bridge_mutex;
+    std::vector<BridgeContactEvent> bridge_events;
+    // Lote que se está aplicando (se reusa entre ticks)
+    std::vector<BridgeContactEvent> applying_bridge_events;
+    std::vector<EntityTag> touched_vehicles;
 };
 
 #endif
@@ -23,8 +23,10 @@ constexpr int COLLISION_ITERS = 3;
 // Constantes de NPC
 static constexpr float NPC_DIRECTION_THRESHOLD = 0.05f;
 static constexpr float NPC_ARRIVAL_THRESHOLD_M = 0.5f;
+static constexpr float NPC_MIN_STEER_DIST_M = 0.01f;
 static constexpr float MIN_DISTANCE_FROM_PARKED_M = 1.0f;
 static constexpr float MIN_DISTANCE_FROM_SPAWN_M = 5.0f;
+static constexpr int NPC_ROUTE_PICK_ATTEMPTS = 8;
 
 // Constantes de física
 static constexpr float RIGHT_VECTOR_X = 1.0f;
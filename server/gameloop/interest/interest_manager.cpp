@@ -0,0 +1,205 @@
+#include "interest_manager.h"
+#include "../../server_config.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// El radio cercano crece con la velocidad del auto: cubre lo que recorre en este
+// lapso para que los NPCs ya estén cuando entran en pantalla
+#define INTEREST_LOOKAHEAD_SECONDS 0.5f
+
+InterestManager::InterestManager()
+    : near_radius(static_cast<float>(ServerConfig::getInstance().getInterestRadiusPx())),
+      far_radius(static_cast<float>(ServerConfig::getInstance().getInterestFarRadiusPx())),
+      hysteresis(static_cast<float>(ServerConfig::getInstance().getInterestHysteresisPx())),
+      cell_size(static_cast<float>(std::max(1, ServerConfig::getInstance().getInterestCellPx()))),
+      far_interval(std::max(1, ServerConfig::getInstance().getInterestFarInterval())),
+      sim_time(0.0),
+      origin_x(0.0f),
+      origin_y(0.0f),
+      cols(0),
+      rows(0),
+      cell_start(),
+      cell_items(),
+      viewers()
+{
+    far_radius = std::max(far_radius, near_radius);
+}
+
+int InterestManager::cell_x(float x) const
+{
+    int c = static_cast<int>(std::floor((x - origin_x) / cell_size));
+    return std::clamp(c, 0, cols - 1);
+}
+
+int InterestManager::cell_y(float y) const
+{
+    int c = static_cast<int>(std::floor((y - origin_y) / cell_size));
+    return std::clamp(c, 0, rows - 1);
+}
+
+bool InterestManager::far_refresh_due(int npc_id, uint64_t views) const
+{
+    // Escalonado por id para que no se refresquen todos en el mismo snapshot
+    return (views + static_cast<uint64_t>(std::abs(npc_id))) % static_cast<uint64_t>(far_interval) == 0;
+}
+
+void InterestManager::update(const std::vector<PlayerPositionUpdate> &entities, float elapsed_seconds)
+{
+    sim_time += elapsed_seconds;
+    cols = 0;
+    rows = 0;
+    cell_start.clear();
+    cell_items.clear();
+    if (near_radius <= 0.0f)
+        return;
+
+    // La grilla cubre el bounding box de los NPCs del snapshot
+    float min_x = 0.0f, min_y = 0.0f, max_x = 0.0f, max_y = 0.0f;
+    bool any = false;
+    for (const auto &e : entities)
+    {
+        if (e.player_id >= 0)
+            continue;
+        if (!any)
+        {
+            min_x = max_x = e.new_pos.new_X;
+            min_y = max_y = e.new_pos.new_Y;
+            any = true;
+            continue;
+        }
+        min_x = std::min(min_x, e.new_pos.new_X);
+        max_x = std::max(max_x, e.new_pos.new_X);
+        min_y = std::min(min_y, e.new_pos.new_Y);
+        max_y = std::max(max_y, e.new_pos.new_Y);
+    }
+    if (!any)
+        return;
+
+    origin_x = min_x;
+    origin_y = min_y;
+    cols = static_cast<int>((max_x - min_x) / cell_size) + 1;
+    rows = static_cast<int>((max_y - min_y) / cell_size) + 1;
+
+    // Counting sort de los NPCs por celda
+    cell_start.assign(static_cast<size_t>(cols) * rows + 1, 0);
+    for (const auto &e : entities)
+    {
+        if (e.player_id < 0)
+            ++cell_start[cell_y(e.new_pos.new_Y) * cols + cell_x(e.new_pos.new_X) + 1];
+    }
+    for (size_t c = 1; c < cell_start.size(); ++c)
+        cell_start[c] += cell_start[c - 1];
+
+    cell_items.resize(cell_start.back());
+    std::vector<int> fill(cell_start.begin(), cell_start.end() - 1);
+    for (size_t i = 0; i < entities.size(); ++i)
+    {
+        const auto &e = entities[i];
+        if (e.player_id < 0)
+            cell_items[fill[cell_y(e.new_pos.new_Y) * cols + cell_x(e.new_pos.new_X)]++] = static_cast<int>(i);
+    }
+}
+
+std::vector<PlayerPositionUpdate> InterestManager::view_for(int viewer_id, const std::vector<PlayerPositionUpdate> &entities)
+{
+    const PlayerPositionUpdate *self = nullptr;
+    for (const auto &e : entities)
+    {
+        if (e.player_id == viewer_id)
+        {
+            self = &e;
+            break;
+        }
+    }
+    if (near_radius <= 0.0f || !self)
+        return entities;
+
+    Viewer &viewer = viewers[viewer_id];
+    float vx = self->new_pos.new_X;
+    float vy = self->new_pos.new_Y;
+    // Velocidad en px/s: entre dos snapshots de un cliente puede pasar más de un tick
+    float elapsed = static_cast<float>(sim_time - viewer.last_time);
+    float speed = (viewer.has_position && elapsed > 0.0f) ? std::hypot(vx - viewer.last_x, vy - viewer.last_y) / elapsed : 0.0f;
+    viewer.last_x = vx;
+    viewer.last_y = vy;
+    viewer.last_time = sim_time;
+    viewer.has_position = true;
+    ++viewer.views;
+    float near = std::min(near_radius + speed * INTEREST_LOOKAHEAD_SECONDS, far_radius);
+
+    std::vector<PlayerPositionUpdate> view;
+    for (const auto &e : entities)
+    {
+        if (e.player_id >= 0)
+            view.push_back(e);
+    }
+    if (cols == 0)
+    {
+        viewer.tiers.clear();
+        viewer.far_cache.clear();
+        return view;
+    }
+
+    std::unordered_map<int, Tier> tiers;
+    std::unordered_map<int, PlayerPositionUpdate> far_cache;
+    float reach = far_radius + hysteresis;
+    int x0 = cell_x(vx - reach), x1 = cell_x(vx + reach);
+    int y0 = cell_y(vy - reach), y1 = cell_y(vy + reach);
+    for (int cy = y0; cy <= y1; ++cy)
+    {
+        for (int cx = x0; cx <= x1; ++cx)
+        {
+            int c = cy * cols + cx;
+            for (int k = cell_start[c]; k < cell_start[c + 1]; ++k)
+            {
+                const auto &npc = entities[cell_items[k]];
+                float dx = npc.new_pos.new_X - vx;
+                float dy = npc.new_pos.new_Y - vy;
+                float dist2 = dx * dx + dy * dy;
+
+                // Histéresis: se sale con un radio mayor que con el que se entra
+                auto prev = viewer.tiers.find(npc.player_id);
+                bool known = prev != viewer.tiers.end();
+                float near_limit = (known && prev->second == Tier::NEAR) ? near + hysteresis : near;
+                float far_limit = known ? far_radius + hysteresis : far_radius;
+
+                if (dist2 <= near_limit * near_limit)
+                {
+                    tiers.emplace(npc.player_id, Tier::NEAR);
+                    view.push_back(npc);
+                    continue;
+                }
+                if (dist2 > far_limit * far_limit)
+                    continue;
+
+                tiers.emplace(npc.player_id, Tier::FAR);
+                auto cached = viewer.far_cache.find(npc.player_id);
+                if (cached == viewer.far_cache.end() || far_refresh_due(npc.player_id, viewer.views))
+                {
+                    far_cache.emplace(npc.player_id, npc);
+                    view.push_back(npc);
+                }
+                else
+                {
+                    far_cache.emplace(npc.player_id, cached->second);
+                    view.push_back(cached->second);
+                }
+            }
+        }
+    }
+    viewer.tiers.swap(tiers);
+    viewer.far_cache.swap(far_cache);
+    return view;
+}
+
+void InterestManager::retain(const std::vector<int> &viewer_ids)
+{
+    for (auto it = viewers.begin(); it != viewers.end();)
+    {
+        if (std::find(viewer_ids.begin(), viewer_ids.end(), it->first) == viewer_ids.end())
+            it = viewers.erase(it);
+        else
+            ++it;
+    }
+}
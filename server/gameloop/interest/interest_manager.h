@@ -0,0 +1,76 @@
+#ifndef INTEREST_MANAGER_H
+#define INTEREST_MANAGER_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "../../../common/messages.h"
+
+// Área de interés de cada cliente: qué NPCs recibe según la distancia a su auto.
+// Los NPCs se indexan una vez por snapshot en una grilla uniforme y cada cliente
+// consulta solo las celdas que cubre su radio. Los jugadores se envían siempre.
+class InterestManager
+{
+public:
+    InterestManager();
+
+    // Indexa en la grilla los NPCs del snapshot (entities es el snapshot completo);
+    // elapsed_seconds es el tiempo de simulación desde el snapshot anterior
+    void update(const std::vector<PlayerPositionUpdate> &entities, float elapsed_seconds);
+
+    // Snapshot que ve viewer_id sobre el mismo entities de update():
+    // - jugadores y NPCs dentro del radio cercano: estado actual
+    // - NPCs dentro del radio lejano: se refrescan cada far_interval snapshots
+    //   que recibe el cliente y entre medio repiten el último estado enviado (el delta no manda nada)
+    // - el resto no se envía
+    // Si el cliente no tiene auto en el snapshot (o el filtro está desactivado) ve todo.
+    std::vector<PlayerPositionUpdate> view_for(int viewer_id, const std::vector<PlayerPositionUpdate> &entities);
+
+    // Descarta el estado de los clientes que ya no reciben snapshots
+    void retain(const std::vector<int> &viewer_ids);
+
+private:
+    enum class Tier : uint8_t
+    {
+        NEAR,
+        FAR
+    };
+
+    struct Viewer
+    {
+        float last_x{0.0f};
+        float last_y{0.0f};
+        double last_time{0.0};
+        bool has_position{false};
+        // Snapshots que recibió (a un cliente lento se le saltean algunos)
+        uint64_t views{0};
+        std::unordered_map<int, Tier> tiers;
+        // Último estado enviado de cada NPC lejano
+        std::unordered_map<int, PlayerPositionUpdate> far_cache;
+    };
+
+    float near_radius;
+    float far_radius;
+    float hysteresis;
+    float cell_size;
+    int far_interval;
+    // Tiempo de simulación acumulado de los snapshots
+    double sim_time;
+
+    // Grilla en formato CSR: los índices de los NPCs de la celda c están en
+    // cell_items[cell_start[c] .. cell_start[c + 1])
+    float origin_x;
+    float origin_y;
+    int cols;
+    int rows;
+    std::vector<int> cell_start;
+    std::vector<int> cell_items;
+
+    std::unordered_map<int, Viewer> viewers;
+
+    int cell_x(float x) const;
+    int cell_y(float y) const;
+    bool far_refresh_due(int npc_id, uint64_t views) const;
+};
+
+#endif
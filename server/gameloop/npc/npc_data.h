@@ -2,6 +2,9 @@
 #define NPC_DATA_H
 
 #include <box2d/b2_body.h>
+#include <cstddef>
+#include <vector>
+#include "../bridge/bridge_contacts.h"
 
 struct NPCData
 {
@@ -9,10 +12,28 @@ struct NPCData
     int npc_id{0};             // id negativo para el broadcast
     int current_waypoint{0};   // último waypoint alcanzado
     int target_waypoint{0};    // próximo waypoint objetivo
+    int destination_waypoint{-1}; // destino de la ruta (RoadGraph::NO_ROUTE = sin ruta)
     float speed_mps{0.0f};     // velocidad de movimiento en metros/segundo
     bool is_parked{false};     // true = estacionado (cuerpo estático)
     bool is_horizontal{false}; // true = orientado horizontalmente (solo para estacionados)
     bool on_bridge{false};
+    BridgeContacts bridge;
+};
+
+// NPCs que circulan, en arreglos paralelos (SoA) que el update recorre de
+// corrido. El elemento i de cada arreglo corresponde a npcs[npc[i]].
+struct NPCKernel
+{
+    std::vector<size_t> npc;      // índice en NPCManager::npcs
+    std::vector<float> x;         // posición y ángulo leídos del body
+    std::vector<float> y;
+    std::vector<float> angle;
+    std::vector<float> target_x;  // waypoint objetivo
+    std::vector<float> target_y;
+    std::vector<float> speed;     // metros/segundo
+    std::vector<float> heading;   // ángulo del body en el tramo actual
+
+    size_t size() const { return npc.size(); }
 };
 
 #endif 
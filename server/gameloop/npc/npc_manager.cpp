@@ -1,6 +1,7 @@
 #include "npc_manager.h"
 #include "../../../common/constants.h"
 #include "../../npc_config.h"
+#include "point_kd_tree.h"
 #include <box2d/b2_polygon_shape.h>
 #include <box2d/b2_fixture.h>
 #include <algorithm>
@@ -8,69 +9,58 @@
 #include <iostream>
 #include <cmath>
 
-NPCManager::NPCManager(b2World &world)
-    : world(world)
+NPCManager::NPCManager(b2World &world, const RoadGraph &roads)
+    : world(world), rng(), roads(roads)
 {
 }
 
 void NPCManager::init(const std::vector<MapLayout::ParkedCarData> &parked_data,
-                      const std::vector<MapLayout::WaypointData> &waypoints,
                       const std::vector<MapLayout::SpawnPointData> &spawn_points)
 {
-    street_waypoints = waypoints;
     player_spawn_points = spawn_points;
+
+    uint32_t seed = NPCConfig::getInstance().getSeed();
+    rng.seed(seed != 0 ? seed : std::random_device{}());
+
     int next_negative_id = -1;
     spawn_parked_npcs(parked_data, next_negative_id);
     spawn_moving_npcs(parked_data, next_negative_id);
-}
-
-void NPCManager::update()
-{
-    if (street_waypoints.empty())
-        return;
-
-    std::random_device rd;
-    std::mt19937 gen(rd());
 
+    // Los estacionados son cuerpos estáticos: su posición no cambia más
+    parked_broadcast.clear();
     for (auto &npc : npcs)
     {
-        b2Body *body = npc.body;
-        if (!body || npc.is_parked)
-            continue; // NPCs estacionados no se mueven
-
-        // Validar índices
-        if (npc.target_waypoint < 0 || npc.target_waypoint >= static_cast<int>(street_waypoints.size()))
-            continue;
-
-        b2Vec2 target_pos = street_waypoints[npc.target_waypoint].position;
+        if (npc.is_parked)
+            add_npc_to_broadcast(parked_broadcast, npc);
+    }
+}
 
-        // Si llegó al waypoint objetivo, elegir siguiente destino aleatorio
-        if (should_select_new_waypoint(npc, target_pos))
-        {
-            select_next_waypoint(npc, gen);
-            target_pos = street_waypoints[npc.target_waypoint].position;
-        }
+void NPCManager::update(int steps)
+{
+    if (roads.size() == 0 || moving.size() == 0 || steps <= 0)
+        return;
 
-        // Moverse hacia el target
-        move_npc_towards_target(npc, target_pos);
-    }
+    gather_kernel_state();
+    retarget_arrived_npcs();
+    steer_npcs(static_cast<float>(steps) * FPS);
 }
 
 void NPCManager::reset_velocities()
 {
-    for (auto &npc : npcs)
+    for (size_t i = 0; i < moving.size(); ++i)
     {
-        if (!npc.body || npc.is_parked)
-            continue;
-        npc.body->SetLinearVelocity(b2Vec2(0.0f, 0.0f));
+        b2Body *body = npcs[moving.npc[i]].body;
+        body->SetLinearVelocity(b2Vec2(0.0f, 0.0f));
+        body->SetAngularVelocity(0.0f);
     }
 }
 
 void NPCManager::add_to_broadcast(std::vector<PlayerPositionUpdate> &broadcast)
 {
-    for (auto &npc : npcs)
+    broadcast.insert(broadcast.end(), parked_broadcast.begin(), parked_broadcast.end());
+    for (size_t i = 0; i < moving.size(); ++i)
     {
-        add_npc_to_broadcast(broadcast, npc);
+        add_npc_to_broadcast(broadcast, npcs[moving.npc[i]]);
     }
 }
 
@@ -80,15 +70,12 @@ void NPCManager::spawn_parked_npcs(const std::vector<MapLayout::ParkedCarData> &
 {
     int parked_count = std::min(static_cast<int>(parked_data.size()), NPCConfig::getInstance().getMaxParked());
 
-    std::random_device rd_parked;
-    std::mt19937 gen_parked(rd_parked());
-
     std::vector<size_t> parked_indices;
     for (size_t i = 0; i < parked_data.size(); ++i)
     {
         parked_indices.push_back(i);
     }
-    std::shuffle(parked_indices.begin(), parked_indices.end(), gen_parked);
+    std::shuffle(parked_indices.begin(), parked_indices.end(), rng);
 
     for (int i = 0; i < parked_count; ++i)
     {
@@ -106,13 +93,13 @@ void NPCManager::spawn_parked_npcs(const std::vector<MapLayout::ParkedCarData> &
         npc.is_horizontal = parked.horizontal;
         npc.on_bridge = false;
 
-        npcs.push_back(npc);
+        add_npc(npc);
     }
 }
 
 void NPCManager::spawn_moving_npcs(const std::vector<MapLayout::ParkedCarData> &parked_data, int &next_negative_id)
 {
-    if (street_waypoints.size() < 2)
+    if (roads.size() < 2)
     {
         return;
     }
@@ -121,9 +108,7 @@ void NPCManager::spawn_moving_npcs(const std::vector<MapLayout::ParkedCarData> &
     int moving_npcs_count = std::min(NPCConfig::getInstance().getMaxMoving(),
                                      static_cast<int>(candidate_waypoints.size()));
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::shuffle(candidate_waypoints.begin(), candidate_waypoints.end(), gen);
+    std::shuffle(candidate_waypoints.begin(), candidate_waypoints.end(), rng);
 
     for (int i = 0; i < moving_npcs_count; ++i)
     {
@@ -133,112 +118,118 @@ void NPCManager::spawn_moving_npcs(const std::vector<MapLayout::ParkedCarData> &
         float initial_angle = 0.0f;
         if (target_wp_idx != start_wp_idx)
         {
-            b2Vec2 spawn_pos = street_waypoints[start_wp_idx].position;
-            b2Vec2 target_pos = street_waypoints[target_wp_idx].position;
+            b2Vec2 spawn_pos = roads.position(start_wp_idx);
+            b2Vec2 target_pos = roads.position(target_wp_idx);
             initial_angle = calculate_initial_npc_angle(spawn_pos, target_pos);
         }
 
         NPCData npc = create_moving_npc(start_wp_idx, target_wp_idx, initial_angle, next_negative_id);
-        npcs.push_back(npc);
+        npc.destination_waypoint = pick_destination(start_wp_idx);
+        add_npc(npc);
+        add_to_kernel(npcs.size() - 1, roads.position(target_wp_idx), npc.speed_mps, initial_angle);
     }
 }
 
 std::vector<int> NPCManager::get_valid_waypoints_away_from_parked(const std::vector<MapLayout::ParkedCarData> &parked_data)
 {
+    // Un KD-tree por cada tipo de obstáculo: cada waypoint consulta solo los cercanos
+    std::vector<b2Vec2> parked_points;
+    parked_points.reserve(parked_data.size());
+    for (const auto &parked_car : parked_data)
+        parked_points.push_back(parked_car.position);
+    PointKdTree parked_tree(std::move(parked_points));
+
+    std::vector<b2Vec2> spawn_points;
+    spawn_points.reserve(player_spawn_points.size());
+    for (const auto &spawn : player_spawn_points)
+    {
+        // Convertir spawn point de píxeles a metros
+        spawn_points.push_back(b2Vec2(spawn.x / SCALE, spawn.y / SCALE));
+    }
+    PointKdTree spawn_tree(std::move(spawn_points));
+
     std::vector<int> candidate_waypoints;
-    candidate_waypoints.reserve(street_waypoints.size());
+    candidate_waypoints.reserve(roads.size());
 
-    for (int idx = 0; idx < static_cast<int>(street_waypoints.size()); ++idx)
+    for (int idx = 0; idx < roads.size(); ++idx)
     {
-        b2Vec2 wp_pos = street_waypoints[idx].position;
-        
-        // Verificar distancia a spawn points de jugadores
-        if (!should_select_spawn_position(wp_pos))
+        const b2Vec2 &wp_pos = roads.position(idx);
+        if (spawn_tree.any_within(wp_pos, MIN_DISTANCE_FROM_SPAWN_M) ||
+            parked_tree.any_within(wp_pos, MIN_DISTANCE_FROM_PARKED_M))
             continue;
 
-        // Verificar distancia a autos estacionados
-        bool too_close_to_parked = false;
-        for (const auto &parked_car : parked_data)
-        {
-            float distance = (wp_pos - parked_car.position).Length();
-            if (distance < MIN_DISTANCE_FROM_PARKED_M)
-            {
-                too_close_to_parked = true;
-                break;
-            }
-        }
-
-        if (!too_close_to_parked)
-            candidate_waypoints.push_back(idx);
+        candidate_waypoints.push_back(idx);
     }
 
     if (candidate_waypoints.empty())
     {
-        for (int idx = 0; idx < static_cast<int>(street_waypoints.size()); ++idx)
+        for (int idx = 0; idx < roads.size(); ++idx)
             candidate_waypoints.push_back(idx);
     }
 
     return candidate_waypoints;
 }
 
-bool NPCManager::should_select_spawn_position(const b2Vec2 &waypoint_pos) const
-{
-    for (const auto &spawn : player_spawn_points)
-    {
-        // Convertir spawn point de píxeles a metros
-        b2Vec2 spawn_pos_m(spawn.x / SCALE, spawn.y / SCALE);
-        float distance = (waypoint_pos - spawn_pos_m).Length();
-        
-        if (distance < MIN_DISTANCE_FROM_SPAWN_M)
-            return false;
-    }
-    return true;
-}
-
 int NPCManager::select_closest_waypoint_connection(int start_waypoint_idx)
 {
-    const MapLayout::WaypointData &start_wp = street_waypoints[start_waypoint_idx];
-    b2Vec2 spawn_pos = start_wp.position;
-
-    if (start_wp.connections.empty())
-        return start_waypoint_idx;
+    std::span<const int> next = roads.neighbors(start_waypoint_idx);
+    std::span<const float> lengths = roads.edge_lengths(start_waypoint_idx);
 
     float best_dist = std::numeric_limits<float>::max();
     int closest_idx = start_waypoint_idx;
-
-    for (int candidate_idx : start_wp.connections)
+    for (size_t e = 0; e < next.size(); ++e)
     {
-        if (candidate_idx < 0 || candidate_idx >= static_cast<int>(street_waypoints.size()))
-            continue;
-
-        b2Vec2 candidate_pos = street_waypoints[candidate_idx].position;
-        float distance = (candidate_pos - spawn_pos).Length();
-
-        if (distance < best_dist)
+        if (lengths[e] < best_dist)
         {
-            best_dist = distance;
-            closest_idx = candidate_idx;
+            best_dist = lengths[e];
+            closest_idx = next[e];
         }
     }
 
     return closest_idx;
 }
 
-float NPCManager::calculate_initial_npc_angle(const b2Vec2 &spawn_pos, const b2Vec2 &target_pos) const
+int NPCManager::pick_destination(int from)
 {
-    b2Vec2 direction = target_pos - spawn_pos;
-    float length = direction.Length();
+    if (!roads.has_routes())
+        return RoadGraph::NO_ROUTE;
+
+    std::uniform_int_distribution<int> node_dist(0, roads.size() - 1);
+    for (int attempt = 0; attempt < NPC_ROUTE_PICK_ATTEMPTS; ++attempt)
+    {
+        int destination = node_dist(rng);
+        if (destination != from && roads.next_hop(from, destination) != RoadGraph::NO_ROUTE)
+            return destination;
+    }
+    return RoadGraph::NO_ROUTE;
+}
 
-    if (length <= 0.0001f)
-        return 0.0f;
+int NPCManager::select_route_hop(NPCData &npc)
+{
+    int from = npc.current_waypoint;
+    if (npc.destination_waypoint == from || roads.next_hop(from, npc.destination_waypoint) == RoadGraph::NO_ROUTE)
+        npc.destination_waypoint = pick_destination(from);
+
+    int hop = roads.next_hop(from, npc.destination_waypoint);
+    if (hop != RoadGraph::NO_ROUTE)
+        return hop;
+
+    // Sin ruta (grafo sin tabla o waypoint sin salida alcanzable): paso al azar
+    std::span<const int> next = roads.neighbors(from);
+    if (next.empty())
+        return RoadGraph::NO_ROUTE;
+    std::uniform_int_distribution<size_t> conn_dist(0, next.size() - 1);
+    return next[conn_dist(rng)];
+}
 
-    float movement_angle = std::atan2(direction.y, direction.x);
-    return movement_angle - b2_pi / 2.0f; // sprite orientado hacia arriba
+float NPCManager::calculate_initial_npc_angle(const b2Vec2 &spawn_pos, const b2Vec2 &target_pos) const
+{
+    return heading_towards(spawn_pos.x, spawn_pos.y, target_pos.x, target_pos.y, 0.0f);
 }
 
 NPCData NPCManager::create_moving_npc(int start_idx, int target_idx, float initial_angle, int &next_negative_id)
 {
-    b2Vec2 spawn_pos = street_waypoints[start_idx].position;
+    b2Vec2 spawn_pos = roads.position(start_idx);
     float speed_mps = NPCConfig::getInstance().getSpeedPxS() / SCALE;
 
     b2Body *npc_body = create_npc_body(spawn_pos.x, spawn_pos.y, false, initial_angle);
@@ -255,6 +246,26 @@ NPCData NPCManager::create_moving_npc(int start_idx, int target_idx, float initi
     return npc;
 }
 
+void NPCManager::add_npc(const NPCData &npc)
+{
+    // La etiqueta es la posición en npcs: los contactos llegan al NPC directo
+    EntityTag::set(npc.body, EntityKind::NPC, static_cast<int>(npcs.size()));
+    npcs.push_back(npc);
+}
+
+void NPCManager::add_to_kernel(size_t npc_index, const b2Vec2 &target, float speed, float heading)
+{
+    b2Vec2 pos = npcs[npc_index].body->GetPosition();
+    moving.npc.push_back(npc_index);
+    moving.x.push_back(pos.x);
+    moving.y.push_back(pos.y);
+    moving.angle.push_back(heading);
+    moving.target_x.push_back(target.x);
+    moving.target_y.push_back(target.y);
+    moving.speed.push_back(speed);
+    moving.heading.push_back(heading);
+}
+
 // Body creation
 
 b2Body *NPCManager::create_npc_body(float x_m, float y_m, bool is_static, float angle_rad)
@@ -290,47 +301,74 @@ b2Body *NPCManager::create_npc_body(float x_m, float y_m, bool is_static, float
 
 // Update helpers
 
-bool NPCManager::should_select_new_waypoint(NPCData &npc, const b2Vec2 &target_pos)
+void NPCManager::gather_kernel_state()
 {
-    b2Vec2 pos = npc.body->GetPosition();
-    float dist = (target_pos - pos).Length();
-    return dist < NPC_ARRIVAL_THRESHOLD_M;
+    for (size_t i = 0; i < moving.size(); ++i)
+    {
+        const b2Body *body = npcs[moving.npc[i]].body;
+        const b2Vec2 &pos = body->GetPosition();
+        moving.x[i] = pos.x;
+        moving.y[i] = pos.y;
+        moving.angle[i] = body->GetAngle();
+    }
 }
 
-void NPCManager::select_next_waypoint(NPCData &npc, std::mt19937 &gen)
+void NPCManager::retarget_arrived_npcs()
 {
-    npc.current_waypoint = npc.target_waypoint;
-    const MapLayout::WaypointData &current_wp = street_waypoints[npc.current_waypoint];
-
-    // Elegir aleatoriamente uno de los waypoints conectados
-    if (!current_wp.connections.empty())
+    const float arrival2 = NPC_ARRIVAL_THRESHOLD_M * NPC_ARRIVAL_THRESHOLD_M;
+    for (size_t i = 0; i < moving.size(); ++i)
     {
-        std::uniform_int_distribution<size_t> conn_dist(0, current_wp.connections.size() - 1);
-        npc.target_waypoint = current_wp.connections[conn_dist(gen)];
+        float dx = moving.target_x[i] - moving.x[i];
+        float dy = moving.target_y[i] - moving.y[i];
+        if (dx * dx + dy * dy < arrival2)
+            select_next_waypoint(i);
     }
 }
 
-void NPCManager::move_npc_towards_target(NPCData &npc, const b2Vec2 &target_pos)
+void NPCManager::select_next_waypoint(size_t i)
 {
-    b2Body *body = npc.body;
-    b2Vec2 pos = body->GetPosition();
-    b2Vec2 to_target = target_pos - pos;
-    float dist = to_target.Length();
+    NPCData &npc = npcs[moving.npc[i]];
+    if (npc.target_waypoint < 0 || npc.target_waypoint >= roads.size())
+        return;
 
-    if (dist > 0.0001f)
-    {
-        b2Vec2 dir = (1.0f / dist) * to_target; // normalizar
-        b2Vec2 vel = npc.speed_mps * dir;
-        body->SetLinearVelocity(vel);
+    npc.current_waypoint = npc.target_waypoint;
+    int next = select_route_hop(npc);
+    if (next == RoadGraph::NO_ROUTE)
+        return;
+    npc.target_waypoint = next;
 
-        // Orientar el auto en la dirección del movimiento
-        float movement_angle = std::atan2(vel.y, vel.x);
-        float body_angle = movement_angle - b2_pi / 2.0f; // ajustar por sprite orientado hacia arriba
-        body->SetTransform(pos, body_angle);
-    }
-    else
+    // El rumbo se calcula una vez por tramo, no en cada tick
+    const b2Vec2 &target = roads.position(next);
+    moving.target_x[i] = target.x;
+    moving.target_y[i] = target.y;
+    moving.heading[i] = heading_towards(moving.x[i], moving.y[i], target.x, target.y, moving.heading[i]);
+}
+
+void NPCManager::steer_npcs(float horizon_s)
+{
+    // Solo velocidades: Box2D integra posición y giro en el step, sin
+    // SetTransform (que mueve el proxy del broadphase en cada llamada)
+    const float min_dist2 = NPC_MIN_STEER_DIST_M * NPC_MIN_STEER_DIST_M;
+    const float inv_horizon = 1.0f / horizon_s;
+    for (size_t i = 0; i < moving.size(); ++i)
     {
-        body->SetLinearVelocity(b2Vec2(0, 0));
+        float dx = moving.target_x[i] - moving.x[i];
+        float dy = moving.target_y[i] - moving.y[i];
+        float dist2 = dx * dx + dy * dy;
+
+        b2Vec2 vel(0.0f, 0.0f);
+        float turn = 0.0f;
+        if (dist2 > min_dist2)
+        {
+            float k = moving.speed[i] / std::sqrt(dist2);
+            vel.Set(dx * k, dy * k);
+            // Giro justo para llegar al rumbo del tramo al final de los pasos
+            turn = std::remainder(moving.heading[i] - moving.angle[i], 2.0f * b2_pi) * inv_horizon;
+        }
+
+        b2Body *body = npcs[moving.npc[i]].body;
+        body->SetLinearVelocity(vel);
+        body->SetAngularVelocity(turn);
     }
 }
 
@@ -365,7 +403,7 @@ void NPCManager::add_npc_to_broadcast(std::vector<PlayerPositionUpdate> &broadca
     PlayerPositionUpdate update;
     update.player_id = npc.npc_id; // id negativo para NPC
     update.new_pos = pos;
-    update.car_type = "npc";
+    update.car_type = NPC_CAR;
     update.hp = 100.0f;
     update.collision_flag = false;
     broadcast.push_back(update);
@@ -373,6 +411,15 @@ void NPCManager::add_npc_to_broadcast(std::vector<PlayerPositionUpdate> &broadca
 
 // Utility
 
+float NPCManager::heading_towards(float from_x, float from_y, float to_x, float to_y, float fallback)
+{
+    float dx = to_x - from_x;
+    float dy = to_y - from_y;
+    if (dx * dx + dy * dy <= NPC_MIN_STEER_DIST_M * NPC_MIN_STEER_DIST_M)
+        return fallback;
+    return std::atan2(dy, dx) - b2_pi / 2.0f; // sprite orientado hacia arriba
+}
+
 float NPCManager::normalize_angle(double angle) const
 {
     while (angle < 0.0)
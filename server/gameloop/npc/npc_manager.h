@@ -7,27 +7,30 @@
 #include <box2d/b2_body.h>
 #include <box2d/b2_math.h>
 #include "npc_data.h"
+#include "road_graph.h"
 #include "../../map_layout.h"
 #include "../../../common/messages.h"
 #include "../gameloop_constants.h"
+#include "../world/entity_tag.h"
 
 class NPCManager
 {
 public:
-    NPCManager(b2World &world);
+    // roads es el grafo del mapa en el MapCache, compartido por sus partidas
+    NPCManager(b2World &world, const RoadGraph &roads);
 
     // Inicialización
     void init(const std::vector<MapLayout::ParkedCarData> &parked_data,
-              const std::vector<MapLayout::WaypointData> &waypoints,
               const std::vector<MapLayout::SpawnPointData> &spawn_points);
 
-    // Update del game loop
-    void update();
+    // Update del game loop: steps = pasos de física que se van a simular
+    void update(int steps);
 
     // Reset para nueva carrera
     void reset_velocities();
 
-    // Para broadcast de posiciones
+    // Para broadcast de posiciones. Los estacionados son escenario fijo: su
+    // entrada se arma una vez y se reusa en cada tick
     void add_to_broadcast(std::vector<PlayerPositionUpdate> &broadcast);
 
     // Acceso a NPCs (para bridge handler, etc)
@@ -37,31 +40,41 @@ public:
 private:
     b2World &world;
     std::vector<NPCData> npcs;
-    std::vector<MapLayout::WaypointData> street_waypoints;
+    NPCKernel moving;
+    std::vector<PlayerPositionUpdate> parked_broadcast;
+    // Única fuente de azar del tráfico (semilla de NPCConfig)
+    std::mt19937 rng;
+    const RoadGraph &roads;
     std::vector<MapLayout::SpawnPointData> player_spawn_points;
 
     // Spawn helpers
     void spawn_parked_npcs(const std::vector<MapLayout::ParkedCarData> &parked_data, int &next_negative_id);
     void spawn_moving_npcs(const std::vector<MapLayout::ParkedCarData> &parked_data, int &next_negative_id);
     std::vector<int> get_valid_waypoints_away_from_parked(const std::vector<MapLayout::ParkedCarData> &parked_data);
-    bool should_select_spawn_position(const b2Vec2 &waypoint_pos) const;
     int select_closest_waypoint_connection(int start_waypoint_idx);
     float calculate_initial_npc_angle(const b2Vec2 &spawn_pos, const b2Vec2 &target_pos) const;
     NPCData create_moving_npc(int start_idx, int target_idx, float initial_angle, int &next_negative_id);
+    void add_npc(const NPCData &npc);
+    void add_to_kernel(size_t npc_index, const b2Vec2 &target, float speed, float heading);
 
     // Body creation
     b2Body *create_npc_body(float x_m, float y_m, bool is_static, float angle_rad = 0.0f);
 
-    // Update helpers
-    bool should_select_new_waypoint(NPCData &npc, const b2Vec2 &target_pos);
-    void select_next_waypoint(NPCData &npc, std::mt19937 &gen);
-    void move_npc_towards_target(NPCData &npc, const b2Vec2 &target_pos);
+    // Update helpers (kernel)
+    void gather_kernel_state();
+    void retarget_arrived_npcs();
+    void select_next_waypoint(size_t i);
+    // Rutas: destino al azar y camino más corto precalculado hasta él
+    int pick_destination(int from);
+    int select_route_hop(NPCData &npc);
+    void steer_npcs(float horizon_s);
 
     // Broadcast helper
     void add_npc_to_broadcast(std::vector<PlayerPositionUpdate> &broadcast, NPCData &npc);
 
     // Utility
     float normalize_angle(double angle) const;
+    static float heading_towards(float from_x, float from_y, float to_x, float to_y, float fallback);
 };
 
 #endif 
@@ -0,0 +1,51 @@
+#include "point_kd_tree.h"
+#include <algorithm>
+#include <utility>
+
+PointKdTree::PointKdTree(std::vector<b2Vec2> points)
+    : points(std::move(points))
+{
+    build(0, this->points.size(), true);
+}
+
+bool PointKdTree::any_within(const b2Vec2 &center, float radius) const
+{
+    return any_within(0, points.size(), true, center, radius * radius);
+}
+
+void PointKdTree::build(size_t lo, size_t hi, bool split_x)
+{
+    if (hi - lo < 2)
+        return;
+
+    size_t mid = lo + (hi - lo) / 2;
+    std::nth_element(points.begin() + lo, points.begin() + mid, points.begin() + hi,
+                     [split_x](const b2Vec2 &a, const b2Vec2 &b)
+                     { return split_x ? a.x < b.x : a.y < b.y; });
+    build(lo, mid, !split_x);
+    build(mid + 1, hi, !split_x);
+}
+
+bool PointKdTree::any_within(size_t lo, size_t hi, bool split_x, const b2Vec2 &center, float radius2) const
+{
+    if (lo >= hi)
+        return false;
+
+    size_t mid = lo + (hi - lo) / 2;
+    const b2Vec2 &p = points[mid];
+    float dx = p.x - center.x;
+    float dy = p.y - center.y;
+    if (dx * dx + dy * dy < radius2)
+        return true;
+
+    // Primero el lado del centro; el otro solo si el plano de corte está en el radio
+    float delta = split_x ? center.x - p.x : center.y - p.y;
+    bool near_left = delta < 0.0f;
+    if (near_left ? any_within(lo, mid, !split_x, center, radius2)
+                  : any_within(mid + 1, hi, !split_x, center, radius2))
+        return true;
+    if (delta * delta >= radius2)
+        return false;
+    return near_left ? any_within(mid + 1, hi, !split_x, center, radius2)
+                     : any_within(lo, mid, !split_x, center, radius2);
+}
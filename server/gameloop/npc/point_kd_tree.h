@@ -0,0 +1,25 @@
+#ifndef POINT_KD_TREE_H
+#define POINT_KD_TREE_H
+
+#include <vector>
+#include <box2d/b2_math.h>
+
+// KD-tree de puntos 2D, implícito en un arreglo: el nodo de [lo, hi) es su
+// mediana y los subárboles son las dos mitades. Se arma una vez y solo
+// responde si hay algún punto dentro de un radio.
+class PointKdTree
+{
+public:
+    explicit PointKdTree(std::vector<b2Vec2> points);
+
+    bool any_within(const b2Vec2 &center, float radius) const;
+    bool empty() const { return points.empty(); }
+
+private:
+    std::vector<b2Vec2> points;
+
+    void build(size_t lo, size_t hi, bool split_x);
+    bool any_within(size_t lo, size_t hi, bool split_x, const b2Vec2 &center, float radius2) const;
+};
+
+#endif
@@ -0,0 +1,113 @@
+#include "road_graph.h"
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+void RoadGraph::build(const std::vector<MapLayout::WaypointData> &waypoints)
+{
+    int n = static_cast<int>(waypoints.size());
+    positions.clear();
+    offsets.assign(1, 0);
+    targets.clear();
+    lengths.clear();
+    next_hops.clear();
+
+    positions.reserve(n);
+    offsets.reserve(n + 1);
+    for (const auto &wp : waypoints)
+    {
+        positions.push_back(wp.position);
+        for (int to : wp.connections)
+        {
+            if (to < 0 || to >= n)
+                continue;
+            targets.push_back(to);
+            lengths.push_back((waypoints[to].position - wp.position).Length());
+        }
+        offsets.push_back(static_cast<int>(targets.size()));
+    }
+
+    if (n > 0 && n <= MAX_ROUTED_NODES)
+        build_next_hops();
+}
+
+std::span<const int> RoadGraph::neighbors(int node) const
+{
+    return std::span<const int>(targets).subspan(offsets[node], offsets[node + 1] - offsets[node]);
+}
+
+std::span<const float> RoadGraph::edge_lengths(int node) const
+{
+    return std::span<const float>(lengths).subspan(offsets[node], offsets[node + 1] - offsets[node]);
+}
+
+int RoadGraph::next_hop(int from, int to) const
+{
+    if (next_hops.empty() || from < 0 || to < 0 || from >= size() || to >= size())
+        return NO_ROUTE;
+    Hop hop = next_hops[static_cast<size_t>(from) * size() + to];
+    return hop == NO_HOP ? NO_ROUTE : hop;
+}
+
+void RoadGraph::build_next_hops()
+{
+    int n = size();
+
+    // Aristas invertidas en CSR: para cada nodo, de quién se llega a él
+    std::vector<int> rev_offsets(n + 1, 0);
+    for (int to : targets)
+        ++rev_offsets[to + 1];
+    for (int i = 0; i < n; ++i)
+        rev_offsets[i + 1] += rev_offsets[i];
+
+    std::vector<int> rev_sources(targets.size());
+    std::vector<float> rev_lengths(targets.size());
+    std::vector<int> fill(rev_offsets.begin(), rev_offsets.end() - 1);
+    for (int from = 0; from < n; ++from)
+    {
+        for (int e = offsets[from]; e < offsets[from + 1]; ++e)
+        {
+            int slot = fill[targets[e]]++;
+            rev_sources[slot] = from;
+            rev_lengths[slot] = lengths[e];
+        }
+    }
+
+    next_hops.assign(static_cast<size_t>(n) * n, NO_HOP);
+    for (int to = 0; to < n; ++to)
+        fill_routes_to(to, rev_offsets, rev_sources, rev_lengths);
+}
+
+void RoadGraph::fill_routes_to(int to, const std::vector<int> &rev_offsets,
+                               const std::vector<int> &rev_sources, const std::vector<float> &rev_lengths)
+{
+    int n = size();
+    std::vector<float> dist(n, std::numeric_limits<float>::infinity());
+    using Item = std::pair<float, int>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+
+    dist[to] = 0.0f;
+    next_hops[static_cast<size_t>(to) * n + to] = static_cast<Hop>(to);
+    open.push({0.0f, to});
+    while (!open.empty())
+    {
+        auto [d, node] = open.top();
+        open.pop();
+        if (d > dist[node])
+            continue;
+
+        // node ya tiene su distancia final: quien llega a node sigue por él
+        for (int e = rev_offsets[node]; e < rev_offsets[node + 1]; ++e)
+        {
+            int from = rev_sources[e];
+            float candidate = d + rev_lengths[e];
+            if (candidate < dist[from])
+            {
+                dist[from] = candidate;
+                next_hops[static_cast<size_t>(from) * n + to] = static_cast<Hop>(node);
+                open.push({candidate, from});
+            }
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef ROAD_GRAPH_H
+#define ROAD_GRAPH_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "../../map_layout.h"
+
+// Grafo de calles del tráfico, armado una vez por mapa a partir de los
+// waypoints. La adyacencia va en formato CSR (offsets + destinos + largos) y
+// una tabla de próximo salto por par (origen, destino) deja las rutas más
+// cortas precalculadas: seguir una ruta cuesta una lectura por waypoint.
+class RoadGraph
+{
+public:
+    static constexpr int NO_ROUTE = -1;
+
+    // Las conexiones a waypoints inexistentes se descartan
+    void build(const std::vector<MapLayout::WaypointData> &waypoints);
+
+    int size() const { return static_cast<int>(positions.size()); }
+    const b2Vec2 &position(int node) const { return positions[node]; }
+
+    // Vecinos de node y el largo (en metros) de cada arista, en paralelo
+    std::span<const int> neighbors(int node) const;
+    std::span<const float> edge_lengths(int node) const;
+
+    // Próximo waypoint en el camino más corto de from a to, NO_ROUTE si no
+    // hay camino o si el grafo es demasiado grande para tener tabla
+    int next_hop(int from, int to) const;
+    bool has_routes() const { return !next_hops.empty(); }
+
+private:
+    // Con índices de 16 bits la tabla de Liberty City (~650 nodos) ocupa < 1 MB
+    using Hop = uint16_t;
+    static constexpr Hop NO_HOP = UINT16_MAX;
+    static constexpr int MAX_ROUTED_NODES = 4096;
+
+    std::vector<b2Vec2> positions;
+    std::vector<int> offsets; // aristas de i: [offsets[i], offsets[i + 1])
+    std::vector<int> targets;
+    std::vector<float> lengths;
+    std::vector<Hop> next_hops; // [from * size() + to]
+
+    void build_next_hops();
+    // Dijkstra hacia 'to' sobre las aristas invertidas
+    void fill_routes_to(int to, const std::vector<int> &rev_offsets,
+                        const std::vector<int> &rev_sources, const std::vector<float> &rev_lengths);
+};
+
+#endif
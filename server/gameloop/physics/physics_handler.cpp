@@ -15,13 +15,21 @@ b2Vec2 PhysicsHandler::get_forward_velocity(b2Body *body)
     return b2Dot(currentForwardNormal, body->GetLinearVelocity()) * currentForwardNormal;
 }
 
+const CarPhysics &PhysicsHandler::physics_of(const PlayerData &player_data, CarPhysicsConfig &physics_config)
+{
+    // Puntero cacheado al elegir auto: evita hashear el nombre en cada tick
+    if (player_data.car.physics)
+        return *player_data.car.physics;
+    return physics_config.getCarPhysics(GREEN_CAR);
+}
+
 void PhysicsHandler::update_friction_for_player(PlayerData &player_data, CarPhysicsConfig &physics_config)
 {
     b2Body *body = player_data.body;
     if (!body)
         return;
 
-    const CarPhysics &car_physics = physics_config.getCarPhysics(player_data.car.car_name);
+    const CarPhysics &car_physics = physics_of(player_data, physics_config);
 
     // Impulso lateral para reducir el deslizamiento lateral (limitado para permitir derrapes)
     b2Vec2 impulse = body->GetMass() * -get_lateral_velocity(body);
@@ -84,7 +92,7 @@ void PhysicsHandler::update_drive_for_player(PlayerData &player_data, CarPhysics
     if (!body)
         return;
 
-    CarPhysics car_physics = physics_config.getCarPhysics(player_data.car.car_name);
+    CarPhysics car_physics = physics_of(player_data, physics_config);
     // Sobreescribir con valores upgradeados del player
     car_physics.max_speed = player_data.car.speed;
     car_physics.max_acceleration = player_data.car.acceleration;
@@ -23,6 +23,7 @@ public:
 
 private:
     // Helpers internos
+    static const CarPhysics &physics_of(const PlayerData &player_data, CarPhysicsConfig &physics_config);
     static float calculate_desired_speed(bool want_up, bool want_down, const CarPhysics &car_physics);
     static void apply_forward_drive_force(b2Body *body, float desired_speed, const CarPhysics &car_physics);
     static void apply_steering_torque(b2Body *body, bool want_left, bool want_right, float torque);
@@ -1,5 +1,4 @@
 #include "player_manager.h"
-#include "../bridge/bridge_handler.h"
 #include "../physics/physics_handler.h"
 #include "../gameloop_constants.h"
 #include "../../../common/constants.h"
@@ -9,8 +8,8 @@
 
 PlayerManager::PlayerManager(
     std::mutex &players_mutex,
-    std::unordered_map<int, PlayerData> &players_ref,
-    std::unordered_map<int, std::shared_ptr<Queue<ServerMessage>>> &messengers,
+    PlayerStore &players_ref,
+    std::unordered_map<int, std::shared_ptr<Outbox>> &messengers,
     std::vector<int> &order,
     WorldManager &world,
     CarPhysicsConfig &physics)
@@ -45,7 +44,7 @@ void PlayerManager::remove_from_player_order(int client_id)
         player_order.erase(order_it);
 }
 
-PlayerData PlayerManager::create_default_player_data(int spawn_idx,
+PlayerData PlayerManager::create_default_player_data(int id, int spawn_idx,
                                                      const std::vector<MapLayout::SpawnPointData> &spawn_points)
 {
     const MapLayout::SpawnPointData &spawn = spawn_points[spawn_idx];
@@ -53,32 +52,38 @@ PlayerData PlayerManager::create_default_player_data(int spawn_idx,
 
     Position pos = Position{false, spawn.x, spawn.y, not_horizontal, not_vertical, spawn.angle};
     PlayerData player_data;
-    player_data.body = world_manager.create_player_body(spawn.x, spawn.y, pos.angle, GREEN_CAR);
-    player_data.state = MOVE_UP_RELEASED_STR;
-    player_data.car = CarInfo{GREEN_CAR, car_phys.max_speed, car_phys.max_acceleration, car_phys.max_hp, car_phys.collision_damage_multiplier, car_phys.torque};
+    player_data.body = world_manager.create_player_body(id, spawn.x, spawn.y, pos.angle, GREEN_CAR);
+    player_data.state = InputAction::MOVE_UP_RELEASED;
+    player_data.car = CarInfo{&car_phys, car_phys.max_speed, car_phys.max_acceleration, car_phys.max_hp, car_phys.collision_damage_multiplier, car_phys.torque};
     player_data.position = pos;
     player_data.next_checkpoint = 0;
-    player_data.lap_start_time = std::chrono::steady_clock::now();
     player_data.race_finished = false;
     player_data.god_mode = false;
 
     return player_data;
 }
 
+PlayerRecord PlayerManager::create_default_player_record() const
+{
+    PlayerRecord record;
+    record.car_name = GREEN_CAR;
+    record.lap_start_time = std::chrono::steady_clock::now();
+    return record;
+}
+
 void PlayerManager::cleanup_player_data(int client_id)
 {
-    auto it = players.find(client_id);
-    if (it == players.end())
+    PlayerData *pd = players.find(client_id);
+    if (!pd)
         throw std::runtime_error("player not found");
 
-    PlayerData &pd = it->second;
-    world_manager.safe_destroy_body(pd.body);
+    world_manager.safe_destroy_body(pd->body);
 
     players_messanger.erase(client_id);
-    players.erase(it);
+    players.erase(client_id);
 }
 
-void PlayerManager::add_player(int id, std::shared_ptr<Queue<ServerMessage>> player_outbox,
+void PlayerManager::add_player(int id, std::shared_ptr<Outbox> player_outbox,
                                const std::vector<MapLayout::SpawnPointData> &spawn_points)
 {
     std::lock_guard<std::mutex> lk(players_map_mutex);
@@ -86,9 +91,9 @@ void PlayerManager::add_player(int id, std::shared_ptr<Queue<ServerMessage>> pla
         return;
 
     int spawn_idx = add_player_to_order(id);
-    PlayerData player_data = create_default_player_data(spawn_idx, spawn_points);
+    PlayerData player_data = create_default_player_data(id, spawn_idx, spawn_points);
 
-    players[id] = player_data;
+    players.insert(id, player_data, create_default_player_record());
     players_messanger[id] = player_outbox;
 }
 
@@ -96,6 +101,9 @@ void PlayerManager::remove_player(int client_id, GameState game_state,
                                   const std::vector<MapLayout::SpawnPointData> &spawn_points)
 {
     std::lock_guard<std::mutex> lk(players_map_mutex);
+    // Lo pueden sacar tanto su LEAVE_GAME como la partida al desconectarlo
+    if (!players.contains(client_id))
+        return;
 
     cleanup_player_data(client_id);
     remove_from_player_order(client_id);
@@ -107,7 +115,7 @@ void PlayerManager::remove_player(int client_id, GameState game_state,
 bool PlayerManager::has_player(int client_id) const
 {
     std::lock_guard<std::mutex> lk(players_map_mutex);
-    return players.find(client_id) != players.end();
+    return players.contains(client_id);
 }
 
 size_t PlayerManager::get_player_count() const
@@ -121,16 +129,17 @@ void PlayerManager::reposition_remaining_players(const std::vector<MapLayout::Sp
     for (size_t i = 0; i < player_order.size(); ++i)
     {
         int player_id = player_order[i];
-        auto player_it = players.find(player_id);
-        if (player_it == players.end())
+        PlayerData *player = players.find(player_id);
+        if (!player)
             continue;
 
-        PlayerData &player_data = player_it->second;
+        PlayerData &player_data = *player;
+        PlayerRecord &record = *players.find_record(player_id);
         const MapLayout::SpawnPointData &spawn = spawn_points[i];
 
         world_manager.safe_destroy_body(player_data.body);
         Position new_pos{false, spawn.x, spawn.y, not_horizontal, not_vertical, spawn.angle};
-        player_data.body = world_manager.create_player_body(spawn.x, spawn.y, new_pos.angle, player_data.car.car_name);
+        player_data.body = world_manager.create_player_body(player_id, spawn.x, spawn.y, new_pos.angle, record.car_name);
         player_data.position = new_pos;
     }
 }
@@ -140,26 +149,28 @@ void PlayerManager::reset_all_players_to_lobby(const std::vector<MapLayout::Spaw
     for (size_t i = 0; i < player_order.size(); ++i)
     {
         int player_id = player_order[i];
-        auto player_it = players.find(player_id);
-        if (player_it == players.end())
+        PlayerData *player = players.find(player_id);
+        if (!player)
             continue;
 
-        PlayerData &player_data = player_it->second;
+        PlayerData &player_data = *player;
+        PlayerRecord &record = *players.find_record(player_id);
         const MapLayout::SpawnPointData &spawn = spawn_points[i];
 
         world_manager.safe_destroy_body(player_data.body);
         Position new_pos{false, spawn.x, spawn.y, not_horizontal, not_vertical, spawn.angle};
-        player_data.body = world_manager.create_player_body(spawn.x, spawn.y, new_pos.angle, player_data.car.car_name);
+        player_data.body = world_manager.create_player_body(player_id, spawn.x, spawn.y, new_pos.angle, record.car_name);
         player_data.position = new_pos;
 
         player_data.next_checkpoint = 0;
         player_data.race_finished = false;
         player_data.is_dead = false;
         player_data.god_mode = false;
-        player_data.lap_start_time = std::chrono::steady_clock::now();
+        record.lap_start_time = std::chrono::steady_clock::now();
 
         // Reseteo HP
-        const CarPhysics &car_physics = physics_config.getCarPhysics(player_data.car.car_name);
+        const CarPhysics &car_physics = physics_config.getCarPhysics(record.car_name);
+        player_data.car.physics = &car_physics;
         player_data.car.hp = car_physics.max_hp;
     }
 }
@@ -167,7 +178,7 @@ void PlayerManager::reset_all_players_to_lobby(const std::vector<MapLayout::Spaw
 void PlayerManager::update_body_positions()
 {
     std::lock_guard<std::mutex> lk(players_map_mutex);
-    for (auto &[id, player_data] : players)
+    for (auto [id, player_data, record] : players)
     {
         // Si el jugador está muerto, no aplicar fuerzas
         if (player_data.is_dead)
@@ -201,6 +212,7 @@ void PlayerManager::update_body_positions()
 
 void PlayerManager::add_player_to_broadcast(std::vector<PlayerPositionUpdate> &broadcast,
                                             int player_id, PlayerData &player_data,
+                                            const PlayerRecord &record,
                                             const std::vector<b2Vec2> &checkpoint_centers)
 {
     // Si el jugador está muerto y no tiene body, no lo agregamos al broadcast
@@ -214,24 +226,21 @@ void PlayerManager::add_player_to_broadcast(std::vector<PlayerPositionUpdate> &b
         player_data.position.new_X = position.x * SCALE;
         player_data.position.new_Y = position.y * SCALE;
         player_data.position.angle = PhysicsHandler::normalize_angle(body->GetAngle());
-
-        // Actualizar el estado del puente ANTES de copiar la posición
-        BridgeHandler::update_bridge_state(player_data);
     }
 
     PlayerPositionUpdate update;
     update.player_id = player_id;
     update.new_pos = player_data.position;
-    update.car_type = player_data.car.car_name;
+    update.car_type = record.car_name;
     update.hp = player_data.car.hp;
     update.collision_flag = player_data.collision_this_frame;
     update.is_stopping = player_data.is_stopping;
 
     // Enviar niveles de mejora
-    update.upgrade_speed = player_data.upgrades.speed;
-    update.upgrade_acceleration = player_data.upgrades.acceleration;
-    update.upgrade_handling = player_data.upgrades.handling;
-    update.upgrade_durability = player_data.upgrades.durability;
+    update.upgrade_speed = record.upgrades.speed;
+    update.upgrade_acceleration = record.upgrades.acceleration;
+    update.upgrade_handling = record.upgrades.handling;
+    update.upgrade_durability = record.upgrades.durability;
 
     // Solo enviar checkpoints si el jugador no ha terminado la carrera
     if (!player_data.race_finished && !checkpoint_centers.empty())
@@ -257,8 +266,8 @@ void PlayerManager::update_player_positions(std::vector<PlayerPositionUpdate> &b
 {
     std::lock_guard<std::mutex> lk(players_map_mutex);
 
-    for (auto &[id, player_data] : players)
+    for (auto [id, player_data, record] : players)
     {
-        add_player_to_broadcast(broadcast, id, player_data, checkpoint_centers);
+        add_player_to_broadcast(broadcast, id, player_data, record, checkpoint_centers);
     }
 }
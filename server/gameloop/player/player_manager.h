@@ -5,12 +5,13 @@
 #include <vector>
 #include <mutex>
 #include <memory>
-#include "../../PlayerData.h"
+#include "../../player_store.h"
 #include "../../map_layout.h"
 #include "../../car_physics_config.h"
 #include "../../game_state.h"
 #include "../world/world_manager.h"
 #include "../../../common/messages.h"
+#include "../../outbox.h"
 #include "../../../common/queue.h"
 #include "../gameloop_constants.h"
 
@@ -19,14 +20,14 @@ class PlayerManager
 public:
     PlayerManager(
         std::mutex &players_mutex,
-        std::unordered_map<int, PlayerData> &players,
-        std::unordered_map<int, std::shared_ptr<Queue<ServerMessage>>> &messengers,
+        PlayerStore &players,
+        std::unordered_map<int, std::shared_ptr<Outbox>> &messengers,
         std::vector<int> &player_order,
         WorldManager &world_manager,
         CarPhysicsConfig &physics_config);
 
     // Ciclo de vida del player
-    void add_player(int id, std::shared_ptr<Queue<ServerMessage>> player_outbox,
+    void add_player(int id, std::shared_ptr<Outbox> player_outbox,
                     const std::vector<MapLayout::SpawnPointData> &spawn_points);
     void remove_player(int client_id, GameState game_state,
                        const std::vector<MapLayout::SpawnPointData> &spawn_points);
@@ -47,8 +48,8 @@ public:
 
 private:
     std::mutex &players_map_mutex;
-    std::unordered_map<int, PlayerData> &players;
-    std::unordered_map<int, std::shared_ptr<Queue<ServerMessage>>> &players_messanger;
+    PlayerStore &players;
+    std::unordered_map<int, std::shared_ptr<Outbox>> &players_messanger;
     std::vector<int> &player_order;
     WorldManager &world_manager;
     CarPhysicsConfig &physics_config;
@@ -56,11 +57,13 @@ private:
     // Helpers internos
     int add_player_to_order(int player_id);
     void remove_from_player_order(int client_id);
-    PlayerData create_default_player_data(int spawn_idx,
+    PlayerData create_default_player_data(int id, int spawn_idx,
                                           const std::vector<MapLayout::SpawnPointData> &spawn_points);
+    PlayerRecord create_default_player_record() const;
     void cleanup_player_data(int client_id);
     void add_player_to_broadcast(std::vector<PlayerPositionUpdate> &broadcast,
                                  int player_id, PlayerData &player_data,
+                                 const PlayerRecord &record,
                                  const std::vector<b2Vec2> &checkpoint_centers);
 
 
@@ -1,15 +1,17 @@
 #include "race_manager.h"
 #include "../gameloop_constants.h"
+#include "../bridge/bridge_handler.h"
 #include <iostream>
 
 void RaceManager::complete_player_race(
     PlayerData &player_data,
+    PlayerRecord &record,
     std::atomic<bool> &pending_race_reset,
-    const std::unordered_map<int, PlayerData> &players)
+    const PlayerStore &players)
 {
     auto lap_end_time = std::chrono::steady_clock::now();
     auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                          lap_end_time - player_data.lap_start_time)
+                          lap_end_time - record.lap_start_time)
                           .count();
 
     player_data.race_finished = true;
@@ -22,13 +24,13 @@ void RaceManager::complete_player_race(
     if (round_idx >= 0 && round_idx < TOTAL_ROUNDS)
     {
         // Si ya hay penalizaciones acumuladas en esta ronda, preservarlas
-        existing_penalization = player_data.round_times_ms[round_idx];
+        existing_penalization = record.round_times_ms[round_idx];
         uint32_t new_total_time = static_cast<uint32_t>(elapsed_ms) + existing_penalization;
 
-        player_data.round_times_ms[round_idx] = new_total_time;
+        record.round_times_ms[round_idx] = new_total_time;
     }
     player_data.rounds_completed = std::min(player_data.rounds_completed + 1, TOTAL_ROUNDS);
-    player_data.total_time_ms += static_cast<uint32_t>(elapsed_ms);
+    record.total_time_ms += static_cast<uint32_t>(elapsed_ms);
 
     player_data.god_mode = true;
 
@@ -37,7 +39,7 @@ void RaceManager::complete_player_race(
 }
 
 void RaceManager::check_race_completion(
-    const std::unordered_map<int, PlayerData> &players,
+    const PlayerStore &players,
     std::atomic<bool> &pending_race_reset)
 {
     // Asume que ya estamos bajo players_map_mutex lock
@@ -46,7 +48,7 @@ void RaceManager::check_race_completion(
     int finished_or_dead_count = 0;
     int total_players = static_cast<int>(players.size());
 
-    for (const auto &[id, player_data] : players)
+    for (auto [id, player_data, record] : players)
     {
         // Contar jugadores que terminaron la carrera O murieron
         if (player_data.race_finished || player_data.is_dead)
@@ -65,10 +67,10 @@ void RaceManager::check_race_completion(
 }
 
 void RaceManager::reset_players_for_race_start(
-    std::unordered_map<int, PlayerData> &players,
+    PlayerStore &players,
     CarPhysicsConfig &physics_config)
 {
-    for (auto &[id, player_data] : players)
+    for (auto [id, player_data, record] : players)
     {
         if (!player_data.body)
             continue;
@@ -82,17 +84,19 @@ void RaceManager::reset_players_for_race_start(
         player_data.is_dead = false;
         player_data.god_mode = false;
         player_data.position.on_bridge = false;
+        // Si el auto quedó sobre un sensor, vuelve a la capa que le corresponde
+        BridgeHandler::update_bridge_state(player_data);
         player_data.position.direction_x = not_horizontal;
         player_data.position.direction_y = not_vertical;
 
         // Reset HP
-        const CarPhysics &car_physics = physics_config.getCarPhysics(player_data.car.car_name);
+        const CarPhysics &car_physics = physics_config.getCarPhysics(record.car_name);
         player_data.car.hp = car_physics.max_hp;
     }
 }
 
 void RaceManager::check_round_timeout(
-    std::unordered_map<int, PlayerData> &players,
+    PlayerStore &players,
     GameState game_state,
     bool &round_timeout_checked,
     const std::chrono::steady_clock::time_point &round_start_time,
@@ -108,7 +112,7 @@ void RaceManager::check_round_timeout(
     if (elapsed_ms >= ROUND_TIME_LIMIT_MS)
     {
         // Penalizar a todos los jugadores que NO han terminado la ronda
-        for (auto &[id, player_data] : players)
+        for (auto [id, player_data, record] : players)
         {
             if (!player_data.race_finished && !player_data.is_dead)
             {
@@ -118,11 +122,11 @@ void RaceManager::check_round_timeout(
 
                 if (round_idx >= 0 && round_idx < TOTAL_ROUNDS)
                 {
-                    uint32_t existing_time = player_data.round_times_ms[round_idx];
-                    player_data.round_times_ms[round_idx] = existing_time + timeout_penalty;
-                    player_data.total_time_ms = player_data.round_times_ms[0] +
-                                                player_data.round_times_ms[1] +
-                                                player_data.round_times_ms[2];
+                    uint32_t existing_time = record.round_times_ms[round_idx];
+                    record.round_times_ms[round_idx] = existing_time + timeout_penalty;
+                    record.total_time_ms = record.round_times_ms[0] +
+                                    record.round_times_ms[1] +
+                                    record.round_times_ms[2];
                 }
 
                 player_data.race_finished = true;
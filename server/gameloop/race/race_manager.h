@@ -4,7 +4,7 @@
 #include <unordered_map>
 #include <chrono>
 #include <atomic>
-#include "../../PlayerData.h"
+#include "../../player_store.h"
 #include "../../car_physics_config.h"
 #include "../../game_state.h"
 #include "../gameloop_constants.h"
@@ -16,25 +16,26 @@ public:
     // Retorna true si se debe verificar el fin de la carrera
     static void complete_player_race(
         PlayerData &player_data,
+        PlayerRecord &record,
         std::atomic<bool> &pending_race_reset,
-        const std::unordered_map<int, PlayerData> &players);
+        const PlayerStore &players);
 
     // Verifica si todos los jugadores terminaron o murieron
     // Si es así, marca pending_race_reset = true
     static void check_race_completion(
-        const std::unordered_map<int, PlayerData> &players,
+        const PlayerStore &players,
         std::atomic<bool> &pending_race_reset);
 
     // Resetea el estado de los jugadores para el inicio de una nueva carrera
     // (velocidades, checkpoint, HP, etc.) - NO recrea los bodies
     static void reset_players_for_race_start(
-        std::unordered_map<int, PlayerData> &players,
+        PlayerStore &players,
         CarPhysicsConfig &physics_config);
 
     // Verifica si se cumplió el timeout de la ronda (10 minutos)
     // Penaliza a los jugadores que no terminaron y marca pending_race_reset
     static void check_round_timeout(
-        std::unordered_map<int, PlayerData> &players,
+        PlayerStore &players,
         GameState game_state,
         bool &round_timeout_checked,
         const std::chrono::steady_clock::time_point &round_start_time,
@@ -5,40 +5,30 @@
 #include "install_paths.h"
 
 SetupManager::SetupManager(
-    uint8_t map_id,
+    const CompiledMap &compiled_map,
     MapLayout &map_layout,
     WorldManager &world_manager,
     NPCManager &npc_manager,
-    std::array<std::string, 3> &checkpoint_sets,
-    std::vector<MapLayout::SpawnPointData> &spawn_points,
-    std::unordered_map<b2Fixture *, int> &checkpoint_fixtures,
+    std::vector<b2Body *> &checkpoint_bodies,
     std::vector<b2Vec2> &checkpoint_centers)
-    : map_id(map_id),
+    : compiled_map(compiled_map),
       map_layout(map_layout),
       world_manager(world_manager),
       npc_manager(npc_manager),
-      checkpoint_sets(checkpoint_sets),
-      spawn_points(spawn_points),
-      checkpoint_fixtures(checkpoint_fixtures),
+      checkpoint_bodies(checkpoint_bodies),
       checkpoint_centers(checkpoint_centers)
 {
 }
 
 void SetupManager::setup_world(int current_round)
 {
-    std::vector<MapLayout::ParkedCarData> parked_data;
-    std::vector<MapLayout::WaypointData> street_waypoints;
-    
     setup_map_layout();
     load_checkpoints(current_round);
     setup_npc_config();
 
-    uint8_t safe_map_id = (map_id < MAP_COUNT) ? map_id : 0;
-    map_layout.extract_map_npc_data(MAP_JSON_PATHS[safe_map_id], street_waypoints, parked_data);
-    
-    if (!parked_data.empty() || !street_waypoints.empty())
+    if (!compiled_map.parked_cars.empty() || !compiled_map.waypoints.empty())
     {
-        npc_manager.init(parked_data, street_waypoints, spawn_points);
+        npc_manager.init(compiled_map.parked_cars, compiled_map.spawn_points);
     }
 }
 
@@ -50,17 +40,15 @@ void SetupManager::setup_npc_config()
 
 void SetupManager::setup_map_layout()
 {
-    uint8_t safe_map_id = (map_id < MAP_COUNT) ? map_id : 0;
-    map_layout.create_map_layout(MAP_JSON_PATHS[safe_map_id]);
+    map_layout.create_map_layout(compiled_map.static_fixtures);
 }
 
 void SetupManager::load_checkpoints(int current_round)
 {
     CheckpointHandler::load_round_checkpoints(
         current_round,
-        checkpoint_sets,
+        compiled_map.checkpoints,
         world_manager.get_world(),
-        map_layout,
         checkpoint_centers,
-        checkpoint_fixtures);
+        checkpoint_bodies);
 }
@@ -7,7 +7,7 @@
 #include <unordered_map>
 #include <box2d/b2_fixture.h>
 #include <box2d/b2_math.h>
-#include "../../map_layout.h"
+#include "../../map_cache.h"
 #include "../world/world_manager.h"
 #include "../npc/npc_manager.h"
 #include "../checkpoint/checkpoint_handler.h"
@@ -16,13 +16,11 @@ class SetupManager
 {
 public:
     SetupManager(
-        uint8_t map_id,
+        const CompiledMap &compiled_map,
         MapLayout &map_layout,
         WorldManager &world_manager,
         NPCManager &npc_manager,
-        std::array<std::string, 3> &checkpoint_sets,
-        std::vector<MapLayout::SpawnPointData> &spawn_points,
-        std::unordered_map<b2Fixture *, int> &checkpoint_fixtures,
+        std::vector<b2Body *> &checkpoint_bodies,
         std::vector<b2Vec2> &checkpoint_centers);
 
     // Setup del world
@@ -34,13 +32,11 @@ public:
     void load_checkpoints(int current_round);
 
 private:
-    uint8_t map_id;
+    const CompiledMap &compiled_map;
     MapLayout &map_layout;
     WorldManager &world_manager;
     NPCManager &npc_manager;
-    std::array<std::string, 3> &checkpoint_sets;
-    std::vector<MapLayout::SpawnPointData> &spawn_points;
-    std::unordered_map<b2Fixture *, int> &checkpoint_fixtures;
+    std::vector<b2Body *> &checkpoint_bodies;
     std::vector<b2Vec2> &checkpoint_centers;
 };
 
@@ -0,0 +1,79 @@
+#include "snapshot_pacer.h"
+#include <algorithm>
+
+SnapshotPacer::SnapshotPacer(int tick_rate_hz, int snapshot_rate_hz)
+    : tick_rate_hz(std::max(tick_rate_hz, 1)),
+      snapshot_rate_hz(snapshot_rate_hz),
+      // El primer tick siempre manda
+      credit(this->tick_rate_hz - 1),
+      ticks_since_snapshot(0),
+      last_interval_ticks(1)
+{
+}
+
+int SnapshotPacer::effective_rate(int rate) const
+{
+    if (rate <= 0 || rate > tick_rate_hz)
+        return tick_rate_hz;
+    return rate;
+}
+
+bool SnapshotPacer::tick()
+{
+    // Acumula rate por tick y manda cada vez que junta tick_rate: exacto en enteros
+    credit += effective_rate(snapshot_rate_hz.load(std::memory_order_relaxed));
+    ++ticks_since_snapshot;
+    if (credit < tick_rate_hz)
+        return false;
+    credit -= tick_rate_hz;
+    last_interval_ticks = ticks_since_snapshot;
+    ticks_since_snapshot = 0;
+    return true;
+}
+
+float SnapshotPacer::interval_seconds() const
+{
+    return static_cast<float>(last_interval_ticks) / static_cast<float>(tick_rate_hz);
+}
+
+void SnapshotPacer::set_rate(int rate)
+{
+    snapshot_rate_hz.store(rate, std::memory_order_relaxed);
+}
+
+int SnapshotPacer::get_rate() const
+{
+    return effective_rate(snapshot_rate_hz.load(std::memory_order_relaxed));
+}
+
+ClientSnapshotRate::ClientSnapshotRate()
+    : current_divisor(1),
+      skipped(0),
+      clean_sends(0),
+      replaced_seen(0)
+{
+}
+
+bool ClientSnapshotRate::due(uint64_t replaced_snapshots, int max_divisor, int recover_after)
+{
+    max_divisor = std::max(max_divisor, 1);
+    if (replaced_snapshots > replaced_seen)
+    {
+        replaced_seen = replaced_snapshots;
+        current_divisor = std::min(current_divisor * 2, max_divisor);
+        clean_sends = 0;
+    }
+    // La frecuencia de la partida pudo bajar mientras tanto
+    current_divisor = std::min(current_divisor, max_divisor);
+
+    if (++skipped < current_divisor)
+        return false;
+    skipped = 0;
+
+    if (current_divisor > 1 && ++clean_sends >= recover_after)
+    {
+        current_divisor /= 2;
+        clean_sends = 0;
+    }
+    return true;
+}
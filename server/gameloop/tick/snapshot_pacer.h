@@ -0,0 +1,59 @@
+#ifndef SNAPSHOT_PACER_H
+#define SNAPSHOT_PACER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Decide en qué ticks de la simulación se manda el snapshot de posiciones, para
+// que la red vaya a su propia frecuencia (p. ej. 60 Hz de física y 30 Hz de
+// snapshots). Reparte los snapshots lo más parejo posible entre los ticks,
+// también cuando las frecuencias no son múltiplos (60/25 = 3, 2, 3, 2...).
+class SnapshotPacer
+{
+public:
+    // snapshot_rate_hz 0 o mayor que tick_rate_hz: un snapshot por tick
+    SnapshotPacer(int tick_rate_hz, int snapshot_rate_hz);
+
+    // Avanza un tick; true si en este tick toca mandar snapshot
+    bool tick();
+    // Tiempo de simulación que cubre el último snapshot (desde el anterior)
+    float interval_seconds() const;
+
+    // Se puede cambiar desde otro thread (consola) mientras corre la partida
+    void set_rate(int snapshot_rate_hz);
+    // Frecuencia efectiva en Hz
+    int get_rate() const;
+
+private:
+    int effective_rate(int snapshot_rate_hz) const;
+
+    int tick_rate_hz;
+    std::atomic<int> snapshot_rate_hz;
+    int credit;
+    int ticks_since_snapshot;
+    int last_interval_ticks;
+};
+
+// Frecuencia de snapshots de un cliente en particular. Si el outbox pisó
+// snapshots que no llegó a mandar (la conexión no da abasto), se le manda uno
+// de cada 2, 4... snapshots de la partida; tras recover_after envíos sin
+// pisados se vuelve a duplicar. Así además no se codifica lo que se iba a tirar.
+class ClientSnapshotRate
+{
+public:
+    ClientSnapshotRate();
+
+    // Se llama en cada snapshot de la partida con el contador de pisados del
+    // outbox; true si a este cliente le toca
+    bool due(uint64_t replaced_snapshots, int max_divisor, int recover_after);
+    // El cliente recibe uno de cada divisor() snapshots
+    int divisor() const { return current_divisor; }
+
+private:
+    int current_divisor;
+    int skipped;
+    int clean_sends;
+    uint64_t replaced_seen;
+};
+
+#endif
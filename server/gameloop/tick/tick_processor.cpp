@@ -1,15 +1,19 @@
 #include "tick_processor.h"
+#include "../../server_config.h"
 #include <iostream>
 
 TickProcessor::TickProcessor(
     std::mutex &players_map_mutex,
-    std::unordered_map<int, PlayerData> &players,
+    PlayerStore &players,
     GameStateManager &state_manager,
     PlayerManager &player_manager,
     NPCManager &npc_manager,
     WorldManager &world_manager,
     BroadcastManager &broadcast_manager,
-    std::vector<b2Vec2> &checkpoint_centers)
+    InterestManager &interest_manager,
+    ContactHandler &contact_handler,
+    std::vector<b2Vec2> &checkpoint_centers,
+    TickProfiler &profiler)
     : players_map_mutex(players_map_mutex),
       players(players),
       state_manager(state_manager),
@@ -17,10 +21,24 @@ TickProcessor::TickProcessor(
       npc_manager(npc_manager),
       world_manager(world_manager),
       broadcast_manager(broadcast_manager),
-      checkpoint_centers(checkpoint_centers)
+      interest_manager(interest_manager),
+      contact_handler(contact_handler),
+      checkpoint_centers(checkpoint_centers),
+      profiler(profiler),
+      snapshot_pacer(ServerConfig::getInstance().getTickRateHz(), ServerConfig::getInstance().getSnapshotRateHz())
 {
 }
 
+void TickProcessor::set_snapshot_rate(int snapshot_rate_hz)
+{
+    snapshot_pacer.set_rate(snapshot_rate_hz);
+}
+
+int TickProcessor::get_snapshot_rate() const
+{
+    return snapshot_pacer.get_rate();
+}
+
 void TickProcessor::process(GameState state, float &acum)
 {
     switch (state)
@@ -54,19 +72,21 @@ void TickProcessor::process_playing(float &acum)
         state_manager.get_round_start_time(),
         state_manager.get_pending_race_reset());
 
-    // Resetear flags de colisión al principio de cada frame
-    for (auto &entry : players)
     {
-        entry.second.collision_this_frame = false;
+        TickProfiler::Scope phase(profiler, TickPhase::NPC_UPDATE);
+        npc_manager.update(static_cast<int>(acum / FPS));
     }
-
-    npc_manager.update();
-    player_manager.update_body_positions();
-
-    while (acum >= FPS)
     {
-        world_manager.step(FPS, VELOCITY_ITERS, COLLISION_ITERS);
-        acum -= FPS;
+        TickProfiler::Scope phase(profiler, TickPhase::BODY_SYNC);
+        player_manager.update_body_positions();
+    }
+    {
+        TickProfiler::Scope phase(profiler, TickPhase::PHYSICS_STEP);
+        while (acum >= FPS)
+        {
+            world_manager.step(FPS, VELOCITY_ITERS, COLLISION_ITERS);
+            acum -= FPS;
+        }
     }
 
     flush_deferred_operations();
@@ -78,41 +98,37 @@ void TickProcessor::process_lobby()
     if (players.empty())
         return;
 
-    // Resetear flags de colisión al principio de cada frame
-    for (auto &entry : players)
-    {
-        entry.second.collision_this_frame = false;
-    }
+    reset_collision_flags();
 }
 
 void TickProcessor::process_starting()
 {
-    // Resetear flags de colisión al principio de cada frame
-    for (auto &entry : players)
-    {
-        entry.second.collision_this_frame = false;
-    }
-
+    contact_handler.apply_bridge_contacts(npc_manager.get_npcs());
     broadcast_positions_update();
     state_manager.check_and_finish_starting();
 }
 
 void TickProcessor::flush_deferred_operations()
 {
-    std::lock_guard<std::mutex> lk(players_map_mutex);
-    for (auto &[id, player_data] : players)
+    TickProfiler::Scope phase(profiler, TickPhase::DEFERRED_OPS);
+    // Cambios de capa (suelo/puente) de quienes cruzaron un sensor en este tick:
+    // afectan las colisiones, así que no esperan al próximo snapshot
+    contact_handler.apply_bridge_contacts(npc_manager.get_npcs());
+
+    auto lk = profiler.lock_timed(players_map_mutex);
+    for (auto [id, player_data, record] : players)
     {
         // Procesar cheat de completar ronda pendiente
         if (player_data.pending_race_complete && !player_data.race_finished)
         {
-            RaceManager::complete_player_race(player_data, state_manager.get_pending_race_reset(), players);
+            RaceManager::complete_player_race(player_data, record, state_manager.get_pending_race_reset(), players);
             player_data.pending_race_complete = false;
         }
 
         // Procesar cheat de descalificación pendiente
         if (player_data.pending_disqualification && !player_data.is_dead)
         {
-            CollisionHandler::disqualify_player(player_data);
+            CollisionHandler::disqualify_player(player_data, record);
             RaceManager::check_race_completion(players, state_manager.get_pending_race_reset());
             player_data.pending_disqualification = false;
         }
@@ -129,21 +145,33 @@ void TickProcessor::flush_deferred_operations()
     }
 }
 
+void TickProcessor::reset_collision_flags()
+{
+    for (auto [id, player_data, record] : players)
+    {
+        player_data.collision_this_frame = false;
+    }
+}
+
 void TickProcessor::broadcast_positions_update()
 {
+    if (!snapshot_pacer.tick())
+        return;
+
+    TickProfiler::Scope phase(profiler, TickPhase::BROADCAST);
     std::vector<PlayerPositionUpdate> broadcast;
     player_manager.update_player_positions(broadcast, checkpoint_centers);
-
-    // Actualizar estado del bridge para NPCs
-    for (auto &npc : npc_manager.get_npcs())
-    {
-        BridgeHandler::update_bridge_state(npc);
-    }
     npc_manager.add_to_broadcast(broadcast);
 
+    // Cada cliente recibe solo los NPCs cercanos a su auto
+    interest_manager.update(broadcast, snapshot_pacer.interval_seconds());
+
     ServerMessage msg;
     msg.opcode = UPDATE_POSITIONS;
-    msg.positions = broadcast;
-    broadcast_manager.broadcast(msg);
+    msg.positions = std::move(broadcast);
+    broadcast_manager.broadcast_snapshot(msg, interest_manager, snapshot_pacer.get_rate());
+
+    // Una colisión entre snapshots se informa en el siguiente
+    reset_collision_flags();
 }
 
@@ -5,33 +5,43 @@
 #include <unordered_map>
 #include <vector>
 #include "../../game_state.h"
-#include "../../PlayerData.h"
+#include "../../player_store.h"
 #include "../state/game_state_manager.h"
 #include "../player/player_manager.h"
 #include "../npc/npc_manager.h"
 #include "../world/world_manager.h"
 #include "../broadcast/broadcast_manager.h"
-#include "../bridge/bridge_handler.h"
+#include "../interest/interest_manager.h"
+#include "../contact/contact_handler.h"
 #include "../race/race_manager.h"
 #include "../collision/collision_handler.h"
 #include "../gameloop_constants.h"
+#include "tick_profiler.h"
+#include "snapshot_pacer.h"
 
 class TickProcessor
 {
 public:
     TickProcessor(
         std::mutex &players_map_mutex,
-        std::unordered_map<int, PlayerData> &players,
+        PlayerStore &players,
         GameStateManager &state_manager,
         PlayerManager &player_manager,
         NPCManager &npc_manager,
         WorldManager &world_manager,
         BroadcastManager &broadcast_manager,
-        std::vector<b2Vec2> &checkpoint_centers);
+        InterestManager &interest_manager,
+        ContactHandler &contact_handler,
+        std::vector<b2Vec2> &checkpoint_centers,
+        TickProfiler &profiler);
 
     // Procesar un tick según el estado del juego
     void process(GameState state, float &acum);
 
+    // Snapshots de posiciones por segundo de esta partida (0 = uno por tick)
+    void set_snapshot_rate(int snapshot_rate_hz);
+    int get_snapshot_rate() const;
+
 private:
     void process_playing(float &acum);
     void process_lobby();
@@ -40,17 +50,23 @@ private:
     // Helper para destrucción diferida de cuerpos
     void flush_deferred_operations();
 
-    // Helper para enviar actualizaciones de posiciones (usado en playing y starting)
+    // Helper para enviar actualizaciones de posiciones (usado en playing y starting).
+    // La física corre en todos los ticks; el snapshot solo cuando el pacer lo indica.
     void broadcast_positions_update();
+    void reset_collision_flags();
 
     std::mutex &players_map_mutex;
-    std::unordered_map<int, PlayerData> &players;
+    PlayerStore &players;
     GameStateManager &state_manager;
     PlayerManager &player_manager;
     NPCManager &npc_manager;
     WorldManager &world_manager;
     BroadcastManager &broadcast_manager;
+    InterestManager &interest_manager;
+    ContactHandler &contact_handler;
     std::vector<b2Vec2> &checkpoint_centers;
+    TickProfiler &profiler;
+    SnapshotPacer snapshot_pacer;
 };
 
 #endif
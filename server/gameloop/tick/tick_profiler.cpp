@@ -0,0 +1,171 @@
+#include "tick_profiler.h"
+#include <algorithm>
+#include <bit>
+
+TickProfiler::Scope::Scope(TickProfiler &profiler, TickPhase phase)
+    : profiler(profiler), phase(phase), start(clock::now())
+{
+}
+
+TickProfiler::Scope::~Scope()
+{
+    profiler.record(phase, start, clock::now());
+}
+
+TickProfiler::TickProfiler()
+    : histograms(),
+      encoded_bytes(0),
+      encoded_frames(0),
+      slow_disconnects(0),
+      trace_mutex(),
+      trace(),
+      trace_next(0)
+{
+    trace.reserve(TRACE_CAPACITY);
+}
+
+size_t TickProfiler::bucket_for(uint64_t us)
+{
+    return std::min(static_cast<size_t>(std::bit_width(us)), BUCKETS - 1);
+}
+
+uint64_t TickProfiler::bucket_upper_us(size_t bucket)
+{
+    return uint64_t(1) << bucket;
+}
+
+void TickProfiler::update_max(std::atomic<uint64_t> &max, uint64_t value)
+{
+    uint64_t current = max.load(std::memory_order_relaxed);
+    while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+void TickProfiler::record(TickPhase phase, clock::time_point start, clock::time_point end)
+{
+    auto duration = end - start;
+    uint64_t us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+
+    Histogram &h = histograms[static_cast<size_t>(phase)];
+    h.buckets[bucket_for(us)].fetch_add(1, std::memory_order_relaxed);
+    h.count.fetch_add(1, std::memory_order_relaxed);
+    h.total_us.fetch_add(us, std::memory_order_relaxed);
+    update_max(h.max_us, us);
+
+    // Si la consola está volcando el trace no esperamos: se pierde este evento
+    std::unique_lock<std::mutex> lk(trace_mutex, std::try_to_lock);
+    if (!lk.owns_lock())
+        return;
+    TraceEvent ev{phase,
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count(),
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()};
+    if (trace.size() < TRACE_CAPACITY)
+        trace.push_back(ev);
+    else
+        trace[trace_next] = ev;
+    trace_next = (trace_next + 1) % TRACE_CAPACITY;
+}
+
+std::unique_lock<std::mutex> TickProfiler::lock_timed(std::mutex &mutex)
+{
+    auto start = clock::now();
+    std::unique_lock<std::mutex> lk(mutex);
+    record(TickPhase::LOCK_WAIT, start, clock::now());
+    return lk;
+}
+
+void TickProfiler::add_encoded(size_t bytes)
+{
+    encoded_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    encoded_frames.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TickProfiler::add_slow_disconnect()
+{
+    slow_disconnects.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t TickProfiler::percentile(const std::array<uint64_t, BUCKETS> &buckets, uint64_t count, double p)
+{
+    if (count == 0)
+        return 0;
+    uint64_t target = static_cast<uint64_t>(p * static_cast<double>(count - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t b = 0; b < BUCKETS; ++b)
+    {
+        seen += buckets[b];
+        if (seen >= target)
+            return bucket_upper_us(b);
+    }
+    return bucket_upper_us(BUCKETS - 1);
+}
+
+TickProfiler::Report TickProfiler::report() const
+{
+    Report out;
+    for (size_t p = 0; p < PHASES; ++p)
+    {
+        const Histogram &h = histograms[p];
+        std::array<uint64_t, BUCKETS> buckets;
+        uint64_t count = 0;
+        // Se suman los buckets leídos en vez de usar h.count: con escrituras
+        // en curso así los percentiles quedan consistentes
+        for (size_t b = 0; b < BUCKETS; ++b)
+        {
+            buckets[b] = h.buckets[b].load(std::memory_order_relaxed);
+            count += buckets[b];
+        }
+        PhaseStats &stats = out.phases[p];
+        stats.count = count;
+        stats.total_us = h.total_us.load(std::memory_order_relaxed);
+        stats.max_us = h.max_us.load(std::memory_order_relaxed);
+        stats.p50_us = percentile(buckets, count, 0.50);
+        stats.p99_us = percentile(buckets, count, 0.99);
+    }
+    out.encoded_bytes = encoded_bytes.load(std::memory_order_relaxed);
+    out.encoded_frames = encoded_frames.load(std::memory_order_relaxed);
+    out.slow_disconnects = slow_disconnects.load(std::memory_order_relaxed);
+    return out;
+}
+
+void TickProfiler::write_trace_events(std::ostream &out, int tid, bool &first) const
+{
+    std::lock_guard<std::mutex> lk(trace_mutex);
+    // Del más viejo al más nuevo
+    size_t start = trace.size() < TRACE_CAPACITY ? 0 : trace_next;
+    for (size_t i = 0; i < trace.size(); ++i)
+    {
+        const TraceEvent &ev = trace[(start + i) % trace.size()];
+        if (!first)
+            out << ",\n";
+        first = false;
+        out << "{\"name\":\"" << phase_name(ev.phase) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+            << ",\"ts\":" << ev.start_ns / 1000
+            << ",\"dur\":" << static_cast<double>(ev.duration_ns) / 1e3 << "}";
+    }
+}
+
+const char *TickProfiler::phase_name(TickPhase phase)
+{
+    switch (phase)
+    {
+    case TickPhase::EVENTS:
+        return "events";
+    case TickPhase::NPC_UPDATE:
+        return "npc_update";
+    case TickPhase::BODY_SYNC:
+        return "body_sync";
+    case TickPhase::PHYSICS_STEP:
+        return "physics_step";
+    case TickPhase::DEFERRED_OPS:
+        return "deferred_ops";
+    case TickPhase::BROADCAST:
+        return "broadcast";
+    case TickPhase::LOCK_WAIT:
+        return "lock_wait";
+    case TickPhase::COUNT:
+        break;
+    }
+    return "unknown";
+}
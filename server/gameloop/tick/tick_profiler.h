@@ -0,0 +1,124 @@
+#ifndef TICK_PROFILER_H
+#define TICK_PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+// Fases de un tick que se miden por separado
+enum class TickPhase : uint8_t
+{
+    EVENTS,
+    NPC_UPDATE,
+    BODY_SYNC,
+    PHYSICS_STEP,
+    DEFERRED_OPS,
+    BROADCAST,
+    LOCK_WAIT, // espera por players_map_mutex dentro del tick
+    COUNT
+};
+
+// Profiler de una partida. Cada fase tiene un histograma de buckets log2 en
+// microsegundos hecho de atómicos relajados: el worker que corre el tick
+// escribe sin tomar locks y la consola lee sin frenarlo.
+// Guarda además las últimas fases en un buffer circular para volcarlas como
+// trace de Chrome; si justo se está volcando, el tick descarta el evento.
+class TickProfiler
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    // Bucket 0: < 1 us; bucket k: [2^(k-1), 2^k) us; el último junta el resto
+    static constexpr size_t BUCKETS = 24;
+    static constexpr size_t PHASES = static_cast<size_t>(TickPhase::COUNT);
+    static constexpr size_t TRACE_CAPACITY = 4096;
+
+    struct PhaseStats
+    {
+        uint64_t count = 0;
+        uint64_t total_us = 0;
+        uint64_t max_us = 0;
+        // Cota superior del bucket donde cae el percentil
+        uint64_t p50_us = 0;
+        uint64_t p99_us = 0;
+    };
+
+    struct Report
+    {
+        std::array<PhaseStats, PHASES> phases;
+        uint64_t encoded_bytes = 0;
+        uint64_t encoded_frames = 0;
+        uint64_t slow_disconnects = 0;
+    };
+
+    // Mide desde la construcción hasta la destrucción
+    class Scope
+    {
+    public:
+        Scope(TickProfiler &profiler, TickPhase phase);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        TickProfiler &profiler;
+        TickPhase phase;
+        clock::time_point start;
+    };
+
+    TickProfiler();
+
+    void record(TickPhase phase, clock::time_point start, clock::time_point end);
+    // Toma el mutex anotando la espera como LOCK_WAIT
+    std::unique_lock<std::mutex> lock_timed(std::mutex &mutex);
+    void add_encoded(size_t bytes);
+    void add_slow_disconnect();
+
+    Report report() const;
+    // Escribe los eventos del buffer circular en formato Chrome trace
+    // ("traceEvents" con fases completas "X"); tid distingue la partida
+    void write_trace_events(std::ostream &out, int tid, bool &first) const;
+
+    static const char *phase_name(TickPhase phase);
+
+    TickProfiler(const TickProfiler &) = delete;
+    TickProfiler &operator=(const TickProfiler &) = delete;
+
+private:
+    struct Histogram
+    {
+        std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> total_us{0};
+        std::atomic<uint64_t> max_us{0};
+    };
+
+    struct TraceEvent
+    {
+        TickPhase phase;
+        int64_t start_ns;
+        int64_t duration_ns;
+    };
+
+    static size_t bucket_for(uint64_t us);
+    static uint64_t bucket_upper_us(size_t bucket);
+    static void update_max(std::atomic<uint64_t> &max, uint64_t value);
+    static uint64_t percentile(const std::array<uint64_t, BUCKETS> &buckets, uint64_t count, double p);
+
+    std::array<Histogram, PHASES> histograms;
+    std::atomic<uint64_t> encoded_bytes;
+    std::atomic<uint64_t> encoded_frames;
+    std::atomic<uint64_t> slow_disconnects;
+
+    mutable std::mutex trace_mutex;
+    std::vector<TraceEvent> trace;
+    size_t trace_next;
+};
+
+#endif
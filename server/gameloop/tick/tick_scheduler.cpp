@@ -0,0 +1,72 @@
+#include "tick_scheduler.h"
+#include <algorithm>
+
+TickScheduler::TickScheduler(int tick_rate_hz, int max_catchup_ticks)
+    : period(std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / std::max(tick_rate_hz, 1)))),
+      max_catchup_ticks(std::max(max_catchup_ticks, 0)),
+      deadline(clock::now()),
+      work_start(deadline),
+      stats_mutex(),
+      stats()
+{
+}
+
+void TickScheduler::start()
+{
+    deadline = clock::now() + period;
+}
+
+void TickScheduler::begin_tick()
+{
+    work_start = clock::now();
+}
+
+void TickScheduler::end_tick()
+{
+    auto now = clock::now();
+    // El trabajo de un tick tiene que terminar antes de que arranque el siguiente
+    deadline += period;
+    double work_ms = to_ms(now - work_start);
+    double slack_ms = to_ms(deadline - now);
+    bool missed = now > deadline;
+
+    // Atrasados más de lo que se puede recuperar: resincronizar y descartar ticks
+    uint64_t skipped = 0;
+    if (now > deadline + period * max_catchup_ticks)
+    {
+        skipped = static_cast<uint64_t>((now - deadline) / period);
+        deadline = now + period;
+    }
+
+    std::lock_guard<std::mutex> lk(stats_mutex);
+    stats.ticks++;
+    if (missed)
+        stats.missed_deadlines++;
+    stats.skipped_ticks += skipped;
+    stats.last_work_ms = work_ms;
+    stats.avg_work_ms += (work_ms - stats.avg_work_ms) / static_cast<double>(stats.ticks);
+    stats.max_work_ms = std::max(stats.max_work_ms, work_ms);
+    stats.last_slack_ms = slack_ms;
+    stats.min_slack_ms = (stats.ticks == 1) ? slack_ms : std::min(stats.min_slack_ms, slack_ms);
+}
+
+double TickScheduler::to_ms(clock::duration d)
+{
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+float TickScheduler::period_seconds() const
+{
+    return std::chrono::duration<float>(period).count();
+}
+
+float TickScheduler::max_catchup_seconds() const
+{
+    return period_seconds() * static_cast<float>(max_catchup_ticks + 1);
+}
+
+TickStats TickScheduler::get_stats() const
+{
+    std::lock_guard<std::mutex> lk(stats_mutex);
+    return stats;
+}
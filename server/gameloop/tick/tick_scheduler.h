@@ -0,0 +1,58 @@
+#ifndef TICK_SCHEDULER_H
+#define TICK_SCHEDULER_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+// Estadísticas acumuladas del scheduler (tiempos en milisegundos)
+struct TickStats
+{
+    uint64_t ticks = 0;
+    uint64_t missed_deadlines = 0; // ticks que terminaron después de su deadline
+    uint64_t skipped_ticks = 0;    // ticks descartados al resincronizar
+    double last_work_ms = 0.0;
+    double avg_work_ms = 0.0;
+    double max_work_ms = 0.0;
+    double last_slack_ms = 0.0; // margen hasta el deadline (negativo = atrasado)
+    double min_slack_ms = 0.0;
+};
+
+// Scheduler de paso fijo basado en deadlines absolutos: el deadline de cada tick
+// se calcula a partir del anterior (no de "ahora"), así el error no se acumula.
+// Si un tick se atrasa se recupera corriendo los siguientes sin dormir, hasta
+// max_catchup_ticks; más allá de eso se resincroniza y se descartan ticks.
+class TickScheduler
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    TickScheduler(int tick_rate_hz, int max_catchup_ticks);
+
+    // Fija el primer deadline a partir de ahora
+    void start();
+
+    // Marcan el inicio y fin del trabajo de un tick; end_tick avanza el deadline
+    void begin_tick();
+    void end_tick();
+
+    clock::time_point next_deadline() const { return deadline; }
+    float period_seconds() const;
+    // Máximo tiempo de simulación a recuperar en un tick
+    float max_catchup_seconds() const;
+
+    TickStats get_stats() const;
+
+private:
+    static double to_ms(clock::duration d);
+
+    clock::duration period;
+    int max_catchup_ticks;
+    clock::time_point deadline;
+    clock::time_point work_start;
+
+    mutable std::mutex stats_mutex;
+    TickStats stats;
+};
+
+#endif
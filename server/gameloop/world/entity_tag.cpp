@@ -0,0 +1,43 @@
+#include "entity_tag.h"
+
+uintptr_t EntityTag::pack(EntityKind kind, int index)
+{
+    return (static_cast<uintptr_t>(static_cast<uint32_t>(index)) << KIND_BITS) |
+           static_cast<uintptr_t>(kind);
+}
+
+EntityTag EntityTag::unpack(uintptr_t data)
+{
+    EntityTag tag;
+    tag.kind = static_cast<EntityKind>(data & KIND_MASK);
+    if (tag.kind != EntityKind::NONE)
+        tag.index = static_cast<int>(static_cast<uint32_t>(data >> KIND_BITS));
+    return tag;
+}
+
+void EntityTag::set(b2Body *body, EntityKind kind, int index)
+{
+    body->GetUserData().pointer = pack(kind, index);
+}
+
+void EntityTag::set(b2Fixture *fixture, EntityKind kind, int index)
+{
+    fixture->GetUserData().pointer = pack(kind, index);
+}
+
+EntityTag EntityTag::of(b2Body *body)
+{
+    if (!body)
+        return EntityTag();
+    return unpack(body->GetUserData().pointer);
+}
+
+EntityTag EntityTag::of(b2Fixture *fixture)
+{
+    if (!fixture)
+        return EntityTag();
+    EntityTag tag = unpack(fixture->GetUserData().pointer);
+    if (tag.kind == EntityKind::NONE)
+        return of(fixture->GetBody());
+    return tag;
+}
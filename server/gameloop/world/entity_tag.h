@@ -0,0 +1,40 @@
+#ifndef ENTITY_TAG_H
+#define ENTITY_TAG_H
+
+#include <cstdint>
+#include <box2d/b2_body.h>
+#include <box2d/b2_fixture.h>
+
+// Qué entidad del juego representa un body o fixture de Box2D
+enum class EntityKind : uint8_t
+{
+    NONE = 0, // paredes, puentes y todo lo que no se etiquetó
+    PLAYER,   // index = id del jugador (PlayerStore)
+    NPC,      // index = posición en NPCManager::get_npcs()
+    CHECKPOINT // index = índice del checkpoint en la ronda
+};
+
+// Etiqueta guardada en el user data de Box2D. Los contactos resuelven a qué
+// entidad pertenece cada fixture sin recorrer jugadores ni buscar en mapas.
+struct EntityTag
+{
+    EntityKind kind = EntityKind::NONE;
+    int index = -1;
+
+    static void set(b2Body *body, EntityKind kind, int index);
+    static void set(b2Fixture *fixture, EntityKind kind, int index);
+
+    static EntityTag of(b2Body *body);
+    // Si el fixture no tiene etiqueta propia se usa la de su body
+    static EntityTag of(b2Fixture *fixture);
+
+private:
+    // kind en el byte bajo, index (como uint32) arriba
+    static constexpr unsigned KIND_BITS = 8;
+    static constexpr uintptr_t KIND_MASK = 0xFF;
+
+    static uintptr_t pack(EntityKind kind, int index);
+    static EntityTag unpack(uintptr_t data);
+};
+
+#endif
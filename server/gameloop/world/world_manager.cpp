@@ -17,6 +17,19 @@ void WorldManager::ContactListener::BeginContact(b2Contact *contact)
     callback(fixture_a, fixture_b);
 }
 
+void WorldManager::ContactListener::set_end_callback(ContactCallback cb)
+{
+    end_callback = std::move(cb);
+}
+
+void WorldManager::ContactListener::EndContact(b2Contact *contact)
+{
+    if (!end_callback)
+        return;
+
+    end_callback(contact->GetFixtureA(), contact->GetFixtureB());
+}
+
 WorldManager::WorldManager(CarPhysicsConfig &config)
     : world(b2Vec2(0.0f, 0.0f)), physics_config(config)
 {
@@ -28,6 +41,11 @@ void WorldManager::set_contact_callback(ContactCallback callback)
     contact_listener.set_callback(std::move(callback));
 }
 
+void WorldManager::set_end_contact_callback(ContactCallback callback)
+{
+    contact_listener.set_end_callback(std::move(callback));
+}
+
 void WorldManager::step(float time_step, int velocity_iters, int position_iters)
 {
     world.Step(time_step, velocity_iters, position_iters);
@@ -38,7 +56,7 @@ bool WorldManager::is_locked() const
     return world.IsLocked();
 }
 
-b2Body *WorldManager::create_player_body(float x_px, float y_px, float angle, const std::string &car_name)
+b2Body *WorldManager::create_player_body(int player_id, float x_px, float y_px, float angle, const std::string &car_name)
 {
     const CarPhysics &car_physics = physics_config.getCarPhysics(car_name);
 
@@ -48,6 +66,7 @@ b2Body *WorldManager::create_player_body(float x_px, float y_px, float angle, co
     bd.angle = angle;
 
     b2Body *player_body = world.CreateBody(&bd);
+    EntityTag::set(player_body, EntityKind::PLAYER, player_id);
 
     float halfWidth = car_physics.width / (2.0f * SCALE);
     float halfHeight = car_physics.height / (2.0f * SCALE);
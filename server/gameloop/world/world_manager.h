@@ -10,6 +10,7 @@
 #include <functional>
 #include "../../car_physics_config.h"
 #include "../gameloop_constants.h"
+#include "entity_tag.h"
 
 // Callback para cuando hay un contacto
 using ContactCallback = std::function<void(b2Fixture *, b2Fixture *)>;
@@ -17,15 +18,19 @@ using ContactCallback = std::function<void(b2Fixture *, b2Fixture *)>;
 class WorldManager
 {
 public:
-    // Contact listener interno que delega al callback
+    // Contact listener interno que delega a los callbacks
     class ContactListener : public b2ContactListener
     {
     private:
         ContactCallback callback;
+        ContactCallback end_callback;
 
     public:
         void set_callback(ContactCallback cb);
+        void set_end_callback(ContactCallback cb);
         void BeginContact(b2Contact *contact) override;
+        // También se llama desde DestroyBody, fuera del step
+        void EndContact(b2Contact *contact) override;
     };
 
 private:
@@ -36,8 +41,9 @@ private:
 public:
     explicit WorldManager(CarPhysicsConfig &config);
 
-    // Configurar el callback de contacto
+    // Configurar los callbacks de inicio y fin de contacto
     void set_contact_callback(ContactCallback callback);
+    void set_end_contact_callback(ContactCallback callback);
 
     // Avanzar la simulación física
     void step(float time_step, int velocity_iters, int position_iters);
@@ -45,8 +51,8 @@ public:
     // Verificar si el mundo está bloqueado (en medio de un step)
     bool is_locked() const;
 
-    // Crear un body para un jugador
-    b2Body *create_player_body(float x_px, float y_px, float angle, const std::string &car_name);
+    // Crear un body para un jugador, etiquetado con su id
+    b2Body *create_player_body(int player_id, float x_px, float y_px, float angle, const std::string &car_name);
 
     // Destruir un body de forma segura
     void safe_destroy_body(b2Body *&body);
@@ -9,35 +9,44 @@ LobbyHandler::LobbyHandler(GameMonitor &games_mon)
 
 void LobbyHandler::handle_message(ClientHandlerMessage &message)
 {
-    auto it = lobby_command_handlers.find(message.msg.cmd);
-    if (it != lobby_command_handlers.end())
+    if (message.msg.input.action == InputAction::NONE)
     {
-        it->second(message);
+        auto it = lobby_command_handlers.find(message.msg.cmd);
+        if (it != lobby_command_handlers.end())
+        {
+            it->second(message);
+        }
+        return;
     }
-    else
-    {
-        Event event = Event{message.client_id, message.msg.cmd};
-        int target_gid = message.msg.game_id;
-        std::shared_ptr<Queue<Event>> target_q = games_monitor.get_game_queue(target_gid);
 
-        if (target_q)
+    // Acción de juego: va directo a la cola de la partida, sin pasar por strings
+    Event event = Event{message.client_id, message.msg.input};
+    int target_gid = message.msg.game_id;
+    std::shared_ptr<EventQueue> target_q = games_monitor.get_game_queue(target_gid);
+
+    if (target_q)
+    {
+        try
         {
-            try
-            {
-                target_q->push(event);
-            }
-            catch (const ClosedQueue &)
+            // Nunca bloqueamos al reactor: si la partida no da abasto se descarta el input
+            if (!target_q->try_push(std::move(event)))
             {
-                // La cola del juego pudo haberse cerrado: ignoramos este evento
+                std::cerr << "[LobbyHandler] WARNING: Cola llena para game_id=" << target_gid
+                          << ", se descarta acción=" << int(message.msg.input.action)
+                          << " desde client=" << message.client_id << std::endl;
             }
         }
-        else
+        catch (const ClosedQueue &)
         {
-            std::cerr << "[LobbyHandler] WARNING: No se encontró cola para game_id="
-                      << target_gid << ", evento='" << message.msg.cmd
-                      << "' desde client=" << message.client_id << std::endl;
+            // La cola del juego pudo haberse cerrado: ignoramos este evento
         }
     }
+    else
+    {
+        std::cerr << "[LobbyHandler] WARNING: No se encontró cola para game_id="
+                  << target_gid << ", acción=" << int(message.msg.input.action)
+                  << " desde client=" << message.client_id << std::endl;
+    }
 }
 
 void LobbyHandler::init_dispatch()
@@ -54,6 +63,25 @@ void LobbyHandler::init_dispatch()
     { leave_game(message); };
 }
 
+void LobbyHandler::reply(ClientHandlerMessage &message, const ServerMessage &response)
+{
+    if (!message.outbox)
+        return;
+    try
+    {
+        // Corre en el thread del reactor: nunca se bloquea esperando lugar
+        if (!message.outbox->try_push(response))
+        {
+            std::cerr << "[LobbyHandler] Outbox lleno para cliente " << message.client_id << ": se lo desconecta" << std::endl;
+            message.outbox->drop_client();
+        }
+    }
+    catch (const ClosedQueue &)
+    {
+        std::cerr << "[LobbyHandler] Cola cerrada para cliente " << message.client_id << ", descartando respuesta" << std::endl;
+    }
+}
+
 void LobbyHandler::create_game(ClientHandlerMessage &message)
 {
 
@@ -74,14 +102,7 @@ void LobbyHandler::create_game(ClientHandlerMessage &message)
     response.success = true;
     response.map_id = message.msg.map_id;
 
-    try
-    {
-        client_queue->push(response);
-    }
-    catch (const ClosedQueue &)
-    {
-        std::cerr << "[LobbyHandler] Cola cerrada para cliente " << message.client_id << ", descartando respuesta" << std::endl;
-    }
+    reply(message, response);
 }
 
 void LobbyHandler::join_game(ClientHandlerMessage &message)
@@ -116,14 +137,7 @@ void LobbyHandler::join_game(ClientHandlerMessage &message)
         response.map_id = 0;
     }
 
-    try
-    {
-        client_queue->push(response);
-    }
-    catch (const ClosedQueue &)
-    {
-        std::cerr << "[LobbyHandler] Cola cerrada para cliente " << message.client_id << std::endl;
-    }
+    reply(message, response);
 }
 
 void LobbyHandler::get_games(ClientHandlerMessage &message)
@@ -132,30 +146,14 @@ void LobbyHandler::get_games(ClientHandlerMessage &message)
     ServerMessage resp;
     resp.opcode = GAMES_LIST;
     resp.games = games_monitor.list_games();
-    auto client_queue = message.outbox;
-    if (client_queue)
-    {
-        try
-        {
-            client_queue->push(resp);
-        }
-        catch (const ClosedQueue &)
-        { /* Cola cerrada */
-        }
-    }
+    reply(message, resp);
 }
 
 void LobbyHandler::start_game(ClientHandlerMessage &message)
 {
-    GameLoop *game = games_monitor.get_game(message.msg.game_id);
-    if (!game)
-    {
-        return;
-    }
-
     try
     {
-        game->start_game();
+        games_monitor.start_game(message.msg.game_id);
     }
     catch (const std::exception &e)
     {
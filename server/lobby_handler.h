@@ -14,6 +14,8 @@ private:
     std::unordered_map<std::string, std::function<void(ClientHandlerMessage &)>> lobby_command_handlers;
     
     void init_dispatch();
+    // Encola la respuesta sin bloquear; si el outbox está lleno desconecta al cliente
+    void reply(ClientHandlerMessage &message, const ServerMessage &response);
     void create_game(ClientHandlerMessage &message);
     void join_game(ClientHandlerMessage &message);
     void get_games(ClientHandlerMessage &message);
@@ -0,0 +1,334 @@
+#include "map_cache.h"
+#include "collision_merger.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAP_CACHE_MAGIC 0x50414D54u // "TMAP"
+#define MAP_CACHE_VERSION 2u
+#define MAP_CACHE_EXTENSION ".map.bin"
+#define JSON_EXTENSION ".json"
+#define FNV_OFFSET 1469598103934665603ull
+#define FNV_PRIME 1099511628211ull
+
+MapCache &MapCache::getInstance()
+{
+    static MapCache instance;
+    return instance;
+}
+
+std::shared_ptr<const CompiledMap> MapCache::get(uint8_t map_id)
+{
+    int safe_map_id = (map_id < MAP_COUNT) ? map_id : 0;
+    // Una sola compilación aunque arranquen varias partidas del mismo mapa a la vez
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!maps[safe_map_id])
+    {
+        maps[safe_map_id] = load_or_compile(safe_map_id);
+    }
+    return maps[safe_map_id];
+}
+
+std::shared_ptr<const CompiledMap> MapCache::load_or_compile(int map_id)
+{
+    auto map = std::make_shared<CompiledMap>();
+    std::string path = cache_path(map_id);
+    uint64_t stamp = sources_stamp(source_paths(map_id));
+    if (!load(path, stamp, *map))
+    {
+        *map = compile(map_id);
+        if (!save(path, *map, stamp))
+        {
+            std::cerr << "[MapCache] WARNING: no se pudo escribir " << path << ", el mapa queda solo en memoria" << std::endl;
+        }
+    }
+    map->static_fixtures = MapLayout::build_static_fixtures(map->polygons);
+    map->roads.build(map->waypoints);
+    std::cerr << "[MapCache] " << MAP_NAMES[map_id] << ": " << map->source_polygons << " polígonos de colisión -> "
+              << map->static_fixtures.size() << " fixtures estáticos" << std::endl;
+    return map;
+}
+
+CompiledMap MapCache::compile(int map_id)
+{
+    CompiledMap map;
+    MapLayout::extract_map_data(getMapJsonPath(map_id), map.polygons, map.waypoints, map.parked_cars);
+    map.source_polygons = static_cast<uint32_t>(map.polygons.size());
+    CollisionMerger::merge(map.polygons);
+    MapLayout::extract_spawn_points(getMapSpawnPointsPath(map_id), map.spawn_points);
+    for (size_t round = 0; round < map.checkpoints.size(); ++round)
+    {
+        try
+        {
+            MapLayout::extract_checkpoints(getMapCheckpointPath(map_id, static_cast<int>(round)), map.checkpoints[round]);
+        }
+        catch (const std::exception &e)
+        {
+            // La ronda queda sin checkpoints, igual que si el archivo estuviera vacío
+            std::cerr << "[MapCache] " << e.what() << std::endl;
+        }
+    }
+    return map;
+}
+
+std::vector<std::string> MapCache::source_paths(int map_id)
+{
+    std::vector<std::string> paths = {getMapJsonPath(map_id), getMapSpawnPointsPath(map_id)};
+    for (int round = 0; round < 3; ++round)
+    {
+        paths.push_back(getMapCheckpointPath(map_id, round));
+    }
+    return paths;
+}
+
+uint64_t MapCache::sources_stamp(const std::vector<std::string> &paths)
+{
+    uint64_t hash = FNV_OFFSET;
+    auto mix = [&hash](uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            hash = (hash ^ ((value >> (8 * i)) & 0xFF)) * FNV_PRIME;
+        }
+    };
+
+    mix(MAP_CACHE_VERSION);
+    for (const auto &path : paths)
+    {
+        std::error_code ec;
+        uintmax_t size = std::filesystem::file_size(path, ec);
+        mix(ec ? 0 : size);
+        auto mtime = std::filesystem::last_write_time(path, ec);
+        mix(ec ? 0 : static_cast<uint64_t>(mtime.time_since_epoch().count()));
+    }
+    return hash;
+}
+
+std::string MapCache::cache_path(int map_id)
+{
+    std::string path = getMapJsonPath(map_id);
+    size_t ext = path.rfind(JSON_EXTENSION);
+    if (ext != std::string::npos)
+    {
+        path.erase(ext);
+    }
+    return path + MAP_CACHE_EXTENSION;
+}
+
+template <typename T>
+void MapCache::put(std::string &out, const T &value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+bool MapCache::take(Cursor &in, T &value)
+{
+    if (static_cast<size_t>(in.end - in.pos) < sizeof(T))
+    {
+        return false;
+    }
+    std::memcpy(&value, in.pos, sizeof(T));
+    in.pos += sizeof(T);
+    return true;
+}
+
+bool MapCache::take_count(Cursor &in, uint32_t &count, size_t min_record)
+{
+    // Un conteo corrupto no puede pedir más elementos de los que entran en el resto del archivo
+    return take(in, count) && count <= static_cast<size_t>(in.end - in.pos) / min_record;
+}
+
+bool MapCache::save(const std::string &path, const CompiledMap &map, uint64_t stamp)
+{
+    std::string out;
+    put(out, MAP_CACHE_MAGIC);
+    put(out, MAP_CACHE_VERSION);
+    put(out, stamp);
+    put(out, map.source_polygons);
+
+    put(out, static_cast<uint32_t>(map.polygons.size()));
+    for (const auto &polygon : map.polygons)
+    {
+        put(out, polygon.category);
+        put(out, static_cast<uint16_t>(polygon.vertices.size()));
+        for (const auto &v : polygon.vertices)
+        {
+            put(out, v.x);
+            put(out, v.y);
+        }
+    }
+
+    put(out, static_cast<uint32_t>(map.waypoints.size()));
+    for (const auto &wp : map.waypoints)
+    {
+        put(out, wp.position.x);
+        put(out, wp.position.y);
+        put(out, static_cast<uint32_t>(wp.connections.size()));
+        for (int connection : wp.connections)
+        {
+            put(out, static_cast<int32_t>(connection));
+        }
+    }
+
+    put(out, static_cast<uint32_t>(map.parked_cars.size()));
+    for (const auto &parked : map.parked_cars)
+    {
+        put(out, parked.position.x);
+        put(out, parked.position.y);
+        put(out, static_cast<uint8_t>(parked.horizontal));
+    }
+
+    put(out, static_cast<uint32_t>(map.spawn_points.size()));
+    for (const auto &spawn : map.spawn_points)
+    {
+        put(out, spawn.x);
+        put(out, spawn.y);
+        put(out, spawn.angle);
+    }
+
+    for (const auto &round : map.checkpoints)
+    {
+        put(out, static_cast<uint32_t>(round.size()));
+        for (const auto &c : round)
+        {
+            put(out, c.x);
+            put(out, c.y);
+        }
+    }
+
+    // Se escribe aparte y se renombra: otro proceso nunca ve un archivo a medias
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file || !file.write(out.data(), static_cast<std::streamsize>(out.size())))
+        {
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+bool MapCache::load(const std::string &path, uint64_t stamp, CompiledMap &out)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    const char *begin = static_cast<const char *>(data);
+    bool ok = parse(Cursor{begin, begin + size}, stamp, out);
+    ::munmap(data, size);
+    return ok;
+}
+
+bool MapCache::parse(Cursor in, uint64_t stamp, CompiledMap &out)
+{
+    uint32_t magic = 0, version = 0, count = 0;
+    uint64_t file_stamp = 0;
+    if (!take(in, magic) || !take(in, version) || !take(in, file_stamp) ||
+        magic != MAP_CACHE_MAGIC || version != MAP_CACHE_VERSION || file_stamp != stamp)
+    {
+        return false;
+    }
+
+    CompiledMap map;
+    if (!take(in, map.source_polygons))
+        return false;
+    if (!take_count(in, count, sizeof(uint16_t) * 2))
+        return false;
+    map.polygons.resize(count);
+    for (auto &polygon : map.polygons)
+    {
+        uint16_t vertices = 0;
+        if (!take(in, polygon.category) || !take(in, vertices))
+            return false;
+        polygon.vertices.resize(vertices);
+        for (auto &v : polygon.vertices)
+        {
+            if (!take(in, v.x) || !take(in, v.y))
+                return false;
+        }
+    }
+
+    if (!take_count(in, count, sizeof(float) * 2 + sizeof(uint32_t)))
+        return false;
+    map.waypoints.resize(count);
+    for (auto &wp : map.waypoints)
+    {
+        uint32_t connections = 0;
+        if (!take(in, wp.position.x) || !take(in, wp.position.y) ||
+            !take_count(in, connections, sizeof(int32_t)))
+            return false;
+        wp.connections.resize(connections);
+        for (int &connection : wp.connections)
+        {
+            int32_t value = 0;
+            if (!take(in, value))
+                return false;
+            connection = value;
+        }
+    }
+
+    if (!take_count(in, count, sizeof(float) * 2 + sizeof(uint8_t)))
+        return false;
+    map.parked_cars.resize(count);
+    for (auto &parked : map.parked_cars)
+    {
+        uint8_t horizontal = 0;
+        if (!take(in, parked.position.x) || !take(in, parked.position.y) || !take(in, horizontal))
+            return false;
+        parked.horizontal = horizontal != 0;
+    }
+
+    if (!take_count(in, count, sizeof(float) * 3))
+        return false;
+    map.spawn_points.resize(count);
+    for (auto &spawn : map.spawn_points)
+    {
+        if (!take(in, spawn.x) || !take(in, spawn.y) || !take(in, spawn.angle))
+            return false;
+    }
+
+    for (auto &round : map.checkpoints)
+    {
+        if (!take_count(in, count, sizeof(float) * 2))
+            return false;
+        round.resize(count);
+        for (auto &c : round)
+        {
+            if (!take(in, c.x) || !take(in, c.y))
+                return false;
+        }
+    }
+
+    if (in.pos != in.end)
+        return false;
+    out = std::move(map);
+    return true;
+}
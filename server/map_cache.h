@@ -0,0 +1,82 @@
+#ifndef MAP_CACHE_H
+#define MAP_CACHE_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "map_layout.h"
+#include "gameloop/npc/road_graph.h"
+
+// Todo lo que el servidor lee de los archivos de un mapa, ya convertido a metros
+struct CompiledMap
+{
+    // Colisiones ya unidas por CollisionMerger; source_polygons es cuántas
+    // había en el JSON (para el reporte)
+    std::vector<MapLayout::CollisionPolygon> polygons;
+    uint32_t source_polygons = 0;
+    std::vector<MapLayout::WaypointData> waypoints;
+    std::vector<MapLayout::ParkedCarData> parked_cars;
+    std::vector<MapLayout::SpawnPointData> spawn_points;
+    std::array<std::vector<b2Vec2>, 3> checkpoints; // uno por ronda
+    // Plantilla del mundo estático armada a partir de polygons al cargar el
+    // mapa (no va en el binario). Cada partida solo la instancia
+    std::vector<MapLayout::StaticFixture> static_fixtures;
+    // Grafo de calles del tráfico, armado desde waypoints (tampoco va en el binario)
+    RoadGraph roads;
+};
+
+/*
+ * Cache de mapas compilados, compartida por todas las partidas
+ *
+ * La primera partida de cada mapa lo busca en su versión binaria
+ * (<mapa>.map.bin, junto al JSON); si no existe o algún archivo fuente cambió
+ * (tamaño o fecha), parsea los JSON y la vuelve a escribir. Las partidas
+ * siguientes reciben el mismo CompiledMap inmutable sin tocar disco.
+ *
+ * El binario es un volcado en el orden de bytes de la máquina: es un cache
+ * local, no un formato de intercambio.
+ * */
+class MapCache
+{
+public:
+    static MapCache &getInstance();
+    MapCache(const MapCache &) = delete;
+    MapCache &operator=(const MapCache &) = delete;
+
+    std::shared_ptr<const CompiledMap> get(uint8_t map_id);
+
+    // Formato binario. load devuelve false si el archivo falta, está
+    // truncado o no corresponde a 'stamp'
+    static bool save(const std::string &path, const CompiledMap &map, uint64_t stamp);
+    static bool load(const std::string &path, uint64_t stamp, CompiledMap &out);
+
+private:
+    std::mutex mutex;
+    std::array<std::shared_ptr<const CompiledMap>, MAP_COUNT> maps;
+
+    MapCache() = default;
+
+    static std::shared_ptr<const CompiledMap> load_or_compile(int map_id);
+    static CompiledMap compile(int map_id);
+    static std::vector<std::string> source_paths(int map_id);
+    static uint64_t sources_stamp(const std::vector<std::string> &paths);
+    static std::string cache_path(int map_id);
+
+    // Lectura acotada sobre el archivo mapeado: falla en vez de leer de más
+    struct Cursor
+    {
+        const char *pos;
+        const char *end;
+    };
+    template <typename T>
+    static void put(std::string &out, const T &value);
+    template <typename T>
+    static bool take(Cursor &in, T &value);
+    static bool take_count(Cursor &in, uint32_t &count, size_t min_record);
+    static bool parse(Cursor in, uint64_t stamp, CompiledMap &out);
+};
+
+#endif
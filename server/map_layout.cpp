@@ -7,17 +7,78 @@
 #define WALL_THICKNESS 0.1f
 #define OFFSET_X -10.0f
 #define OFFSET_Y -10.0f
+#define STATIC_FRICTION 0.7f
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
 
-void MapLayout::create_map_layout(const std::string &jsonPath)
+void MapLayout::create_map_layout(const std::vector<StaticFixture> &fixtures)
 {
-    std::ifstream file(jsonPath);
-    json data;
-    file >> data;
+    b2BodyDef bd;
+    bd.type = b2_staticBody;
+    b2Body *body = world.CreateBody(&bd);
+
+    for (const auto &fixture : fixtures)
+    {
+        b2FixtureDef fd;
+        fd.shape = &fixture.shape;
+        fd.density = 0.0f;
+        fd.friction = STATIC_FRICTION;
+        fd.filter = fixture.filter;
+        fd.isSensor = fixture.is_sensor;
+        body->CreateFixture(&fd);
+    }
+}
+
+std::vector<MapLayout::StaticFixture> MapLayout::build_static_fixtures(const std::vector<CollisionPolygon> &polygons)
+{
+    std::vector<StaticFixture> fixtures;
+    fixtures.reserve(polygons.size());
+    for (const auto &polygon : polygons)
+    {
+        if (polygon.vertices.size() < 3)
+            continue;
+
+        StaticFixture fixture;
+        fixture.shape.Set(polygon.vertices.data(), static_cast<int>(polygon.vertices.size()));
+        fixture.filter = static_filter(polygon.category);
+        fixture.is_sensor = polygon.category == SENSOR_START_BRIDGE || polygon.category == SENSOR_END_BRIDGE;
+        fixtures.push_back(fixture);
+    }
+    return fixtures;
+}
+
+void MapLayout::extract_map_data(const std::string &json_path, std::vector<CollisionPolygon> &polygons,
+                                 std::vector<WaypointData> &npc_waypoints, std::vector<ParkedCarData> &parked_cars)
+{
+    std::ifstream file(json_path);
+    if (!file)
+    {
+        throw std::runtime_error("No se pudo abrir " + json_path);
+    }
+    json root;
+    file >> root;
+
+    polygons.clear();
+    npc_waypoints.clear();
+    parked_cars.clear();
 
-    for (auto &layer : data[LAYERS_STR])
+    // Un solo parseo del JSON para todo lo que usa el servidor
+    get_collision_polygons(root, polygons);
+    get_npc_waypoints(root, npc_waypoints);
+    get_parked_cars(root, parked_cars);
+}
+
+void MapLayout::get_collision_polygons(json &root, std::vector<CollisionPolygon> &polygons)
+{
+    static const std::unordered_map<std::string, uint16_t> collisions_byte_map = {
+        {LAYER_COLLISIONS_STR, COLLISION_FLOOR},
+        {LAYER_COLLISIONS_BRIDGE_STR, COLLISION_BRIDGE},
+        {LAYER_END_BRIDGE_STR, SENSOR_END_BRIDGE},
+        {LAYER_COLLISIONS_UNDER_STR, COLLISION_UNDER},
+        {LAYER_START_BRIDGE_STR, SENSOR_START_BRIDGE}};
+
+    for (auto &layer : root[LAYERS_STR])
     {
         if (layer[TYPE_STR] != OBJECTGROUP_STR)
         {
@@ -48,7 +109,7 @@ void MapLayout::create_map_layout(const std::string &jsonPath)
 
                     verts.emplace_back(px / SCALE, py / SCALE);
                 }
-                create_polygon_layout(verts, category);
+                polygons.push_back({category, std::move(verts)});
                 continue;
             }
 
@@ -64,7 +125,7 @@ void MapLayout::create_map_layout(const std::string &jsonPath)
                 verts.emplace_back((x + w + OFFSET_X) / SCALE, (y + h + OFFSET_Y) / SCALE);
                 verts.emplace_back((x + OFFSET_X) / SCALE, (y + h + OFFSET_Y) / SCALE);
 
-                create_polygon_layout(verts, category);
+                polygons.push_back({category, std::move(verts)});
             }
         }
     }
@@ -99,24 +160,8 @@ void MapLayout::extract_checkpoints(const std::string &jsonPath, std::vector<b2V
     }
 }
 
-void MapLayout::extract_map_npc_data(const std::string &json_path, std::vector<WaypointData> &npc_waypoints, std::vector<ParkedCarData> &parked_cars)
+void MapLayout::get_parked_cars(json &root, std::vector<ParkedCarData> &parked_cars)
 {
-    npc_waypoints.clear();
-    parked_cars.clear();
-
-    get_npc_waypoints(json_path, npc_waypoints);
-    get_parked_cars(json_path, parked_cars);
-}
-void MapLayout::get_parked_cars(const std::string &json_path_parked, std::vector<ParkedCarData> &parked_cars)
-{
-    std::ifstream file_parked(json_path_parked);
-    if (!file_parked)
-    {
-        throw std::runtime_error("No se pudo abrir " + json_path_parked);
-    }
-    nlohmann::json root;
-    file_parked >> root;
-
     if (root.contains(LAYERS_STR))
     {
         for (auto &layer : root[LAYERS_STR])
@@ -156,16 +201,8 @@ void MapLayout::get_parked_cars(const std::string &json_path_parked, std::vector
     }
 }
 
-void MapLayout::get_npc_waypoints(const std::string &json_path_wp, std::vector<WaypointData> &npc_waypoints)
+void MapLayout::get_npc_waypoints(json &root, std::vector<WaypointData> &npc_waypoints)
 {
-    std::ifstream file(json_path_wp);
-    if (!file)
-    {
-        throw std::runtime_error("No se pudo abrir " + json_path_wp);
-    }
-    nlohmann::json root;
-    file >> root;
-
     std::vector<std::pair<int, WaypointData>> temp;
 
     if (root.contains(LAYERS_STR))
@@ -328,42 +365,28 @@ void MapLayout::extract_spawn_points(const std::string &jsonPath, std::vector<Sp
     }
 }
 
-void MapLayout::create_polygon_layout(const std::vector<b2Vec2> &vertices, uint16_t category)
+b2Filter MapLayout::static_filter(uint16_t category)
 {
-    if (vertices.size() < 3)
-        return;
-
-    b2BodyDef bd;
-    bd.type = b2_staticBody;
-    b2Body *body = world.CreateBody(&bd);
-
-    b2PolygonShape shape;
-    shape.Set(vertices.data(), (int)vertices.size());
-
-    b2FixtureDef fd;
-    fd.shape = &shape;
-    fd.density = 0.0f;
-    fd.friction = 0.7f;
-
-    fd.filter.categoryBits = category;
+    b2Filter filter;
+    filter.categoryBits = category;
 
     if (category == COLLISION_UNDER)
     {
-        fd.filter.maskBits =
+        filter.maskBits =
             SENSOR_START_BRIDGE |
             SENSOR_END_BRIDGE |
             COLLISION_UNDER;
     }
     else if (category == COLLISION_BRIDGE)
     {
-        fd.filter.maskBits =
+        filter.maskBits =
             CAR_BRIDGE |
             SENSOR_START_BRIDGE |
             SENSOR_END_BRIDGE;
     }
     else if (category == COLLISION_FLOOR)
     {
-        fd.filter.maskBits =
+        filter.maskBits =
             CAR_GROUND |
             SENSOR_START_BRIDGE |
             SENSOR_END_BRIDGE;
@@ -371,9 +394,7 @@ void MapLayout::create_polygon_layout(const std::vector<b2Vec2> &vertices, uint1
 
     if (category == SENSOR_START_BRIDGE || category == SENSOR_END_BRIDGE)
     {
-        fd.isSensor = true;
-
-        fd.filter.maskBits =
+        filter.maskBits =
             CAR_GROUND |
             CAR_BRIDGE |
             COLLISION_FLOOR |
@@ -381,5 +402,5 @@ void MapLayout::create_polygon_layout(const std::vector<b2Vec2> &vertices, uint1
             COLLISION_UNDER;
     }
 
-    body->CreateFixture(&fd);
-}
\ No newline at end of file
+    return filter;
+}
@@ -4,29 +4,40 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <nlohmann/json_fwd.hpp>
 #include "../common/constants.h"
 #include "gameloop/gameloop_constants.h"
 class MapLayout
 {
 private:
     b2World &world;
-    std::unordered_map<std::string, uint8_t> collisions_byte_map = {
-        {LAYER_COLLISIONS_STR,
-         COLLISION_FLOOR},
-        {LAYER_COLLISIONS_BRIDGE_STR,
-         COLLISION_BRIDGE},
-        {LAYER_END_BRIDGE_STR, SENSOR_END_BRIDGE},
-        {LAYER_COLLISIONS_UNDER_STR, COLLISION_UNDER},
-        {LAYER_START_BRIDGE_STR, SENSOR_START_BRIDGE}};
 
     void create_walls();
-    void create_polygon_layout(const std::vector<b2Vec2> &vertices, uint16_t category);
 
 public:
-    void create_map_layout(const std::string &jsonPath);
+    // Polígono de colisión (o sensor de puente) en metros, con su categoría de Box2D
+    struct CollisionPolygon
+    {
+        uint16_t category;
+        std::vector<b2Vec2> vertices;
+    };
+
+    // Fixture estático ya armado: el shape tiene calculados hull, normales y
+    // centroide, y el filtro corresponde a su categoría
+    struct StaticFixture
+    {
+        b2PolygonShape shape;
+        b2Filter filter;
+        bool is_sensor;
+    };
+    // Plantilla del mundo estático de un mapa; se arma una vez y se comparte
+    static std::vector<StaticFixture> build_static_fixtures(const std::vector<CollisionPolygon> &polygons);
+
+    // Instancia la plantilla en el world: un único body estático con todos los fixtures
+    void create_map_layout(const std::vector<StaticFixture> &fixtures);
     // Extrae checkpoints de un archivo JSON y los coloca en 'out' como b2Vec2 en metros
     // El JSON debe tener el formato correcto: { "checkpoints": [ {"id": 1, "x": 960, "y": 540}, ... ] }
-    void extract_checkpoints(const std::string &jsonPath, std::vector<b2Vec2> &out);
+    static void extract_checkpoints(const std::string &jsonPath, std::vector<b2Vec2> &out);
 
     // Extrae waypoints NPC de un archivo JSON similar a checkpoints pero con conectividad
     // Formato: { "waypoints": [ {"id": 0, "x": 100, "y": 100, "connections": [1, 3]}, ... ] }
@@ -53,14 +64,20 @@ public:
         float y;     // En pixeles
         float angle; // En radianes
     };
-    void extract_spawn_points(const std::string &jsonPath, std::vector<SpawnPointData> &out);
+    static void extract_spawn_points(const std::string &jsonPath, std::vector<SpawnPointData> &out);
 
-    void extract_map_npc_data(const std::string &json_path, std::vector<WaypointData> &npc_waypoints, std::vector<ParkedCarData> &parked_cars);
-    void get_parked_cars(const std::string &json_path_parked, std::vector<ParkedCarData> &parked_cars);
-    void get_npc_waypoints(const std::string &json_path_wp, std::vector<WaypointData> &npc_waypoints);
-    std::vector<std::string> split(std::string s, const std::string &delim);
+    // Parsea el JSON de Tiled del mapa una sola vez: colisiones, waypoints y estacionados
+    static void extract_map_data(const std::string &json_path, std::vector<CollisionPolygon> &polygons,
+                                 std::vector<WaypointData> &npc_waypoints, std::vector<ParkedCarData> &parked_cars);
+    static std::vector<std::string> split(std::string s, const std::string &delim);
     MapLayout(b2World &world_map) : world(world_map)
     {
     }
+
+private:
+    static b2Filter static_filter(uint16_t category);
+    static void get_collision_polygons(nlohmann::json &root, std::vector<CollisionPolygon> &polygons);
+    static void get_parked_cars(nlohmann::json &root, std::vector<ParkedCarData> &parked_cars);
+    static void get_npc_waypoints(nlohmann::json &root, std::vector<WaypointData> &npc_waypoints);
 };
 #endif
\ No newline at end of file
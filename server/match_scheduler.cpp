@@ -0,0 +1,267 @@
+#include "match_scheduler.h"
+#include <algorithm>
+#include <thread>
+
+// Tiempo máximo que un worker ocioso duerme sin revisar los heaps ajenos
+#define IDLE_WAIT std::chrono::milliseconds(100)
+// Atraso tolerado antes de robar una partida: le da prioridad al worker dueño
+#define STEAL_DELAY std::chrono::microseconds(500)
+
+MatchScheduler::MatchTask::MatchTask(ScheduledMatch *game, clock::time_point deadline)
+    : game(game), deadline(deadline), initialized(false), in_flight(false), removed(false), mtx(), done()
+{
+}
+
+bool MatchScheduler::later_deadline(const MatchTask *a, const MatchTask *b)
+{
+    return a->deadline > b->deadline;
+}
+
+MatchScheduler::MatchScheduler(int n_workers)
+    : tasks_mutex(), tasks(), workers(), stopped(false)
+{
+    if (n_workers <= 0)
+    {
+        n_workers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    for (int i = 0; i < n_workers; ++i)
+    {
+        workers.push_back(std::make_unique<Worker>(*this, static_cast<size_t>(i)));
+    }
+    for (auto &worker : workers)
+    {
+        worker->start();
+    }
+}
+
+MatchScheduler::~MatchScheduler()
+{
+    stop();
+}
+
+void MatchScheduler::add_match(ScheduledMatch *game)
+{
+    std::lock_guard<std::mutex> lock(tasks_mutex);
+    if (stopped)
+        return;
+
+    tasks.push_back(std::make_unique<MatchTask>(game, clock::now()));
+
+    // Asignar al worker con menos partidas
+    Worker *target = workers.front().get();
+    size_t min_load = target->load();
+    for (auto &worker : workers)
+    {
+        size_t load = worker->load();
+        if (load < min_load)
+        {
+            min_load = load;
+            target = worker.get();
+        }
+    }
+    target->push(tasks.back().get(), false);
+}
+
+void MatchScheduler::remove_match(ScheduledMatch *game)
+{
+    std::unique_ptr<MatchTask> task;
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex);
+        auto it = std::find_if(tasks.begin(), tasks.end(),
+                               [game](const std::unique_ptr<MatchTask> &t) { return t->game == game; });
+        if (it == tasks.end())
+            return;
+        task = std::move(*it);
+        tasks.erase(it);
+    }
+
+    std::unique_lock<std::mutex> lk(task->mtx);
+    task->removed = true;
+    for (auto &worker : workers)
+    {
+        if (worker->erase(task.get()))
+            return;
+    }
+    // No estaba en ningún heap: un worker la está corriendo
+    task->done.wait(lk, [&task]() { return !task->in_flight; });
+}
+
+void MatchScheduler::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex);
+        if (stopped)
+            return;
+        stopped = true;
+    }
+    for (auto &worker : workers)
+    {
+        worker->stop();
+    }
+    for (auto &worker : workers)
+    {
+        worker->join();
+    }
+}
+
+MatchScheduler::MatchTask *MatchScheduler::steal(size_t thief, clock::time_point now)
+{
+    for (size_t i = 1; i < workers.size(); ++i)
+    {
+        Worker &victim = *workers[(thief + i) % workers.size()];
+        MatchTask *task = victim.pop_due(now - STEAL_DELAY, false);
+        if (task)
+            return task;
+    }
+    return nullptr;
+}
+
+MatchScheduler::clock::time_point MatchScheduler::earliest_foreign_deadline(size_t except, clock::time_point fallback)
+{
+    clock::time_point earliest = fallback;
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+        clock::time_point deadline;
+        if (i != except && workers[i]->peek_deadline(deadline))
+        {
+            earliest = std::min(earliest, deadline + STEAL_DELAY);
+        }
+    }
+    return earliest;
+}
+
+// ---------------- Worker ----------------
+
+MatchScheduler::Worker::Worker(MatchScheduler &scheduler, size_t index)
+    : scheduler(scheduler), index(index), mtx(), cv(), heap(), running_task(false), notified(false)
+{
+}
+
+void MatchScheduler::Worker::run()
+{
+    while (should_keep_running())
+    {
+        auto now = clock::now();
+        MatchTask *task = pop_due(now, true);
+        if (!task)
+        {
+            task = scheduler.steal(index, now);
+            if (task)
+                mark_running();
+        }
+        if (task)
+        {
+            run_task(task);
+            continue;
+        }
+
+        // Nada para correr: dormir hasta el próximo deadline propio o ajeno
+        clock::time_point wake = scheduler.earliest_foreign_deadline(index, now + IDLE_WAIT);
+        std::unique_lock<std::mutex> lk(mtx);
+        if (!heap.empty())
+        {
+            wake = std::min(wake, heap.front()->deadline);
+        }
+        cv.wait_until(lk, wake, [this]() { return notified; });
+        notified = false;
+    }
+}
+
+void MatchScheduler::Worker::stop()
+{
+    Thread::stop();
+    std::lock_guard<std::mutex> lk(mtx);
+    notified = true;
+    cv.notify_one();
+}
+
+void MatchScheduler::Worker::push(MatchTask *task, bool finished_running)
+{
+    std::lock_guard<std::mutex> lk(mtx);
+    heap.push_back(task);
+    std::push_heap(heap.begin(), heap.end(), later_deadline);
+    if (finished_running)
+        running_task = false;
+    notified = true;
+    cv.notify_one();
+}
+
+bool MatchScheduler::Worker::erase(MatchTask *task)
+{
+    std::lock_guard<std::mutex> lk(mtx);
+    auto it = std::find(heap.begin(), heap.end(), task);
+    if (it == heap.end())
+        return false;
+    heap.erase(it);
+    std::make_heap(heap.begin(), heap.end(), later_deadline);
+    return true;
+}
+
+void MatchScheduler::Worker::mark_running()
+{
+    std::lock_guard<std::mutex> lk(mtx);
+    running_task = true;
+}
+
+void MatchScheduler::Worker::finish_running()
+{
+    std::lock_guard<std::mutex> lk(mtx);
+    running_task = false;
+}
+
+size_t MatchScheduler::Worker::load()
+{
+    std::lock_guard<std::mutex> lk(mtx);
+    return heap.size() + (running_task ? 1 : 0);
+}
+
+MatchScheduler::MatchTask *MatchScheduler::Worker::pop_due(clock::time_point due, bool for_owner)
+{
+    std::lock_guard<std::mutex> lk(mtx);
+    if (heap.empty() || heap.front()->deadline > due)
+        return nullptr;
+
+    std::pop_heap(heap.begin(), heap.end(), later_deadline);
+    MatchTask *task = heap.back();
+    heap.pop_back();
+    task->in_flight = true;
+    if (for_owner)
+        running_task = true;
+    return task;
+}
+
+bool MatchScheduler::Worker::peek_deadline(clock::time_point &out)
+{
+    std::lock_guard<std::mutex> lk(mtx);
+    if (heap.empty())
+        return false;
+    out = heap.front()->deadline;
+    return true;
+}
+
+void MatchScheduler::Worker::run_task(MatchTask *task)
+{
+    if (!task->initialized)
+    {
+        task->game->init();
+        task->initialized = true;
+    }
+    else
+    {
+        task->game->tick();
+    }
+    task->deadline = task->game->next_tick_deadline();
+
+    std::unique_lock<std::mutex> lk(task->mtx);
+    task->in_flight = false;
+    if (task->removed)
+    {
+        // remove_match espera este aviso para liberarla: no se la vuelve a tocar
+        task->done.notify_all();
+        lk.unlock();
+        finish_running();
+        return;
+    }
+    // La partida queda en el heap de este worker (también si fue robada)
+    push(task, true);
+}
@@ -0,0 +1,106 @@
+#ifndef MATCH_SCHEDULER_H
+#define MATCH_SCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "../common/thread.h"
+
+// Lo que el pool necesita de una partida (GameLoop; los tests usan otras)
+class ScheduledMatch
+{
+public:
+    virtual ~ScheduledMatch() = default;
+    // Primer turno: arma el mundo
+    virtual void init() = 0;
+    virtual void tick() = 0;
+    virtual std::chrono::steady_clock::time_point next_tick_deadline() const = 0;
+};
+
+// Pool fijo de workers (uno por core) que multiplexa todas las partidas.
+// Cada worker tiene su propio heap de partidas ordenado por deadline del
+// próximo tick; un worker ocioso roba partidas atrasadas de otro worker.
+class MatchScheduler
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    // workers <= 0 usa std::thread::hardware_concurrency()
+    explicit MatchScheduler(int workers = 0);
+    ~MatchScheduler();
+
+    // La partida queda a cargo del pool hasta remove_match() o stop(); debe
+    // vivir al menos hasta entonces. El primer turno llama a init().
+    void add_match(ScheduledMatch *game);
+    // Saca la partida del pool; si un worker la está corriendo espera a que
+    // termine ese tick. Al volver ya se puede destruir la partida.
+    // No se puede llamar desde un tick.
+    void remove_match(ScheduledMatch *game);
+    void stop();
+
+    size_t worker_count() const { return workers.size(); }
+
+    MatchScheduler(const MatchScheduler &) = delete;
+    MatchScheduler &operator=(const MatchScheduler &) = delete;
+
+private:
+    struct MatchTask
+    {
+        MatchTask(ScheduledMatch *game, clock::time_point deadline);
+
+        ScheduledMatch *game;
+        clock::time_point deadline;
+        bool initialized;
+        // Fuera de todo heap porque un worker la sacó para correrla: se pone
+        // en true bajo el mtx de ese worker y vuelve a false bajo el de la partida
+        bool in_flight;
+        bool removed;
+        // Ordena el fin de un tick con remove_match (se toma antes que el
+        // mtx de un worker)
+        std::mutex mtx;
+        std::condition_variable done;
+    };
+
+    class Worker : public Thread
+    {
+    public:
+        Worker(MatchScheduler &scheduler, size_t index);
+        void run() override;
+        void stop() override;
+
+        void push(MatchTask *task, bool finished_running);
+        // Saca la partida del heap si está ahí
+        bool erase(MatchTask *task);
+        size_t load();
+        // Saca la partida con deadline más próximo si vence antes de 'due'
+        MatchTask *pop_due(clock::time_point due, bool for_owner);
+        bool peek_deadline(clock::time_point &out);
+
+    private:
+        void run_task(MatchTask *task);
+        // Cuenta como propia una partida robada mientras corre
+        void mark_running();
+        void finish_running();
+
+        MatchScheduler &scheduler;
+        size_t index;
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::vector<MatchTask *> heap; // min-heap por deadline
+        bool running_task;
+        bool notified;
+    };
+
+    static bool later_deadline(const MatchTask *a, const MatchTask *b);
+    MatchTask *steal(size_t thief, clock::time_point now);
+    clock::time_point earliest_foreign_deadline(size_t except, clock::time_point fallback);
+
+    std::mutex tasks_mutex;
+    std::vector<std::unique_ptr<MatchTask>> tasks;
+    std::vector<std::unique_ptr<Worker>> workers;
+    bool stopped;
+};
+
+#endif
@@ -7,8 +7,10 @@
 #define MAX_MOVING_NPCS_STR "max_moving"
 #define MAX_PARKED_NPCS_STR "max_parked"
 #define SPEED_PX_S_STR "speed_px_s"
+#define SEED_STR "seed"
+#define RANDOM_SEED 0
 
-NPCConfig::NPCConfig() : max_moving(MAX_MOVING_NPCS), max_parked(MAX_PARKED_NPCS), speed_px_s(NPC_SPEED_PX_S), config_path(std::string(CONFIG_DIR) + "/npc.yaml") {}
+NPCConfig::NPCConfig() : max_moving(MAX_MOVING_NPCS), max_parked(MAX_PARKED_NPCS), speed_px_s(NPC_SPEED_PX_S), seed(RANDOM_SEED), config_path(std::string(CONFIG_DIR) + "/npc.yaml") {}
 
 NPCConfig &NPCConfig::getInstance()
 {
@@ -26,6 +28,7 @@ bool NPCConfig::loadFromFile(const std::string &path)
         max_moving = npc[MAX_MOVING_NPCS_STR].as<int>();
         max_parked = npc[MAX_PARKED_NPCS_STR].as<int>();
         speed_px_s = npc[SPEED_PX_S_STR].as<float>();
+        seed = npc[SEED_STR] ? npc[SEED_STR].as<uint32_t>() : RANDOM_SEED;
         return true;
     }
     catch (const std::exception &e)
@@ -1,6 +1,7 @@
 #ifndef NPC_CONFIG_H
 #define NPC_CONFIG_H
 
+#include <cstdint>
 #include <string>
 
 class NPCConfig {
@@ -8,6 +9,8 @@ private:
     int max_moving;
     int max_parked;
     float speed_px_s;
+    // Semilla del tráfico; 0 = una distinta en cada partida
+    uint32_t seed;
     std::string config_path;
     NPCConfig();
 public:
@@ -20,6 +23,7 @@ public:
     int getMaxMoving() const { return max_moving; }
     int getMaxParked() const { return max_parked; }
     float getSpeedPxS() const { return speed_px_s; }
+    uint32_t getSeed() const { return seed; }
 };
 
 #endif // NPC_CONFIG_H
@@ -0,0 +1,203 @@
+#include "outbox.h"
+
+Outbox::Outbox(unsigned int max_size)
+    : q(max_size), closed(false), depth(0), snapshot_mtx(), pending_snapshot(), snapshot_waiting_since(),
+      replaced_snapshots(0), datagram_sink(), dropped(false), flush_requested(false), callback_mtx(), on_push(),
+      deltas_enabled(false), acked_seq(0),
+      wire_version(PROTOCOL_VERSION_LEGACY)
+{
+}
+
+void Outbox::set_on_push(std::function<void()> callback)
+{
+    std::lock_guard<std::mutex> lck(callback_mtx);
+    on_push = std::move(callback);
+}
+
+void Outbox::push(const ServerMessage &msg)
+{
+    q.push(OutboundMessage(msg));
+    depth.fetch_add(1, std::memory_order_relaxed);
+    notify_push();
+}
+
+void Outbox::push(const EncodedFrame &frame)
+{
+    q.push(OutboundMessage(frame));
+    depth.fetch_add(1, std::memory_order_relaxed);
+    notify_push();
+}
+
+bool Outbox::try_push(const ServerMessage &msg)
+{
+    if (!q.try_push(OutboundMessage(msg)))
+    {
+        return false;
+    }
+    depth.fetch_add(1, std::memory_order_relaxed);
+    notify_push();
+    return true;
+}
+
+bool Outbox::offer(const EncodedFrame &frame)
+{
+    if (!q.try_push(OutboundMessage(frame)))
+    {
+        return false;
+    }
+    depth.fetch_add(1, std::memory_order_relaxed);
+    notify_push();
+    return true;
+}
+
+void Outbox::offer_snapshot(const EncodedFrame &frame)
+{
+    if (closed.load(std::memory_order_acquire))
+    {
+        throw ClosedQueue();
+    }
+    std::shared_ptr<const DatagramSink> sink;
+    {
+        std::lock_guard<std::mutex> lck(snapshot_mtx);
+        sink = datagram_sink;
+    }
+    if (sink && (*sink)(frame))
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lck(snapshot_mtx);
+        if (pending_snapshot)
+            replaced_snapshots.fetch_add(1, std::memory_order_relaxed);
+        else
+            snapshot_waiting_since = std::chrono::steady_clock::now();
+        pending_snapshot = frame;
+    }
+    notify_push();
+}
+
+void Outbox::notify_push()
+{
+    if (flush_requested.exchange(true, std::memory_order_acq_rel))
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lck(callback_mtx);
+    if (on_push)
+        on_push();
+    else
+        flush_requested.store(false, std::memory_order_release);
+}
+
+bool Outbox::pop_any(OutboundMessage &msg)
+{
+    if (q.try_pop(msg))
+    {
+        depth.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    std::lock_guard<std::mutex> lck(snapshot_mtx);
+    if (!pending_snapshot)
+    {
+        return false;
+    }
+    msg = std::move(pending_snapshot);
+    pending_snapshot = nullptr;
+    return true;
+}
+
+bool Outbox::try_pop(OutboundMessage &msg)
+{
+    try
+    {
+        if (pop_any(msg))
+        {
+            return true;
+        }
+        // Vacía: el próximo push vuelve a avisar. Se reintenta una vez por si
+        // un push publicó justo antes de bajar la marca y no avisó.
+        flush_requested.exchange(false, std::memory_order_acq_rel);
+        return pop_any(msg);
+    }
+    catch (const ClosedQueue &)
+    {
+        return false;
+    }
+}
+
+void Outbox::set_datagram_sink(DatagramSink sink)
+{
+    std::lock_guard<std::mutex> lck(snapshot_mtx);
+    if (sink)
+        datagram_sink = std::make_shared<const DatagramSink>(std::move(sink));
+    else
+        datagram_sink = nullptr;
+}
+
+void Outbox::close()
+{
+    if (!closed.exchange(true))
+    {
+        q.close();
+    }
+}
+
+void Outbox::drop_client()
+{
+    dropped.store(true, std::memory_order_release);
+    close();
+    notify_push();
+}
+
+bool Outbox::is_dropped() const
+{
+    return dropped.load(std::memory_order_acquire);
+}
+
+void Outbox::ack_snapshot(uint32_t seq)
+{
+    acked_seq = seq;
+    deltas_enabled = true;
+}
+
+bool Outbox::wants_deltas() const
+{
+    return deltas_enabled;
+}
+
+uint32_t Outbox::acked_snapshot() const
+{
+    return acked_seq;
+}
+
+void Outbox::set_wire_version(uint8_t version)
+{
+    wire_version = version;
+}
+
+size_t Outbox::pending() const
+{
+    // El pop puede adelantarse al incremento del push: nunca mostramos negativo
+    size_t value = depth.load(std::memory_order_relaxed);
+    return value > q.capacity() ? 0 : value;
+}
+
+std::chrono::steady_clock::duration Outbox::snapshot_lag() const
+{
+    std::lock_guard<std::mutex> lck(snapshot_mtx);
+    if (!pending_snapshot)
+    {
+        return std::chrono::steady_clock::duration::zero();
+    }
+    return std::chrono::steady_clock::now() - snapshot_waiting_since;
+}
+
+uint64_t Outbox::get_replaced_snapshots() const
+{
+    return replaced_snapshots.load(std::memory_order_relaxed);
+}
+
+uint8_t Outbox::get_wire_version() const
+{
+    return wire_version;
+}
@@ -0,0 +1,104 @@
+#ifndef OUTBOX_H
+#define OUTBOX_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <variant>
+#include "../common/message_encoder.h"
+#include "../common/messages.h"
+#include "../common/ring_queue.h"
+
+// Lo que se encola para un cliente: un mensaje a codificar o un frame ya
+// codificado y compartido con otros clientes (broadcast del juego).
+using OutboundMessage = std::variant<ServerMessage, EncodedFrame>;
+
+// Cola de salida de un cliente. La escriben el juego y el lobby (varios
+// productores) y la vacía solo el Reactor, así que es una RingQueue MPSC.
+// Solo el push que encuentra la cola "sin aviso pendiente" llama a on_push:
+// el resto ya está cubierto por el flush que el reactor tiene en camino.
+// Igual que Queue, push bloquea si está llena y lanza ClosedQueue si se cerró.
+//
+// El juego nunca bloquea: los mensajes confiables van con offer() (false si
+// la cola está llena) y los snapshots con offer_snapshot(), que ocupan un
+// único lugar aparte: uno nuevo reemplaza al que el cliente todavía no recibió.
+// El reactor saca primero la cola y después el snapshot.
+//
+// Con el canal UDP abierto los snapshots salen directo como datagrama desde
+// offer_snapshot(); solo si no entran en uno usan el lugar de TCP.
+class Outbox
+{
+private:
+    RingQueue<OutboundMessage> q;
+    std::atomic<bool> closed;
+    // Mensajes encolados y todavía no sacados por el reactor (solo para stats)
+    std::atomic<size_t> depth;
+
+    // Último snapshot sin enviar (latest-wins) y desde cuándo hay uno esperando
+    mutable std::mutex snapshot_mtx;
+    EncodedFrame pending_snapshot;
+    std::chrono::steady_clock::time_point snapshot_waiting_since;
+    std::atomic<uint64_t> replaced_snapshots;
+    // Envío por UDP (protegido por snapshot_mtx; se llama fuera del lock)
+    std::shared_ptr<const std::function<bool(const EncodedFrame &)>> datagram_sink;
+    // El juego lo desconectó por lento: el reactor cierra la conexión
+    std::atomic<bool> dropped;
+    // true desde que se avisó al reactor hasta que encuentra la cola vacía
+    std::atomic<bool> flush_requested;
+    // Protege solo a on_push, no a la cola
+    std::mutex callback_mtx;
+    std::function<void()> on_push;
+
+    // Lo escribe el reactor al recibir SNAPSHOT_ACK y lo lee el juego al codificar
+    std::atomic<bool> deltas_enabled;
+    std::atomic<uint32_t> acked_seq;
+    // Versión negociada con HELLO: el juego codifica los broadcasts para esta versión
+    std::atomic<uint8_t> wire_version;
+
+    void notify_push();
+    bool pop_any(OutboundMessage &msg);
+
+public:
+    // Manda un snapshot por UDP; false si no se pudo y tiene que ir por TCP
+    using DatagramSink = std::function<bool(const EncodedFrame &)>;
+
+    explicit Outbox(unsigned int max_size);
+
+    // Se llama con callback_mtx tomado: al limpiarlo no queda ningún aviso en vuelo
+    void set_on_push(std::function<void()> callback);
+
+    void push(const ServerMessage &msg);
+    void push(const EncodedFrame &frame);
+    bool try_push(const ServerMessage &msg);
+    // No bloqueantes, para el juego. offer retorna false si la cola está llena
+    bool offer(const EncodedFrame &frame);
+    void offer_snapshot(const EncodedFrame &frame);
+    bool try_pop(OutboundMessage &msg);
+    // nullptr vuelve a mandar los snapshots por TCP
+    void set_datagram_sink(DatagramSink sink);
+    void close();
+    // Cierra la cola y avisa al reactor para que corte la conexión
+    void drop_client();
+    bool is_dropped() const;
+    size_t pending() const;
+
+    // Cuánto hace que el cliente tiene un snapshot esperando (0 si está al día)
+    std::chrono::steady_clock::duration snapshot_lag() const;
+    // Snapshots descartados porque llegó uno más nuevo antes de enviarlos
+    uint64_t get_replaced_snapshots() const;
+
+    // El cliente confirmó el snapshot seq (0 solo habilita el modo delta)
+    void ack_snapshot(uint32_t seq);
+    bool wants_deltas() const;
+    uint32_t acked_snapshot() const;
+
+    void set_wire_version(uint8_t version);
+    uint8_t get_wire_version() const;
+
+    Outbox(const Outbox &) = delete;
+    Outbox &operator=(const Outbox &) = delete;
+};
+
+#endif
@@ -0,0 +1,113 @@
+#include "player_store.h"
+
+PlayerStore::PlayerStore()
+    : hot(), cold(), ids(), slot_of(), free_slots()
+{
+}
+
+PlayerData &PlayerStore::insert(int id, const PlayerData &data, PlayerRecord record)
+{
+    auto it = slot_of.find(id);
+    if (it != slot_of.end())
+    {
+        hot[it->second] = data;
+        cold[it->second] = std::move(record);
+        return hot[it->second];
+    }
+
+    size_t slot;
+    if (!free_slots.empty())
+    {
+        slot = free_slots.back();
+        free_slots.pop_back();
+        hot[slot] = data;
+        cold[slot] = std::move(record);
+        ids[slot] = id;
+    }
+    else
+    {
+        slot = ids.size();
+        hot.push_back(data);
+        cold.push_back(std::move(record));
+        ids.push_back(id);
+    }
+    slot_of.emplace(id, slot);
+    return hot[slot];
+}
+
+bool PlayerStore::erase(int id)
+{
+    auto it = slot_of.find(id);
+    if (it == slot_of.end())
+    {
+        return false;
+    }
+    size_t slot = it->second;
+    slot_of.erase(it);
+    ids[slot] = FREE_SLOT;
+    hot[slot] = PlayerData();
+    cold[slot] = PlayerRecord();
+
+    // Los huecos del final se descartan para que la iteración no los recorra
+    while (!ids.empty() && ids.back() == FREE_SLOT)
+    {
+        ids.pop_back();
+        hot.pop_back();
+        cold.pop_back();
+    }
+    free_slots.clear();
+    for (size_t s = 0; s < ids.size(); ++s)
+    {
+        if (ids[s] == FREE_SLOT)
+            free_slots.push_back(s);
+    }
+    return true;
+}
+
+void PlayerStore::clear()
+{
+    hot.clear();
+    cold.clear();
+    ids.clear();
+    slot_of.clear();
+    free_slots.clear();
+}
+
+PlayerData *PlayerStore::find(int id)
+{
+    auto it = slot_of.find(id);
+    return it == slot_of.end() ? nullptr : &hot[it->second];
+}
+
+const PlayerData *PlayerStore::find(int id) const
+{
+    auto it = slot_of.find(id);
+    return it == slot_of.end() ? nullptr : &hot[it->second];
+}
+
+PlayerRecord *PlayerStore::find_record(int id)
+{
+    auto it = slot_of.find(id);
+    return it == slot_of.end() ? nullptr : &cold[it->second];
+}
+
+const PlayerRecord *PlayerStore::find_record(int id) const
+{
+    auto it = slot_of.find(id);
+    return it == slot_of.end() ? nullptr : &cold[it->second];
+}
+
+bool PlayerStore::contains(int id) const
+{
+    return slot_of.find(id) != slot_of.end();
+}
+
+size_t PlayerStore::size() const
+{
+    return slot_of.size();
+}
+
+bool PlayerStore::empty() const
+{
+    return slot_of.empty();
+}
@@ -0,0 +1,104 @@
+#ifndef PLAYER_STORE_H
+#define PLAYER_STORE_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "PlayerData.h"
+
+// Jugadores de una partida. Los datos del tick (PlayerData) van contiguos en
+// un arreglo y los fríos (PlayerRecord) en otro paralelo; un mapa disperso
+// traduce id -> slot. Los slots no se mueven mientras el jugador existe: al
+// salir queda un hueco que reusa el próximo que entra.
+class PlayerStore
+{
+public:
+    // Lo que devuelve la iteración: for (auto [id, data, record] : players)
+    struct Entry
+    {
+        int id;
+        PlayerData &data;
+        PlayerRecord &record;
+    };
+
+    struct ConstEntry
+    {
+        int id;
+        const PlayerData &data;
+        const PlayerRecord &record;
+    };
+
+    template <typename Store, typename Value>
+    class Iterator
+    {
+    private:
+        Store *store;
+        size_t slot;
+
+        void skip_free()
+        {
+            while (slot < store->ids.size() && store->ids[slot] == FREE_SLOT)
+                ++slot;
+        }
+
+    public:
+        Iterator(Store *store, size_t slot) : store(store), slot(slot)
+        {
+            skip_free();
+        }
+
+        Value operator*() const
+        {
+            return Value{store->ids[slot], store->hot[slot], store->cold[slot]};
+        }
+
+        Iterator &operator++()
+        {
+            ++slot;
+            skip_free();
+            return *this;
+        }
+
+        bool operator!=(const Iterator &other) const
+        {
+            return slot != other.slot;
+        }
+    };
+
+    using iterator = Iterator<PlayerStore, Entry>;
+    using const_iterator = Iterator<const PlayerStore, ConstEntry>;
+
+    PlayerStore();
+
+    // Agrega (o reemplaza) al jugador id
+    PlayerData &insert(int id, const PlayerData &data, PlayerRecord record);
+    bool erase(int id);
+    void clear();
+
+    // nullptr si el jugador no está
+    PlayerData *find(int id);
+    const PlayerData *find(int id) const;
+    PlayerRecord *find_record(int id);
+    const PlayerRecord *find_record(int id) const;
+    bool contains(int id) const;
+
+    size_t size() const;
+    bool empty() const;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, ids.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, ids.size()); }
+
+private:
+    static constexpr int FREE_SLOT = -1;
+
+    std::vector<PlayerData> hot;
+    std::vector<PlayerRecord> cold;
+    // Id del jugador de cada slot, FREE_SLOT si está libre
+    std::vector<int> ids;
+    std::unordered_map<int, size_t> slot_of;
+    std::vector<size_t> free_slots;
+};
+
+#endif
@@ -1,7 +1,14 @@
 #include "server.h"
 
+#include <iostream>
+#include <sstream>
 #include <thread>
 #define CLOSE_SERVER "q"
+#define STATS_COMMAND "stats"
+// trace <archivo>: vuelca las últimas fases de cada tick para chrome://tracing
+#define TRACE_COMMAND "trace "
+// rate <partida> <hz>: snapshots por segundo de una partida (0 = uno por tick)
+#define RATE_COMMAND "rate "
 
 void Server::start()
 {
@@ -29,4 +36,26 @@ void Server::process_input(const std::string &input, bool &connected)
     {
         connected = false;
     }
+    else if (input == STATS_COMMAND)
+    {
+        games_monitor.print_stats(std::cout);
+    }
+    else if (input.rfind(TRACE_COMMAND, 0) == 0)
+    {
+        std::string path = input.substr(std::string(TRACE_COMMAND).size());
+        if (games_monitor.write_trace(path))
+            std::cout << "Trace escrito en " << path << std::endl;
+        else
+            std::cerr << "[Server] No se pudo escribir el trace en " << path << std::endl;
+    }
+    else if (input.rfind(RATE_COMMAND, 0) == 0)
+    {
+        std::istringstream args(input.substr(std::string(RATE_COMMAND).size()));
+        int game_id = 0;
+        int rate_hz = 0;
+        if (!(args >> game_id >> rate_hz) || rate_hz < 0)
+            std::cerr << "[Server] Uso: rate <partida> <hz>" << std::endl;
+        else if (!games_monitor.set_snapshot_rate(game_id, rate_hz))
+            std::cerr << "[Server] No existe la partida " << game_id << std::endl;
+    }
 }
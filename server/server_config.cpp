@@ -0,0 +1,91 @@
+#include "server_config.h"
+#include "install_paths.h"
+#include <yaml-cpp/yaml.h>
+#include <iostream>
+#define SERVER_NAME "server"
+#define TICK_RATE_HZ_STR "tick_rate_hz"
+#define SNAPSHOT_RATE_HZ_STR "snapshot_rate_hz"
+#define CLIENT_SNAPSHOT_MIN_RATE_STR "client_snapshot_min_rate_hz"
+#define MAX_CATCHUP_TICKS_STR "max_catchup_ticks"
+#define MATCH_WORKERS_STR "match_workers"
+#define IO_THREADS_STR "io_threads"
+#define SLOW_CLIENT_TIMEOUT_STR "slow_client_timeout_ms"
+#define SOCKET_SEND_BUFFER_STR "socket_send_buffer_bytes"
+#define UDP_ENABLED_STR "udp_snapshots"
+#define INTEREST_NAME "interest"
+#define INTEREST_RADIUS_STR "radius_px"
+#define INTEREST_FAR_RADIUS_STR "far_radius_px"
+#define INTEREST_HYSTERESIS_STR "hysteresis_px"
+#define INTEREST_CELL_STR "cell_px"
+#define INTEREST_FAR_INTERVAL_STR "far_interval_ticks"
+#define DEFAULT_TICK_RATE_HZ 60
+#define DEFAULT_SNAPSHOT_RATE_HZ 30
+#define DEFAULT_CLIENT_SNAPSHOT_MIN_RATE_HZ 10
+#define DEFAULT_MAX_CATCHUP_TICKS 5
+#define DEFAULT_MATCH_WORKERS 0
+#define DEFAULT_IO_THREADS 2
+#define DEFAULT_SLOW_CLIENT_TIMEOUT_MS 5000
+#define DEFAULT_SOCKET_SEND_BUFFER_BYTES 0
+#define DEFAULT_UDP_ENABLED true
+#define DEFAULT_INTEREST_RADIUS_PX 600
+#define DEFAULT_INTEREST_FAR_RADIUS_PX 1700
+#define DEFAULT_INTEREST_HYSTERESIS_PX 100
+#define DEFAULT_INTEREST_CELL_PX 512
+#define DEFAULT_INTEREST_FAR_INTERVAL 3
+
+ServerConfig::ServerConfig() : tick_rate_hz(DEFAULT_TICK_RATE_HZ), snapshot_rate_hz(DEFAULT_SNAPSHOT_RATE_HZ), client_snapshot_min_rate_hz(DEFAULT_CLIENT_SNAPSHOT_MIN_RATE_HZ), max_catchup_ticks(DEFAULT_MAX_CATCHUP_TICKS), match_workers(DEFAULT_MATCH_WORKERS), io_threads(DEFAULT_IO_THREADS), slow_client_timeout_ms(DEFAULT_SLOW_CLIENT_TIMEOUT_MS), socket_send_buffer_bytes(DEFAULT_SOCKET_SEND_BUFFER_BYTES), udp_enabled(DEFAULT_UDP_ENABLED), interest_radius_px(DEFAULT_INTEREST_RADIUS_PX), interest_far_radius_px(DEFAULT_INTEREST_FAR_RADIUS_PX), interest_hysteresis_px(DEFAULT_INTEREST_HYSTERESIS_PX), interest_cell_px(DEFAULT_INTEREST_CELL_PX), interest_far_interval(DEFAULT_INTEREST_FAR_INTERVAL), config_path(std::string(CONFIG_DIR) + "/server.yaml") {}
+
+ServerConfig &ServerConfig::getInstance()
+{
+    static ServerConfig instance;
+    return instance;
+}
+
+bool ServerConfig::loadFromFile(const std::string &path)
+{
+    config_path = path;
+    try
+    {
+        YAML::Node root = YAML::LoadFile(path);
+        YAML::Node server = root[SERVER_NAME];
+        if (server[TICK_RATE_HZ_STR])
+            tick_rate_hz = server[TICK_RATE_HZ_STR].as<int>();
+        if (server[SNAPSHOT_RATE_HZ_STR])
+            snapshot_rate_hz = server[SNAPSHOT_RATE_HZ_STR].as<int>();
+        if (server[CLIENT_SNAPSHOT_MIN_RATE_STR])
+            client_snapshot_min_rate_hz = server[CLIENT_SNAPSHOT_MIN_RATE_STR].as<int>();
+        if (server[MAX_CATCHUP_TICKS_STR])
+            max_catchup_ticks = server[MAX_CATCHUP_TICKS_STR].as<int>();
+        if (server[MATCH_WORKERS_STR])
+            match_workers = server[MATCH_WORKERS_STR].as<int>();
+        if (server[IO_THREADS_STR])
+            io_threads = server[IO_THREADS_STR].as<int>();
+        if (server[SLOW_CLIENT_TIMEOUT_STR])
+            slow_client_timeout_ms = server[SLOW_CLIENT_TIMEOUT_STR].as<int>();
+        if (server[SOCKET_SEND_BUFFER_STR])
+            socket_send_buffer_bytes = server[SOCKET_SEND_BUFFER_STR].as<int>();
+        if (server[UDP_ENABLED_STR])
+            udp_enabled = server[UDP_ENABLED_STR].as<bool>();
+
+        YAML::Node interest = root[INTEREST_NAME];
+        if (interest)
+        {
+            if (interest[INTEREST_RADIUS_STR])
+                interest_radius_px = interest[INTEREST_RADIUS_STR].as<int>();
+            if (interest[INTEREST_FAR_RADIUS_STR])
+                interest_far_radius_px = interest[INTEREST_FAR_RADIUS_STR].as<int>();
+            if (interest[INTEREST_HYSTERESIS_STR])
+                interest_hysteresis_px = interest[INTEREST_HYSTERESIS_STR].as<int>();
+            if (interest[INTEREST_CELL_STR])
+                interest_cell_px = interest[INTEREST_CELL_STR].as<int>();
+            if (interest[INTEREST_FAR_INTERVAL_STR])
+                interest_far_interval = interest[INTEREST_FAR_INTERVAL_STR].as<int>();
+        }
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "[ServerConfig] Error loading server config: " << e.what() << std::endl;
+        return false;
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef SERVER_CONFIG_H
+#define SERVER_CONFIG_H
+
+#include <string>
+
+class ServerConfig {
+private:
+    int tick_rate_hz;
+    int snapshot_rate_hz;
+    int client_snapshot_min_rate_hz;
+    int max_catchup_ticks;
+    int match_workers;
+    int io_threads;
+    int slow_client_timeout_ms;
+    int socket_send_buffer_bytes;
+    bool udp_enabled;
+    int interest_radius_px;
+    int interest_far_radius_px;
+    int interest_hysteresis_px;
+    int interest_cell_px;
+    int interest_far_interval;
+    std::string config_path;
+    ServerConfig();
+public:
+    static ServerConfig& getInstance();
+    ServerConfig(const ServerConfig&) = delete;
+    ServerConfig& operator=(const ServerConfig&) = delete;
+
+    bool loadFromFile(const std::string& path);
+
+    int getTickRateHz() const { return tick_rate_hz; }
+    // Snapshots de posiciones por segundo de cada partida (0 = uno por tick)
+    int getSnapshotRateHz() const { return snapshot_rate_hz; }
+    // Piso al que se le puede bajar la frecuencia a un cliente que no da abasto
+    int getClientSnapshotMinRateHz() const { return client_snapshot_min_rate_hz; }
+    int getMaxCatchupTicks() const { return max_catchup_ticks; }
+    // 0 = un worker por core
+    int getMatchWorkers() const { return match_workers; }
+    // Reactores (threads de red) que atienden a todos los clientes
+    int getIoThreads() const { return io_threads; }
+    // Tiempo que un cliente puede tener un snapshot sin recibir antes de desconectarlo
+    int getSlowClientTimeoutMs() const { return slow_client_timeout_ms; }
+    // SO_SNDBUF de cada conexión con un cliente (0 = el del kernel)
+    int getSocketSendBufferBytes() const { return socket_send_buffer_bytes; }
+    // Canal UDP opcional para los snapshots, en el mismo puerto que el TCP
+    bool isUdpEnabled() const { return udp_enabled; }
+    // Área de interés: NPCs a menos de radius van en todos los snapshots, hasta
+    // far_radius cada far_interval snapshots y más lejos no se mandan (radius 0 = sin filtro)
+    int getInterestRadiusPx() const { return interest_radius_px; }
+    int getInterestFarRadiusPx() const { return interest_far_radius_px; }
+    int getInterestHysteresisPx() const { return interest_hysteresis_px; }
+    int getInterestCellPx() const { return interest_cell_px; }
+    int getInterestFarInterval() const { return interest_far_interval; }
+};
+
+#endif // SERVER_CONFIG_H
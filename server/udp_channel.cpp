@@ -0,0 +1,202 @@
+#include "udp_channel.h"
+#include "client_handler_msg.h"
+#include "lobby_handler.h"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/uio.h>
+
+// Cada cuánto se revisa si hay que terminar mientras no llegan datagramas
+#define POLL_TIMEOUT_MS 100
+#define RECV_BUFFER_SIZE 2048
+
+UdpChannel::UdpChannel(const char *port, LobbyHandler &msg_handler)
+    : socket(std::make_shared<UdpSocket>(port)), message_handler(msg_handler), mtx(), clients(),
+      rng(std::random_device{}())
+{
+    // Los envíos salen desde los workers de las partidas: nunca deben bloquearse
+    socket->set_nonblocking(true);
+}
+
+uint32_t UdpChannel::register_client(int client_id, int game_id, const std::shared_ptr<Outbox> &outbox)
+{
+    std::lock_guard<std::mutex> lck(mtx);
+    uint32_t token = 0;
+    while (token == 0 || clients.count(token))
+        token = rng();
+    clients[token] = Client{client_id, game_id, outbox, false, UdpEndpoint{}, 0, false, 0};
+    return token;
+}
+
+void UdpChannel::unregister_client(uint32_t token)
+{
+    std::shared_ptr<Outbox> outbox;
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        auto it = clients.find(token);
+        if (it == clients.end())
+            return;
+        if (it->second.bound)
+            outbox = it->second.outbox.lock();
+        clients.erase(it);
+    }
+    if (outbox)
+        outbox->set_datagram_sink(nullptr);
+}
+
+uint16_t UdpChannel::get_port() const
+{
+    return socket->get_local_port();
+}
+
+void UdpChannel::run()
+{
+    std::vector<uint8_t> buffer(RECV_BUFFER_SIZE);
+    while (should_keep_running())
+    {
+        try
+        {
+            struct pollfd pfd = {socket->get_fd(), POLLIN, 0};
+            if (poll(&pfd, 1, POLL_TIMEOUT_MS) <= 0)
+                continue;
+
+            UdpEndpoint from;
+            int s;
+            while ((s = socket->recv_from(buffer.data(), buffer.size(), from)) > 0)
+            {
+                handle_datagram(buffer.data(), static_cast<size_t>(s), from);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            // Un datagrama no puede tirar abajo el canal
+            std::cerr << "[UdpChannel] " << e.what() << std::endl;
+        }
+    }
+}
+
+void UdpChannel::handle_datagram(const uint8_t *data, size_t size, const UdpEndpoint &from)
+{
+    uint32_t token;
+    if (size < 1 + sizeof(token))
+        return;
+    std::memcpy(&token, data + 1, sizeof(token));
+    token = ntohl(token);
+
+    if (data[0] == DATAGRAM_BIND)
+    {
+        handle_bind(token, from);
+    }
+    else if (data[0] == DATAGRAM_INPUT && size >= 1 + 2 * sizeof(uint32_t) + 1)
+    {
+        uint32_t seq;
+        std::memcpy(&seq, data + 1 + sizeof(token), sizeof(seq));
+        handle_input(token, ntohl(seq), data[1 + 2 * sizeof(uint32_t)], from);
+    }
+}
+
+void UdpChannel::handle_bind(uint32_t token, const UdpEndpoint &from)
+{
+    std::shared_ptr<Outbox> outbox;
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        auto it = clients.find(token);
+        if (it == clients.end())
+            return;
+        Client &client = it->second;
+        // Un BIND repetido (se perdió la confirmación) solo se vuelve a confirmar
+        if (!client.bound || !(client.endpoint == from))
+        {
+            client.bound = true;
+            client.endpoint = from;
+            outbox = client.outbox.lock();
+        }
+    }
+
+    if (outbox)
+    {
+        std::shared_ptr<UdpSocket> udp = socket;
+        auto seq = std::make_shared<std::atomic<uint32_t>>(0);
+        outbox->set_datagram_sink([udp, from, seq](const EncodedFrame &frame)
+                                  { return send_snapshot(*udp, from, seq->fetch_add(1) + 1, frame); });
+    }
+
+    uint8_t reply[1 + sizeof(token)];
+    reply[0] = DATAGRAM_BIND;
+    uint32_t net_token = htonl(token);
+    std::memcpy(reply + 1, &net_token, sizeof(net_token));
+    socket->send_to(reply, sizeof(reply), from);
+}
+
+void UdpChannel::handle_input(uint32_t token, uint32_t seq, uint8_t mask, const UdpEndpoint &from)
+{
+    static const struct
+    {
+        uint8_t bit;
+        InputAction pressed;
+        InputAction released;
+    } keys[] = {
+        {INPUT_MASK_UP, InputAction::MOVE_UP_PRESSED, InputAction::MOVE_UP_RELEASED},
+        {INPUT_MASK_DOWN, InputAction::MOVE_DOWN_PRESSED, InputAction::MOVE_DOWN_RELEASED},
+        {INPUT_MASK_LEFT, InputAction::MOVE_LEFT_PRESSED, InputAction::MOVE_LEFT_RELEASED},
+        {INPUT_MASK_RIGHT, InputAction::MOVE_RIGHT_PRESSED, InputAction::MOVE_RIGHT_RELEASED},
+    };
+
+    ClientHandlerMessage msg;
+    uint8_t changed;
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        auto it = clients.find(token);
+        if (it == clients.end() || !it->second.bound || !(it->second.endpoint == from))
+            return;
+        Client &client = it->second;
+        // Viejo o repetido: la máscara más nueva ya se aplicó
+        if (seq <= client.last_input_seq)
+            return;
+        client.last_input_seq = seq;
+        changed = client.mask_known ? (client.input_mask ^ mask) : 0xFF;
+        client.mask_known = true;
+        client.input_mask = mask;
+
+        msg.client_id = client.client_id;
+        msg.game_id = client.game_id;
+        msg.msg.player_id = client.client_id;
+        msg.msg.game_id = client.game_id;
+        msg.outbox = client.outbox.lock();
+    }
+
+    for (const auto &key : keys)
+    {
+        if (!(changed & key.bit))
+            continue;
+        msg.msg.input = InputEvent{(mask & key.bit) ? key.pressed : key.released, 0};
+        message_handler.handle_message(msg);
+    }
+}
+
+bool UdpChannel::send_snapshot(UdpSocket &socket, const UdpEndpoint &peer, uint32_t seq, const EncodedFrame &frame)
+{
+    uint8_t header[1 + sizeof(seq)];
+    if (sizeof(header) + frame->size() > MAX_DATAGRAM_BYTES)
+        return false;
+    header[0] = DATAGRAM_SNAPSHOT;
+    uint32_t net_seq = htonl(seq);
+    std::memcpy(header + 1, &net_seq, sizeof(net_seq));
+
+    struct iovec iov[2];
+    iov[0] = {header, sizeof(header)};
+    iov[1] = {const_cast<uint8_t *>(frame->data()), frame->size()};
+    try
+    {
+        // Si el kernel no lo acepta se pierde, como cualquier datagrama
+        socket.send_to(iov, 2, peer);
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+    return true;
+}
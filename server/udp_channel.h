@@ -0,0 +1,64 @@
+#ifndef UDP_CHANNEL_H
+#define UDP_CHANNEL_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+
+#include "../common/thread.h"
+#include "../common/udp_socket.h"
+
+#include "outbox.h"
+
+class LobbyHandler;
+
+// Canal UDP compartido por todos los clientes, en el mismo número de puerto que
+// el TCP. Cada cliente que lo pide por TCP recibe un token; cuando ese token
+// llega por UDP se conoce su dirección y sus snapshots pasan a salir como
+// datagramas (seq creciente, sin retransmitir). Las máscaras de input que manda
+// el cliente se traducen a las mismas acciones que llegan por TCP.
+class UdpChannel : public Thread
+{
+private:
+    struct Client
+    {
+        int client_id;
+        int game_id;
+        std::weak_ptr<Outbox> outbox;
+        bool bound;
+        UdpEndpoint endpoint;
+        uint32_t last_input_seq;
+        // Hasta el primer input no se sabe qué teclas quedaron apretadas por TCP
+        bool mask_known;
+        uint8_t input_mask;
+    };
+
+    std::shared_ptr<UdpSocket> socket;
+    LobbyHandler &message_handler;
+    std::mutex mtx;
+    std::unordered_map<uint32_t, Client> clients; // por token
+    std::mt19937 rng;
+
+    void handle_datagram(const uint8_t *data, size_t size, const UdpEndpoint &from);
+    void handle_bind(uint32_t token, const UdpEndpoint &from);
+    void handle_input(uint32_t token, uint32_t seq, uint8_t mask, const UdpEndpoint &from);
+    static bool send_snapshot(UdpSocket &socket, const UdpEndpoint &peer, uint32_t seq, const EncodedFrame &frame);
+
+public:
+    UdpChannel(const char *port, LobbyHandler &msg_handler);
+
+    // Registra al cliente que pidió el canal y retorna el token que tiene que mandar por UDP
+    uint32_t register_client(int client_id, int game_id, const std::shared_ptr<Outbox> &outbox);
+    // Sus snapshots vuelven a TCP y el token deja de valer
+    void unregister_client(uint32_t token);
+    uint16_t get_port() const;
+
+    void run() override;
+
+    UdpChannel(const UdpChannel &) = delete;
+    UdpChannel &operator=(const UdpChannel &) = delete;
+};
+
+#endif // UDP_CHANNEL_H
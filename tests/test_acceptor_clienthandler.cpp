@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <atomic>
 #include <thread>
 #include <chrono>
 
@@ -18,7 +19,7 @@ static const char *TEST_PORT = "50100"; // usa un puerto distinto de los tests a
 class TestLobbyHandler : public LobbyHandler {
 private:
     Queue<ClientHandlerMessage> *test_inbox;
-    std::vector<std::shared_ptr<Queue<ServerMessage>>> saved_outboxes;  // Para tests de broadcast
+    std::vector<std::shared_ptr<Outbox>> saved_outboxes;  // Para tests de broadcast
 public:
     TestLobbyHandler(GameMonitor &games_mon,
                     Queue<ClientHandlerMessage> *inbox_for_test = nullptr)
@@ -35,7 +36,7 @@ public:
         // No llamar a LobbyHandler::handle_message para los tests simples
     }
     
-    std::shared_ptr<Queue<ServerMessage>> get_outbox(size_t index) {
+    std::shared_ptr<Outbox> get_outbox(size_t index) {
         if (index < saved_outboxes.size()) {
             return saved_outboxes[index];
         }
@@ -65,7 +66,7 @@ TEST(AcceptorIntegrationTest, ClientConnectsAndSendsMessage)
                 std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
         ASSERT_TRUE(got);
-        EXPECT_EQ(ch_msg.msg.cmd, MOVE_UP_PRESSED_STR);
+        EXPECT_EQ(ch_msg.msg.input.action, InputAction::MOVE_UP_PRESSED);
         EXPECT_EQ(ch_msg.msg.player_id, -1);
         EXPECT_EQ(ch_msg.msg.game_id, -1);
         
@@ -291,4 +292,62 @@ TEST(AcceptorIntegrationTest, BroadcastToMultipleClients)
     EXPECT_EQ(m2.positions[1].new_pos.direction_y, MovementDirectionY::down);
 
     server_thread3.join();
-}
\ No newline at end of file
+}
+// ================================================================
+// TEST: Un cliente desconectado por lento avisa LEAVE_GAME una sola vez
+// ================================================================
+TEST(AcceptorIntegrationTest, DroppedClientSendsLeaveGameOnce)
+{
+    Queue<ClientHandlerMessage> inbox;
+    GameMonitor games_monitor;
+    TestLobbyHandler message_handler(games_monitor, &inbox);
+    std::atomic<bool> server_done{false};
+
+    std::thread server_thread4([&]() {
+        Acceptor acceptor(TEST_PORT, message_handler);
+        acceptor.start();
+
+        ClientHandlerMessage first_msg;
+        bool got = false;
+        for (int i = 0; i < 50 && !got; ++i) {
+            got = inbox.try_pop(first_msg);
+            if (!got) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ASSERT_TRUE(got);
+
+        // Lo que hace el broadcast con un cliente que no lee
+        message_handler.get_outbox(0)->drop_client();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        // El reap y el cierre del servidor no lo vuelven a avisar
+        acceptor.stop();
+        acceptor.join();
+
+        int leaves = 0;
+        ClientHandlerMessage msg;
+        while (inbox.try_pop(msg)) {
+            if (msg.msg.cmd == LEAVE_GAME_STR)
+                ++leaves;
+        }
+        EXPECT_EQ(leaves, 1);
+        server_done = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    Socket client("localhost", TEST_PORT);
+    Protocol proto_client(std::move(client));
+    ClientMessage init_msg;
+    init_msg.cmd = MOVE_UP_PRESSED_STR;
+    proto_client.sendMessage(init_msg);
+
+    // El servidor corta la conexión
+    ServerMessage received;
+    GameJoinedResponse jr{};
+    uint8_t opcode = 0;
+    EXPECT_FALSE(proto_client.receiveAnyServerPacket(received, jr, opcode));
+
+    // El socket sigue abierto hasta que el servidor termina
+    while (!server_done)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    server_thread4.join();
+}
@@ -19,7 +19,7 @@ TEST(ClientCommunicationTest, SendAndReceiveMessage) {
 
         // Recibir mensaje y devolverlo
     ClientMessage cl_msg = proto_server.receiveClientMessage();
-    ASSERT_EQ(cl_msg.cmd, MOVE_UP_PRESSED_STR);
+    ASSERT_EQ(cl_msg.input.action, InputAction::MOVE_UP_PRESSED);
     ASSERT_EQ(cl_msg.player_id, -1);
     ASSERT_EQ(cl_msg.game_id, -1);
         // Enviar una respuesta con al menos una posición (si enviamos vacío,
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "../server/collision_merger.h"
+
+static MapLayout::CollisionPolygon box(uint16_t category, float x0, float y0, float x1, float y1)
+{
+    return {category, {b2Vec2(x0, y0), b2Vec2(x1, y0), b2Vec2(x1, y1), b2Vec2(x0, y1)}};
+}
+
+static float covered_area(const std::vector<MapLayout::CollisionPolygon> &polygons, uint16_t category)
+{
+    float area = 0.0f;
+    for (const auto &p : polygons)
+    {
+        if (p.category == category && p.vertices.size() == 4)
+            area += (p.vertices[2].x - p.vertices[0].x) * (p.vertices[2].y - p.vertices[0].y);
+    }
+    return area;
+}
+
+// ================================================================
+// TEST: Los muros pegados o superpuestos se unen sin cambiar el área
+// ================================================================
+TEST(CollisionMergerTest, JoinsWallsAndKeepsSensors)
+{
+    std::vector<MapLayout::CollisionPolygon> polygons = {
+        // Fila de 4 bloques pegados -> 1
+        box(COLLISION_FLOOR, 0, 0, 1, 1), box(COLLISION_FLOOR, 1, 0, 2, 1),
+        box(COLLISION_FLOOR, 2, 0, 3, 1), box(COLLISION_FLOOR, 3, 0, 4, 1),
+        // L superpuesta con la fila -> se cubre con rectángulos sin solaparse
+        box(COLLISION_FLOOR, 0, 0.5f, 1, 3),
+        // Otra categoría en el mismo lugar no se mezcla
+        box(COLLISION_UNDER, 0, 0, 4, 1),
+        // Sensores y polígonos no rectangulares pasan igual
+        box(SENSOR_START_BRIDGE, 5, 0, 6, 1), box(SENSOR_START_BRIDGE, 6, 0, 7, 1),
+        {COLLISION_FLOOR, {b2Vec2(10, 0), b2Vec2(12, 0), b2Vec2(11, 2)}},
+    };
+    CollisionMerger::merge(polygons);
+
+    int floor_rects = 0, sensors = 0, triangles = 0;
+    for (const auto &p : polygons)
+    {
+        if (p.vertices.size() == 3)
+            ++triangles;
+        else if (p.category == COLLISION_FLOOR)
+            ++floor_rects;
+        else if (p.category == SENSOR_START_BRIDGE)
+            ++sensors;
+    }
+    EXPECT_EQ(floor_rects, 2);
+    EXPECT_EQ(sensors, 2);
+    EXPECT_EQ(triangles, 1);
+    EXPECT_FLOAT_EQ(covered_area(polygons, COLLISION_FLOOR), 4.0f + 2.0f);
+    EXPECT_FLOAT_EQ(covered_area(polygons, COLLISION_UNDER), 4.0f);
+}
@@ -20,7 +20,7 @@ static const char *TEST_PORT = "50200";
 class TestLobbyHandler : public LobbyHandler {
 private:
     Queue<ClientHandlerMessage> *test_inbox;
-    std::vector<std::shared_ptr<Queue<ServerMessage>>> saved_outboxes;
+    std::vector<std::shared_ptr<Outbox>> saved_outboxes;
 public:
     TestLobbyHandler(GameMonitor &games_mon,
                     Queue<ClientHandlerMessage> *inbox_for_test = nullptr)
@@ -35,7 +35,7 @@ public:
         }
     }
     
-    std::shared_ptr<Queue<ServerMessage>> get_outbox(size_t index) {
+    std::shared_ptr<Outbox> get_outbox(size_t index) {
         if (index < saved_outboxes.size()) {
             return saved_outboxes[index];
         }
@@ -63,7 +63,7 @@ TEST(FullIntegrationTest, CompleteClientServerCommunication)
             if (!got) std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
         ASSERT_TRUE(got);
-        EXPECT_EQ(in.msg.cmd, MOVE_UP_PRESSED_STR);
+        EXPECT_EQ(in.msg.input.action, InputAction::MOVE_UP_PRESSED);
         EXPECT_EQ(in.msg.player_id, -1);
         EXPECT_EQ(in.msg.game_id, -1);
 
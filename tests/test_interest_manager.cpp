@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+#include "../server/gameloop/interest/interest_manager.h"
+#include "../server/server_config.h"
+
+#define NPC_ID -5
+#define SNAPSHOT_SECONDS (1.0f / 30.0f)
+
+// Radios de la configuración (las pruebas no dependen de los valores por defecto)
+struct InterestRadii
+{
+    float near;
+    float far;
+    float hysteresis;
+    int far_interval;
+};
+
+static InterestRadii radii()
+{
+    ServerConfig &config = ServerConfig::getInstance();
+    return {static_cast<float>(config.getInterestRadiusPx()), static_cast<float>(config.getInterestFarRadiusPx()),
+            static_cast<float>(config.getInterestHysteresisPx()), config.getInterestFarInterval()};
+}
+
+static PlayerPositionUpdate entity(int id, float x)
+{
+    PlayerPositionUpdate e;
+    e.player_id = id;
+    e.new_pos = Position{false, x, 0.0f, not_horizontal, not_vertical, 0.0f};
+    return e;
+}
+
+// Snapshot con los autos quietos en el origen y el NPC en (npc_x, 0)
+static std::vector<PlayerPositionUpdate> snapshot(InterestManager &interest, const std::vector<int> &cars, float npc_x)
+{
+    std::vector<PlayerPositionUpdate> entities;
+    for (int id : cars)
+        entities.push_back(entity(id, 0.0f));
+    entities.push_back(entity(NPC_ID, npc_x));
+    interest.update(entities, SNAPSHOT_SECONDS);
+    return entities;
+}
+
+// X del NPC en lo que ve el cliente; NAN si no lo recibe
+static float seen_npc_x(const std::vector<PlayerPositionUpdate> &view)
+{
+    for (const auto &e : view)
+    {
+        if (e.player_id == NPC_ID)
+            return e.new_pos.new_X;
+    }
+    return NAN;
+}
+
+// Mueve el NPC un píxel por snapshot durante 'count' snapshots a partir de x;
+// cuenta en cuántos el cliente recibió la posición actual. Cercano: en todos;
+// lejano ya enviado: en uno de cada far_interval (los demás repiten el último)
+static int fresh_views(InterestManager &interest, int viewer, float x, int count)
+{
+    int fresh = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        auto entities = snapshot(interest, {viewer}, x + i);
+        fresh += seen_npc_x(interest.view_for(viewer, entities)) == x + i ? 1 : 0;
+    }
+    return fresh;
+}
+
+// ================================================================
+// TEST: La histéresis mantiene el nivel del NPC dentro de la banda
+// ================================================================
+TEST(InterestManagerTest, HysteresisKeepsTierInsideTheBand)
+{
+    InterestRadii r = radii();
+    ASSERT_GT(r.hysteresis, 2.0f * r.far_interval);
+    ASSERT_GE(r.far_interval, 2);
+    InterestManager interest;
+    float band = r.near + r.hysteresis / 2.0f;
+
+    // Entra como cercano y en la banda sigue cercano
+    auto entities = snapshot(interest, {1}, r.near - 10.0f);
+    EXPECT_EQ(seen_npc_x(interest.view_for(1, entities)), r.near - 10.0f);
+    EXPECT_EQ(fresh_views(interest, 1, band, r.far_interval), r.far_interval);
+
+    // Pasando la banda es lejano (el primero va completo), y al volver a la banda sigue lejano
+    float outside = r.near + 2.0f * r.hysteresis;
+    EXPECT_EQ(fresh_views(interest, 1, outside, 1), 1);
+    EXPECT_EQ(fresh_views(interest, 1, outside + 1.0f, r.far_interval), 1);
+    EXPECT_EQ(fresh_views(interest, 1, band, r.far_interval), 1);
+
+    // Un NPC lejano conocido sigue llegando en la banda del radio lejano
+    entities = snapshot(interest, {1}, r.far + r.hysteresis / 2.0f);
+    EXPECT_FALSE(std::isnan(seen_npc_x(interest.view_for(1, entities))));
+    entities = snapshot(interest, {1}, r.far + 2.0f * r.hysteresis);
+    EXPECT_TRUE(std::isnan(seen_npc_x(interest.view_for(1, entities))));
+    // Uno que no se conocía no entra hasta el radio lejano
+    entities = snapshot(interest, {1}, r.far + r.hysteresis / 2.0f);
+    EXPECT_TRUE(std::isnan(seen_npc_x(interest.view_for(1, entities))));
+}
+
+// ================================================================
+// TEST: Un NPC lejano se refresca una vez cada far_interval snapshots
+// ================================================================
+TEST(InterestManagerTest, FarTierRefreshesEveryFarInterval)
+{
+    InterestRadii r = radii();
+    InterestManager interest;
+    float x = (r.near + r.far) / 2.0f;
+
+    // El primer snapshot en que aparece va completo
+    auto entities = snapshot(interest, {1}, x);
+    EXPECT_EQ(seen_npc_x(interest.view_for(1, entities)), x);
+
+    float last_sent = x;
+    int refreshes = 0;
+    for (int i = 1; i <= 3 * r.far_interval; ++i)
+    {
+        entities = snapshot(interest, {1}, x + i);
+        float seen = seen_npc_x(interest.view_for(1, entities));
+        if (seen == x + i)
+        {
+            ++refreshes;
+            last_sent = seen;
+        }
+        else
+        {
+            // Entre refrescos repite el último estado enviado
+            EXPECT_EQ(seen, last_sent);
+        }
+    }
+    EXPECT_EQ(refreshes, 3);
+}
+
+// ================================================================
+// TEST: retain descarta el estado de los clientes que no están
+// ================================================================
+TEST(InterestManagerTest, RetainDropsViewers)
+{
+    InterestRadii r = radii();
+    ASSERT_GT(r.hysteresis, 2.0f * r.far_interval);
+    ASSERT_GE(r.far_interval, 2);
+    InterestManager interest;
+
+    // Los dos clientes ven al NPC como cercano
+    auto entities = snapshot(interest, {1, 2}, r.near - 10.0f);
+    interest.view_for(1, entities);
+    interest.view_for(2, entities);
+
+    interest.retain({1});
+
+    // En la banda, el 1 lo sigue viendo cercano; el 2 empieza de cero y lo ve
+    // lejano: completo al aparecer y después una vez cada far_interval
+    float band = r.near + r.hysteresis / 2.0f;
+    int fresh_1 = 0;
+    int fresh_2 = 0;
+    for (int i = 0; i <= r.far_interval; ++i)
+    {
+        entities = snapshot(interest, {1, 2}, band + i);
+        fresh_1 += seen_npc_x(interest.view_for(1, entities)) == band + i ? 1 : 0;
+        fresh_2 += seen_npc_x(interest.view_for(2, entities)) == band + i ? 1 : 0;
+    }
+    EXPECT_EQ(fresh_1, r.far_interval + 1);
+    EXPECT_EQ(fresh_2, 2);
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#include "../server/map_cache.h"
+
+static CompiledMap sample_map()
+{
+    CompiledMap map;
+    map.polygons.push_back({COLLISION_FLOOR, {b2Vec2(0, 0), b2Vec2(1, 0), b2Vec2(1, 1)}});
+    map.polygons.push_back({SENSOR_START_BRIDGE, {b2Vec2(2, 2), b2Vec2(3, 2), b2Vec2(3, 3), b2Vec2(2, 3)}});
+    MapLayout::WaypointData wp;
+    wp.position = b2Vec2(4.5f, 6.25f);
+    wp.connections = {1, 7};
+    map.waypoints.push_back(wp);
+    map.waypoints.push_back(MapLayout::WaypointData{b2Vec2(0, 0), {}});
+    map.parked_cars.push_back({b2Vec2(8, 9), true});
+    map.spawn_points.push_back({890.0f, 700.0f, 1.5f});
+    map.checkpoints[0] = {b2Vec2(1, 2)};
+    map.checkpoints[2] = {b2Vec2(3, 4), b2Vec2(5, 6)};
+    return map;
+}
+
+static std::string temp_path()
+{
+    return ::testing::TempDir() + "map_cache_" + std::to_string(::getpid()) + ".map.bin";
+}
+
+// ================================================================
+// TEST: Lo que se guarda se vuelve a leer igual desde el archivo mapeado
+// ================================================================
+TEST(MapCacheTest, SaveLoadRoundTrip)
+{
+    std::string path = temp_path();
+    CompiledMap map = sample_map();
+    ASSERT_TRUE(MapCache::save(path, map, 42));
+
+    CompiledMap loaded;
+    ASSERT_TRUE(MapCache::load(path, 42, loaded));
+    ASSERT_EQ(loaded.polygons.size(), 2u);
+    EXPECT_EQ(loaded.polygons[1].category, SENSOR_START_BRIDGE);
+    ASSERT_EQ(loaded.polygons[1].vertices.size(), 4u);
+    EXPECT_FLOAT_EQ(loaded.polygons[1].vertices[2].x, 3.0f);
+    ASSERT_EQ(loaded.waypoints.size(), 2u);
+    EXPECT_FLOAT_EQ(loaded.waypoints[0].position.y, 6.25f);
+    EXPECT_EQ(loaded.waypoints[0].connections, (std::vector<int>{1, 7}));
+    EXPECT_TRUE(loaded.waypoints[1].connections.empty());
+    ASSERT_EQ(loaded.parked_cars.size(), 1u);
+    EXPECT_TRUE(loaded.parked_cars[0].horizontal);
+    ASSERT_EQ(loaded.spawn_points.size(), 1u);
+    EXPECT_FLOAT_EQ(loaded.spawn_points[0].angle, 1.5f);
+    EXPECT_EQ(loaded.checkpoints[0].size(), 1u);
+    EXPECT_TRUE(loaded.checkpoints[1].empty());
+    ASSERT_EQ(loaded.checkpoints[2].size(), 2u);
+    EXPECT_FLOAT_EQ(loaded.checkpoints[2][1].y, 6.0f);
+    std::remove(path.c_str());
+}
+
+// ================================================================
+// TEST: Un archivo viejo (otro stamp), truncado o inexistente se descarta
+// ================================================================
+TEST(MapCacheTest, RejectsStaleOrTruncatedFiles)
+{
+    std::string path = temp_path();
+    ASSERT_TRUE(MapCache::save(path, sample_map(), 42));
+
+    CompiledMap loaded;
+    EXPECT_FALSE(MapCache::load(path, 43, loaded));
+
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    for (size_t cut : {size_t(4), size_t(16), bytes.size() / 2, bytes.size() - 1})
+    {
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(cut));
+        EXPECT_FALSE(MapCache::load(path, 42, loaded)) << "cortado en " << cut;
+    }
+
+    std::remove(path.c_str());
+    EXPECT_FALSE(MapCache::load(path, 42, loaded));
+}
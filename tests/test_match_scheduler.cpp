@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../server/match_scheduler.h"
+
+using namespace std::chrono;
+
+// Partida de prueba: un tick cada 'period' que tarda 'cost'. Anota el atraso
+// de cada tick y el thread que lo corrió (solo lo toca el worker de turno)
+class StubMatch : public ScheduledMatch
+{
+public:
+    explicit StubMatch(microseconds period, microseconds cost = microseconds(0))
+        : period(period), cost(cost), deadline(), inits(0), ticks(0), ticking(false)
+    {
+    }
+
+    void init() override
+    {
+        deadline = steady_clock::now() + period;
+        ++inits;
+    }
+
+    void tick() override
+    {
+        ticking = true;
+        lateness.push_back(steady_clock::now() - deadline);
+        threads.push_back(std::this_thread::get_id());
+        std::this_thread::sleep_for(cost);
+        deadline += period;
+        ++ticks;
+        ticking = false;
+    }
+
+    steady_clock::time_point next_tick_deadline() const override { return deadline; }
+
+    microseconds period;
+    microseconds cost;
+    steady_clock::time_point deadline;
+    std::atomic<int> inits;
+    std::atomic<int> ticks;
+    std::atomic<bool> ticking;
+    std::vector<steady_clock::duration> lateness;
+    std::vector<std::thread::id> threads;
+};
+
+static bool wait_for(const std::atomic<int> &counter, int target, milliseconds timeout)
+{
+    auto limit = steady_clock::now() + timeout;
+    while (counter < target && steady_clock::now() < limit)
+        std::this_thread::sleep_for(milliseconds(1));
+    return counter >= target;
+}
+
+// ================================================================
+// TEST: Cada partida corre cerca de su deadline
+// ================================================================
+TEST(MatchSchedulerTest, TasksRunNearTheirDeadline)
+{
+    MatchScheduler scheduler(2);
+    StubMatch a(milliseconds(10));
+    StubMatch b(milliseconds(7));
+    scheduler.add_match(&a);
+    scheduler.add_match(&b);
+
+    ASSERT_TRUE(wait_for(a.ticks, 20, seconds(2)));
+    ASSERT_TRUE(wait_for(b.ticks, 20, seconds(2)));
+    scheduler.remove_match(&a);
+    scheduler.remove_match(&b);
+
+    EXPECT_EQ(a.inits, 1);
+    for (StubMatch *match : {&a, &b})
+    {
+        // Nunca antes de tiempo; la mediana, a menos de un período
+        std::vector<steady_clock::duration> lateness = match->lateness;
+        EXPECT_GE(*std::min_element(lateness.begin(), lateness.end()), steady_clock::duration::zero());
+        std::nth_element(lateness.begin(), lateness.begin() + lateness.size() / 2, lateness.end());
+        EXPECT_LT(lateness[lateness.size() / 2], match->period);
+    }
+}
+
+// ================================================================
+// TEST: Un worker ocioso roba la partida atrasada de un worker ocupado
+// ================================================================
+TEST(MatchSchedulerTest, OverloadedWorkerTaskIsStolen)
+{
+    MatchScheduler scheduler(2);
+    // heavy ocupa al worker 0 casi todo el tiempo; idle va al worker 1 y
+    // late, con los dos en carga 1, vuelve al worker 0
+    StubMatch heavy(microseconds(0), milliseconds(30));
+    StubMatch idle(seconds(10));
+    StubMatch late(milliseconds(5));
+    scheduler.add_match(&heavy);
+    ASSERT_TRUE(wait_for(heavy.inits, 1, seconds(1)));
+    scheduler.add_match(&idle);
+    ASSERT_TRUE(wait_for(idle.inits, 1, seconds(1)));
+    scheduler.add_match(&late);
+
+    std::this_thread::sleep_for(milliseconds(300));
+    scheduler.remove_match(&late);
+    scheduler.remove_match(&idle);
+    scheduler.remove_match(&heavy);
+
+    // Detrás de heavy tendría a lo sumo un tick cada 30 ms
+    EXPECT_GT(late.ticks, 20);
+    ASSERT_FALSE(heavy.threads.empty());
+    std::thread::id busy = heavy.threads.front();
+    EXPECT_GT(std::count_if(late.threads.begin(), late.threads.end(),
+                            [busy](std::thread::id id) { return id != busy; }),
+              20);
+}
+
+// ================================================================
+// TEST: remove_match de una partida que espera en el heap
+// ================================================================
+TEST(MatchSchedulerTest, RemoveQueuedMatch)
+{
+    MatchScheduler scheduler(1);
+    StubMatch match(milliseconds(20));
+    scheduler.add_match(&match);
+    ASSERT_TRUE(wait_for(match.inits, 1, seconds(1)));
+
+    scheduler.remove_match(&match);
+    int ticks = match.ticks;
+
+    // Ya no se la vuelve a correr aunque venzan sus deadlines
+    std::this_thread::sleep_for(milliseconds(100));
+    EXPECT_EQ(match.ticks, ticks);
+    // Una partida que ya no está no hace nada
+    scheduler.remove_match(&match);
+}
+
+// ================================================================
+// TEST: remove_match de una partida en pleno tick espera a que termine
+// ================================================================
+TEST(MatchSchedulerTest, RemoveInFlightMatchWaitsForTheTick)
+{
+    MatchScheduler scheduler(2);
+    StubMatch match(microseconds(0), milliseconds(100));
+    scheduler.add_match(&match);
+    ASSERT_TRUE(wait_for(match.inits, 1, seconds(1)));
+    while (!match.ticking)
+        std::this_thread::yield();
+
+    scheduler.remove_match(&match);
+    EXPECT_FALSE(match.ticking);
+    int ticks = match.ticks;
+    EXPECT_GE(ticks, 1);
+
+    std::this_thread::sleep_for(milliseconds(150));
+    EXPECT_EQ(match.ticks, ticks);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+#include "../server/outbox.h"
+
+static EncodedFrame frame_of(uint8_t tag)
+{
+    return std::make_shared<const std::vector<uint8_t>>(1, tag);
+}
+
+static uint8_t tag_of(const OutboundMessage &msg)
+{
+    return (*std::get<EncodedFrame>(msg))[0];
+}
+
+// ================================================================
+// TEST: Los snapshots sin enviar se reemplazan y los confiables se conservan
+// ================================================================
+TEST(OutboxTest, SnapshotsCoalesceAndReliableMessagesGoFirst)
+{
+    Outbox outbox(8);
+    int notifications = 0;
+    outbox.set_on_push([&notifications]() { ++notifications; });
+
+    outbox.offer_snapshot(frame_of(1));
+    ASSERT_TRUE(outbox.offer(frame_of(100)));
+    outbox.offer_snapshot(frame_of(2));
+    outbox.offer_snapshot(frame_of(3));
+    ASSERT_TRUE(outbox.offer(frame_of(101)));
+
+    // Un solo aviso al reactor mientras no vacíe la cola
+    EXPECT_EQ(notifications, 1);
+    EXPECT_EQ(outbox.get_replaced_snapshots(), 2u);
+    EXPECT_EQ(outbox.pending(), 2u);
+    EXPECT_GT(outbox.snapshot_lag(), std::chrono::steady_clock::duration::zero());
+
+    OutboundMessage msg;
+    ASSERT_TRUE(outbox.try_pop(msg));
+    EXPECT_EQ(tag_of(msg), 100);
+    ASSERT_TRUE(outbox.try_pop(msg));
+    EXPECT_EQ(tag_of(msg), 101);
+    ASSERT_TRUE(outbox.try_pop(msg));
+    EXPECT_EQ(tag_of(msg), 3);
+    EXPECT_FALSE(outbox.try_pop(msg));
+    EXPECT_EQ(outbox.snapshot_lag(), std::chrono::steady_clock::duration::zero());
+
+    // Vacía: el próximo snapshot vuelve a avisar
+    outbox.offer_snapshot(frame_of(4));
+    EXPECT_EQ(notifications, 2);
+}
+
+// ================================================================
+// TEST: offer no bloquea con la cola llena y drop_client cierra y avisa
+// ================================================================
+TEST(OutboxTest, FullQueueNeverBlocksAndDropClosesTheOutbox)
+{
+    Outbox outbox(2);
+    int notifications = 0;
+    outbox.set_on_push([&notifications]() { ++notifications; });
+
+    EXPECT_TRUE(outbox.offer(frame_of(1)));
+    EXPECT_TRUE(outbox.offer(frame_of(2)));
+    EXPECT_FALSE(outbox.offer(frame_of(3)));
+    // El lugar del snapshot es aparte: entra aunque la cola esté llena
+    EXPECT_NO_THROW(outbox.offer_snapshot(frame_of(4)));
+
+    OutboundMessage msg;
+    ASSERT_TRUE(outbox.try_pop(msg));
+    ASSERT_TRUE(outbox.try_pop(msg));
+    ASSERT_TRUE(outbox.try_pop(msg));
+    EXPECT_FALSE(outbox.try_pop(msg));
+
+    EXPECT_FALSE(outbox.is_dropped());
+    outbox.drop_client();
+    EXPECT_TRUE(outbox.is_dropped());
+    EXPECT_EQ(notifications, 2);
+    EXPECT_THROW(outbox.offer_snapshot(frame_of(5)), ClosedQueue);
+    EXPECT_THROW(outbox.offer(frame_of(6)), ClosedQueue);
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <set>
+
+#include "../server/player_store.h"
+
+static PlayerRecord record_for(const std::string &car_name)
+{
+    PlayerRecord record;
+    record.car_name = car_name;
+    return record;
+}
+
+// ================================================================
+// TEST: Altas, bajas y reuso de slots sin perder datos de los demás
+// ================================================================
+TEST(PlayerStoreTest, InsertEraseReusesSlotsAndKeepsOthers)
+{
+    PlayerStore players;
+    for (int id = 10; id < 14; ++id)
+    {
+        PlayerData data;
+        data.next_checkpoint = id;
+        players.insert(id, data, record_for("car" + std::to_string(id)));
+    }
+    ASSERT_EQ(players.size(), 4u);
+
+    EXPECT_TRUE(players.erase(11));
+    EXPECT_FALSE(players.erase(11));
+    EXPECT_EQ(players.find(11), nullptr);
+    EXPECT_EQ(players.find_record(11), nullptr);
+
+    // El nuevo ocupa el hueco y los demás siguen con sus datos
+    PlayerData data;
+    data.next_checkpoint = 99;
+    players.insert(50, data, record_for("nuevo"));
+    ASSERT_EQ(players.size(), 4u);
+    ASSERT_NE(players.find(50), nullptr);
+    EXPECT_EQ(players.find(50)->next_checkpoint, 99);
+    EXPECT_EQ(players.find_record(50)->car_name, "nuevo");
+    EXPECT_EQ(players.find(13)->next_checkpoint, 13);
+    EXPECT_EQ(players.find_record(13)->car_name, "car13");
+
+    std::set<int> seen;
+    for (auto [id, player_data, record] : players)
+    {
+        EXPECT_TRUE(seen.insert(id).second);
+        EXPECT_EQ(&player_data, players.find(id));
+        EXPECT_EQ(&record, players.find_record(id));
+    }
+    EXPECT_EQ(seen, (std::set<int>{10, 12, 13, 50}));
+}
+
+// ================================================================
+// TEST: La iteración saltea huecos y el store vacío no itera
+// ================================================================
+TEST(PlayerStoreTest, IterationSkipsHolesAndEmptiesCleanly)
+{
+    PlayerStore players;
+    for (int id = 0; id < 5; ++id)
+        players.insert(id, PlayerData(), PlayerRecord());
+
+    players.erase(0);
+    players.erase(2);
+    players.erase(4);
+
+    const PlayerStore &view = players;
+    int count = 0;
+    for (auto [id, player_data, record] : view)
+    {
+        EXPECT_TRUE(id == 1 || id == 3);
+        ++count;
+    }
+    EXPECT_EQ(count, 2);
+
+    players.erase(1);
+    players.erase(3);
+    EXPECT_TRUE(players.empty());
+    EXPECT_FALSE(players.begin() != players.end());
+}
@@ -1,9 +1,13 @@
 #include <gtest/gtest.h>
 #include <thread>
 #include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <netinet/in.h>
 #include "../common/protocol.h"
 #include "../common/socket.h"
 #include "../common/constants.h"
+#include "../server/gameloop/broadcast/broadcast_manager.h"
 
 // Helper para iniciar servidor y cliente en puertos distintos
 static const char* TEST_PORT = "50000";
@@ -18,7 +22,7 @@ TEST(ProtocolLocalhostTest, SendAndReceiveUpPressed) {
         Socket peer = listener.accept();         // bloqueante
         Protocol proto_server(std::move(peer));  // protocolo del servidor
     ClientMessage msg = proto_server.receiveClientMessage(); // bloqueante
-    EXPECT_EQ(msg.cmd, MOVE_UP_PRESSED_STR);
+    EXPECT_EQ(msg.input.action, InputAction::MOVE_UP_PRESSED);
     EXPECT_EQ(msg.player_id, -1);
     EXPECT_EQ(msg.game_id, -1);
     });
@@ -40,7 +44,7 @@ TEST(ProtocolLocalhostTest, SendAndReceiveRightReleased) {
         Socket peer = listener.accept();
         Protocol proto_server(std::move(peer));
     ClientMessage msg = proto_server.receiveClientMessage();
-    EXPECT_EQ(msg.cmd, MOVE_RIGHT_RELEASED_STR);
+    EXPECT_EQ(msg.input.action, InputAction::MOVE_RIGHT_RELEASED);
     EXPECT_EQ(msg.player_id, -1);
     EXPECT_EQ(msg.game_id, -1);
     });
@@ -63,12 +67,12 @@ TEST(ProtocolLocalhostTest, MultipleSequentialMessages) {
         Protocol proto_server(std::move(peer));
 
     auto m1 = proto_server.receiveClientMessage();
-    EXPECT_EQ(m1.cmd, MOVE_DOWN_PRESSED_STR);
+    EXPECT_EQ(m1.input.action, InputAction::MOVE_DOWN_PRESSED);
     EXPECT_EQ(m1.player_id, -1);
     EXPECT_EQ(m1.game_id, -1);
 
     auto m2 = proto_server.receiveClientMessage();
-    EXPECT_EQ(m2.cmd, MOVE_LEFT_RELEASED_STR);
+    EXPECT_EQ(m2.input.action, InputAction::MOVE_LEFT_RELEASED);
     EXPECT_EQ(m2.player_id, -1);
     EXPECT_EQ(m2.game_id, -1);
     });
@@ -87,3 +91,598 @@ TEST(ProtocolLocalhostTest, MultipleSequentialMessages) {
 
     server_thread.join();
 }
+
+TEST(ProtocolLocalhostTest, NonBlockingParsesFramesSplitAcrossReads) {
+    std::thread server_thread([]() {
+        Socket listener(TEST_PORT);
+        Socket peer = listener.accept();
+        Protocol proto_server(std::move(peer));
+        proto_server.setNonBlocking();
+
+        std::vector<ClientMessage> received;
+        for (int i = 0; i < 100 && received.size() < 2; ++i) {
+            ASSERT_TRUE(proto_server.readAvailable());
+            ClientMessage msg;
+            while (proto_server.nextClientMessage(msg)) {
+                received.push_back(msg);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ASSERT_EQ(received.size(), 2u);
+        EXPECT_EQ(received[0].cmd, CREATE_GAME_STR);
+        EXPECT_EQ(received[0].game_name, "sala");
+        EXPECT_EQ(received[0].map_id, 2);
+        EXPECT_EQ(received[1].input.action, InputAction::MOVE_UP_PRESSED);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    Socket client("localhost", TEST_PORT);
+    // CREATE_GAME "sala" mapa 2 seguido de MOVE_UP_PRESSED, enviados en dos partes
+    std::vector<uint8_t> bytes = {CREATE_GAME, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                  0x00, 0x04, 's', 'a', 'l', 'a', 0x02,
+                                  MOVE_UP_PRESSED, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    client.sendall(bytes.data(), 7);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    client.sendall(bytes.data() + 7, bytes.size() - 7);
+
+    server_thread.join();
+}
+
+TEST(ProtocolLocalhostTest, DeltaSnapshotsRebuildFullStateAndAck) {
+    PlayerPositionUpdate car;
+    car.player_id = 1;
+    car.new_pos = Position{false, 100.0f, 200.0f, not_horizontal, not_vertical, 90.0f};
+    car.car_type = GREEN_CAR;
+    car.hp = 80.0f;
+    car.upgrade_speed = 2;
+    PlayerPositionUpdate npc;
+    npc.player_id = 1000;
+    npc.new_pos = Position{false, 10.0f, 20.0f, not_horizontal, not_vertical, 0.0f};
+    npc.car_type = LIMOUSINE_CAR;
+    std::vector<PlayerPositionUpdate> keyframe = {car, npc};
+
+    // Tick siguiente: el auto se movió, el NPC se fue y entró otro jugador
+    std::vector<PlayerPositionUpdate> next = keyframe;
+    next[0].new_pos.new_X = 110.0f;
+    next[0].is_stopping = true;
+    next.pop_back();
+    PlayerPositionUpdate joined = car;
+    joined.player_id = 2;
+    joined.car_type = RED_JEEP_CAR;
+    next.push_back(joined);
+
+    std::thread server_thread([&]() {
+        Socket listener(TEST_PORT);
+        Socket peer = listener.accept();
+        Protocol proto_server(std::move(peer));
+        MessageEncoder encoder;
+        EncodedFrame first = encoder.encodeSnapshotDelta(10, 0, {}, keyframe);
+        EncodedFrame delta = encoder.encodeSnapshotDelta(11, 10, keyframe, next);
+        // El delta no repite el car_type ni las mejoras de lo que no cambió
+        EXPECT_LT(delta->size(), first->size());
+        proto_server.setNonBlocking();
+        proto_server.queueFrame(first);
+        proto_server.queueFrame(delta);
+        while (proto_server.hasPendingOutput()) {
+            ASSERT_TRUE(proto_server.flushPending());
+        }
+
+        std::vector<ClientMessage> acks;
+        for (int i = 0; i < 100 && acks.size() < 1; ++i) {
+            ASSERT_TRUE(proto_server.readAvailable());
+            ClientMessage msg;
+            while (proto_server.nextClientMessage(msg)) {
+                acks.push_back(msg);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ASSERT_EQ(acks.size(), 1u);
+        EXPECT_EQ(acks[0].cmd, SNAPSHOT_ACK_STR);
+        EXPECT_EQ(acks[0].snapshot_seq, 11u);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    Socket client("localhost", TEST_PORT);
+    Protocol proto_client(std::move(client));
+    ServerMessage msg;
+    GameJoinedResponse jr{};
+    uint8_t opcode = 0;
+    ASSERT_TRUE(proto_client.receiveAnyServerPacket(msg, jr, opcode));
+    EXPECT_EQ(opcode, UPDATE_POSITIONS_DELTA);
+    EXPECT_EQ(msg.snapshot_seq, 10u);
+    ASSERT_EQ(msg.positions.size(), 2u);
+
+    ASSERT_TRUE(proto_client.receiveAnyServerPacket(msg, jr, opcode));
+    EXPECT_EQ(msg.opcode, UPDATE_POSITIONS);
+    EXPECT_EQ(msg.snapshot_seq, 11u);
+    ASSERT_EQ(msg.positions.size(), 2u);
+    EXPECT_EQ(msg.positions[0].player_id, 1);
+    EXPECT_FLOAT_EQ(msg.positions[0].new_pos.new_X, 110.0f);
+    EXPECT_FLOAT_EQ(msg.positions[0].new_pos.new_Y, 200.0f);
+    EXPECT_TRUE(msg.positions[0].is_stopping);
+    EXPECT_EQ(msg.positions[0].car_type, GREEN_CAR);
+    EXPECT_FLOAT_EQ(msg.positions[0].hp, 80.0f);
+    EXPECT_EQ(msg.positions[0].upgrade_speed, 2);
+    EXPECT_EQ(msg.positions[1].player_id, 2);
+    EXPECT_EQ(msg.positions[1].car_type, RED_JEEP_CAR);
+
+    ClientMessage ack;
+    ack.cmd = SNAPSHOT_ACK_STR;
+    ack.snapshot_seq = msg.snapshot_seq;
+    proto_client.sendMessage(ack);
+
+    server_thread.join();
+}
+
+TEST(ProtocolLocalhostTest, CompactEncodingAfterHelloNegotiation) {
+    ServerMessage positions;
+    positions.opcode = UPDATE_POSITIONS;
+    PlayerPositionUpdate car;
+    car.player_id = 3;
+    car.new_pos = Position{true, 4321.37f, 17.5f, left, down, 5.9f};
+    car.next_checkpoints.push_back(Position{false, 1000.0f, 2000.0f, not_horizontal, not_vertical, 0.0f});
+    car.car_type = RED_SPORTS_CAR;
+    car.hp = 42.5f;
+    car.upgrade_handling = 3;
+    car.is_stopping = true;
+    positions.positions.push_back(car);
+    PlayerPositionUpdate npc;
+    npc.player_id = 1000;
+    npc.new_pos = Position{false, 50.0f, 60.0f, not_horizontal, not_vertical, 0.0f};
+    npc.car_type = NPC_CAR;
+    positions.positions.push_back(npc);
+
+    // El mismo snapshot en v2 ocupa menos de la mitad que en v1
+    MessageEncoder legacy_encoder;
+    MessageEncoder compact_encoder;
+    compact_encoder.setVersion(PROTOCOL_VERSION_COMPACT);
+    EXPECT_LT(compact_encoder.encodeServerMessage(positions).size(),
+              legacy_encoder.encodeServerMessage(positions).size() / 2);
+
+    std::thread server_thread([&]() {
+        Socket listener(TEST_PORT);
+        Socket peer = listener.accept();
+        Protocol proto_server(std::move(peer));
+        ClientMessage hello = proto_server.receiveClientMessage();
+        ASSERT_EQ(hello.cmd, HELLO_STR);
+        EXPECT_EQ(hello.protocol_version, PROTOCOL_VERSION);
+
+        ServerMessage reply;
+        reply.opcode = HELLO;
+        reply.protocol_version = PROTOCOL_VERSION_COMPACT;
+        proto_server.sendMessage(reply);
+        proto_server.setVersion(PROTOCOL_VERSION_COMPACT);
+        proto_server.sendMessage(positions);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    Socket client("localhost", TEST_PORT);
+    Protocol proto_client(std::move(client));
+    ClientMessage hello;
+    hello.cmd = HELLO_STR;
+    hello.protocol_version = PROTOCOL_VERSION;
+    proto_client.sendMessage(hello);
+
+    ServerMessage msg;
+    GameJoinedResponse jr{};
+    uint8_t opcode = 0;
+    ASSERT_TRUE(proto_client.receiveAnyServerPacket(msg, jr, opcode));
+    EXPECT_EQ(opcode, HELLO);
+    EXPECT_EQ(proto_client.getVersion(), PROTOCOL_VERSION_COMPACT);
+
+    ASSERT_TRUE(proto_client.receiveAnyServerPacket(msg, jr, opcode));
+    ASSERT_EQ(msg.positions.size(), 2u);
+    const Position &pos = msg.positions[0].new_pos;
+    EXPECT_TRUE(pos.on_bridge);
+    EXPECT_EQ(pos.direction_x, left);
+    EXPECT_EQ(pos.direction_y, down);
+    EXPECT_NEAR(pos.new_X, 4321.37f, 1.0f / POSITION_SCALE);
+    EXPECT_NEAR(pos.new_Y, 17.5f, 1.0f / POSITION_SCALE);
+    EXPECT_NEAR(pos.angle, 5.9f, 2.0f * M_PI / (1 << ANGLE_BITS));
+    ASSERT_EQ(msg.positions[0].next_checkpoints.size(), 1u);
+    EXPECT_NEAR(msg.positions[0].next_checkpoints[0].new_X, 1000.0f, 1.0f / POSITION_SCALE);
+    EXPECT_EQ(msg.positions[0].car_type, RED_SPORTS_CAR);
+    EXPECT_FLOAT_EQ(msg.positions[0].hp, 42.5f);
+    EXPECT_EQ(msg.positions[0].upgrade_handling, 3);
+    EXPECT_EQ(msg.positions[0].upgrade_speed, 0);
+    EXPECT_TRUE(msg.positions[0].is_stopping);
+    EXPECT_FALSE(msg.positions[0].collision_flag);
+    EXPECT_EQ(msg.positions[1].car_type, NPC_CAR);
+
+    server_thread.join();
+}
+
+TEST(ProtocolLocalhostTest, FramedMessagesCarryLengthAndSkipUnknownOpcodes) {
+    ServerMessage positions;
+    positions.opcode = UPDATE_POSITIONS;
+    for (int id = 0; id < 78; ++id) {
+        PlayerPositionUpdate entity;
+        entity.player_id = id;
+        entity.new_pos = Position{false, 10.0f * id, 20.0f, not_horizontal, not_vertical, 0.0f};
+        entity.car_type = NPC_CAR;
+        positions.positions.push_back(entity);
+    }
+
+    // v3: el largo va delante y no cuenta sus propios 4 bytes; HELLO no lo lleva
+    MessageEncoder framed_encoder;
+    framed_encoder.setVersion(PROTOCOL_VERSION_FRAMED);
+    std::vector<uint8_t> frame = framed_encoder.encodeServerMessage(positions);
+    uint32_t length;
+    std::memcpy(&length, frame.data(), sizeof(length));
+    EXPECT_EQ(ntohl(length), frame.size() - sizeof(length));
+    EXPECT_EQ(frame[sizeof(length)], UPDATE_POSITIONS);
+    ServerMessage hello_reply;
+    hello_reply.opcode = HELLO;
+    hello_reply.protocol_version = PROTOCOL_VERSION_FRAMED;
+    EXPECT_EQ(framed_encoder.encodeServerMessage(hello_reply).size(), 2u);
+
+    std::thread server_thread([&]() {
+        Socket listener(TEST_PORT);
+        Socket peer = listener.accept();
+        Protocol proto_server(std::move(peer));
+        ClientMessage hello = proto_server.receiveClientMessage();
+        ASSERT_EQ(hello.cmd, HELLO_STR);
+
+        proto_server.setVersion(PROTOCOL_VERSION_FRAMED);
+        proto_server.sendMessage(hello_reply);
+        proto_server.sendMessage(positions);
+        ServerMessage unknown;
+        unknown.opcode = 0x7E;  // opcode de una versión futura
+        proto_server.sendMessage(unknown);
+        ServerMessage started;
+        started.opcode = GAME_STARTED;
+        proto_server.sendMessage(started);
+        proto_server.sendMessage(positions);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    Socket client("localhost", TEST_PORT);
+    Protocol proto_client(std::move(client));
+    ClientMessage hello;
+    hello.cmd = HELLO_STR;
+    hello.protocol_version = PROTOCOL_VERSION;
+    proto_client.sendMessage(hello);
+
+    ServerMessage msg;
+    GameJoinedResponse jr{};
+    uint8_t opcode = 0;
+    ASSERT_TRUE(proto_client.receiveAnyServerPacket(msg, jr, opcode));
+    EXPECT_EQ(opcode, HELLO);
+    EXPECT_EQ(proto_client.getVersion(), PROTOCOL_VERSION_FRAMED);
+
+    ASSERT_TRUE(proto_client.receiveAnyServerPacket(msg, jr, opcode));
+    EXPECT_EQ(opcode, UPDATE_POSITIONS);
+    ASSERT_EQ(msg.positions.size(), 78u);
+    EXPECT_EQ(msg.positions[77].player_id, 77);
+    EXPECT_NEAR(msg.positions[77].new_pos.new_X, 770.0f, 1.0f / POSITION_SCALE);
+
+    // El desconocido se saltea sin perder la sincronía con los siguientes
+    ASSERT_TRUE(proto_client.receiveAnyServerPacket(msg, jr, opcode));
+    EXPECT_EQ(opcode, 0x7E);
+    ASSERT_TRUE(proto_client.receiveAnyServerPacket(msg, jr, opcode));
+    EXPECT_EQ(opcode, GAME_STARTED);
+    ServerMessage last;
+    ASSERT_TRUE(proto_client.receiveAnyServerPacket(last, jr, opcode));
+    EXPECT_EQ(last.positions.size(), 78u);
+
+    server_thread.join();
+
+    // Con el peer cerrado no hay más frames
+    EXPECT_FALSE(proto_client.receiveAnyServerPacket(msg, jr, opcode));
+}
+
+TEST(ProtocolLocalhostTest, BroadcastGameStartedIsFramedForEachVersion) {
+    // Un cliente v3 y uno legacy en la misma partida: cada uno recibe su frame
+    std::mutex players_mutex;
+    PlayerStore players;
+    std::unordered_map<int, std::shared_ptr<Outbox>> outboxes;
+    auto framed_outbox = std::make_shared<Outbox>(8);
+    framed_outbox->set_wire_version(PROTOCOL_VERSION_FRAMED);
+    auto legacy_outbox = std::make_shared<Outbox>(8);
+    outboxes[1] = framed_outbox;
+    outboxes[2] = legacy_outbox;
+    TickProfiler profiler;
+    BroadcastManager broadcaster(players_mutex, players, outboxes, profiler);
+    broadcaster.broadcast_game_started();
+
+    OutboundMessage legacy_msg;
+    ASSERT_TRUE(legacy_outbox->try_pop(legacy_msg));
+    EXPECT_EQ(*std::get<EncodedFrame>(legacy_msg), std::vector<uint8_t>{GAME_STARTED});
+    OutboundMessage framed_msg;
+    ASSERT_TRUE(framed_outbox->try_pop(framed_msg));
+    EncodedFrame game_started = std::get<EncodedFrame>(framed_msg);
+
+    ServerMessage positions;
+    positions.opcode = UPDATE_POSITIONS;
+    PlayerPositionUpdate entity;
+    entity.player_id = 1;
+    entity.new_pos = Position{false, 64.0f, 32.0f, not_horizontal, not_vertical, 0.0f};
+    entity.car_type = NPC_CAR;
+    positions.positions.push_back(entity);
+
+    std::thread server_thread([&]() {
+        Socket listener(TEST_PORT);
+        Socket peer = listener.accept();
+        Protocol proto_server(std::move(peer));
+        ASSERT_EQ(proto_server.receiveClientMessage().cmd, HELLO_STR);
+        proto_server.setVersion(PROTOCOL_VERSION_FRAMED);
+        ServerMessage hello_reply;
+        hello_reply.opcode = HELLO;
+        hello_reply.protocol_version = PROTOCOL_VERSION_FRAMED;
+        proto_server.sendMessage(hello_reply);
+
+        // El frame del broadcast tal cual lo manda el reactor, seguido de un snapshot
+        proto_server.queueFrame(game_started);
+        proto_server.queueMessage(positions);
+        while (proto_server.hasPendingOutput())
+            ASSERT_TRUE(proto_server.flushPending());
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    Socket client("localhost", TEST_PORT);
+    Protocol proto_client(std::move(client));
+    ClientMessage hello;
+    hello.cmd = HELLO_STR;
+    hello.protocol_version = PROTOCOL_VERSION;
+    proto_client.sendMessage(hello);
+
+    ServerMessage msg;
+    GameJoinedResponse jr{};
+    uint8_t opcode = 0;
+    ASSERT_TRUE(proto_client.receiveAnyServerPacket(msg, jr, opcode));
+    ASSERT_EQ(proto_client.getVersion(), PROTOCOL_VERSION_FRAMED);
+    ASSERT_TRUE(proto_client.receiveAnyServerPacket(msg, jr, opcode));
+    EXPECT_EQ(opcode, GAME_STARTED);
+    // El siguiente frame sigue en sincronía
+    ASSERT_TRUE(proto_client.receiveAnyServerPacket(msg, jr, opcode));
+    EXPECT_EQ(opcode, UPDATE_POSITIONS);
+    ASSERT_EQ(msg.positions.size(), 1u);
+    EXPECT_EQ(msg.positions[0].player_id, 1);
+
+    server_thread.join();
+}
+
+TEST(BroadcastManagerTest, DisconnectedPlayersAreLeftForTheGameToRemove) {
+    // Uno cerró su outbox y otro no tiene lugar para un mensaje confiable
+    std::mutex players_mutex;
+    PlayerStore players;
+    std::unordered_map<int, std::shared_ptr<Outbox>> outboxes;
+    auto healthy = std::make_shared<Outbox>(8);
+    auto closed = std::make_shared<Outbox>(8);
+    closed->close();
+    auto full = std::make_shared<Outbox>(1);
+    ASSERT_TRUE(full->offer(std::make_shared<const std::vector<uint8_t>>(1, GAME_STARTED)));
+    outboxes[1] = healthy;
+    outboxes[2] = closed;
+    outboxes[3] = full;
+    TickProfiler profiler;
+    BroadcastManager broadcaster(players_mutex, players, outboxes, profiler);
+
+    broadcaster.broadcast_game_started();
+    broadcaster.broadcast_game_started();
+
+    std::vector<int> disconnected = broadcaster.take_disconnected();
+    std::sort(disconnected.begin(), disconnected.end());
+    EXPECT_EQ(disconnected, (std::vector<int>{2, 3}));
+    EXPECT_TRUE(full->is_dropped());
+    // El broadcast no los saca: lo hace la partida con PlayerManager::remove_player
+    EXPECT_EQ(outboxes.size(), 3u);
+    EXPECT_TRUE(broadcaster.take_disconnected().empty());
+}
+
+TEST(ProtocolLocalhostTest, BatchesAndQueuedFramesGoOutWithGatherWrites) {
+    std::thread server_thread([]() {
+        Socket listener(TEST_PORT);
+        Socket peer = listener.accept();
+        Protocol proto_server(std::move(peer));
+        proto_server.setNoDelay(true);
+
+        // El lote del cliente llega completo y en orden
+        EXPECT_EQ(proto_server.receiveClientMessage().input.action, InputAction::MOVE_UP_PRESSED);
+        EXPECT_EQ(proto_server.receiveClientMessage().input.action, InputAction::MOVE_LEFT_PRESSED);
+        EXPECT_EQ(proto_server.receiveClientMessage().cmd, GET_GAMES_STR);
+
+        // Más frames de los que entran en un writev
+        proto_server.setNonBlocking();
+        for (int i = 0; i < 150; ++i) {
+            ServerMessage msg;
+            msg.opcode = (i % 2 == 0) ? GAME_STARTED : STARTING_COUNTDOWN;
+            proto_server.queueMessage(msg);
+        }
+        EXPECT_EQ(proto_server.pendingOutputBytes(), 150u);
+        for (int i = 0; i < 100 && proto_server.hasPendingOutput(); ++i) {
+            ASSERT_TRUE(proto_server.flushPending());
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        EXPECT_FALSE(proto_server.hasPendingOutput());
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    Socket client("localhost", TEST_PORT);
+    Protocol proto_client(std::move(client));
+    proto_client.setNoDelay(true);
+    std::vector<ClientMessage> batch(3);
+    batch[0].cmd = MOVE_UP_PRESSED_STR;
+    batch[1].cmd = MOVE_LEFT_PRESSED_STR;
+    batch[2].cmd = GET_GAMES_STR;
+    proto_client.sendMessages(batch);
+
+    ServerMessage msg;
+    GameJoinedResponse jr{};
+    uint8_t opcode = 0;
+    for (int i = 0; i < 150; ++i) {
+        ASSERT_TRUE(proto_client.receiveAnyServerPacket(msg, jr, opcode));
+        EXPECT_EQ(opcode, (i % 2 == 0) ? GAME_STARTED : STARTING_COUNTDOWN);
+    }
+
+    server_thread.join();
+}
+
+TEST(ProtocolLocalhostTest, DatagramSnapshotsDropStaleAndCarryInputMasks) {
+    const uint32_t token = 0xC0FFEE;
+    ServerMessage positions;
+    positions.opcode = UPDATE_POSITIONS;
+    PlayerPositionUpdate entity;
+    entity.player_id = 4;
+    entity.new_pos = Position{false, 32.0f, 16.0f, not_horizontal, not_vertical, 0.0f};
+    entity.car_type = NPC_CAR;
+    positions.positions.push_back(entity);
+    MessageEncoder framed_encoder;
+    framed_encoder.setVersion(PROTOCOL_VERSION_FRAMED);
+    std::vector<uint8_t> frame = framed_encoder.encodeServerMessage(positions);
+
+    std::thread server_thread([&]() {
+        Socket listener(TEST_PORT);
+        UdpSocket udp(TEST_PORT);
+        Socket peer = listener.accept();
+        Protocol proto_server(std::move(peer));
+        ASSERT_EQ(proto_server.receiveClientMessage().cmd, HELLO_STR);
+        proto_server.setVersion(PROTOCOL_VERSION_FRAMED);
+        ServerMessage hello_reply;
+        hello_reply.opcode = HELLO;
+        hello_reply.protocol_version = PROTOCOL_VERSION_FRAMED;
+        proto_server.sendMessage(hello_reply);
+
+        // BIND con el token: se contesta con el mismo datagrama
+        uint8_t buf[MAX_DATAGRAM_BYTES];
+        UdpEndpoint client_addr{};
+        int s = udp.recv_from(buf, sizeof(buf), client_addr);
+        ASSERT_EQ(s, 5);
+        ASSERT_EQ(buf[0], DATAGRAM_BIND);
+        uint32_t bound;
+        std::memcpy(&bound, buf + 1, sizeof(bound));
+        EXPECT_EQ(ntohl(bound), token);
+        udp.send_to(buf, s, client_addr);
+
+        // El seq 1 llega después del 2: el cliente tiene que ignorarlo
+        for (uint32_t seq : {2u, 1u, 3u}) {
+            std::vector<uint8_t> datagram(1 + sizeof(seq));
+            datagram[0] = DATAGRAM_SNAPSHOT;
+            uint32_t net_seq = htonl(seq);
+            std::memcpy(datagram.data() + 1, &net_seq, sizeof(net_seq));
+            datagram.insert(datagram.end(), frame.begin(), frame.end());
+            udp.send_to(datagram.data(), datagram.size(), client_addr);
+        }
+
+        s = udp.recv_from(buf, sizeof(buf), client_addr);
+        ASSERT_EQ(s, 10);
+        EXPECT_EQ(buf[0], DATAGRAM_INPUT);
+        EXPECT_EQ(buf[9], INPUT_MASK_UP | INPUT_MASK_LEFT);
+
+        // TCP sigue funcionando en paralelo
+        ServerMessage started;
+        started.opcode = GAME_STARTED;
+        proto_server.sendMessage(started);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    Socket client("localhost", TEST_PORT);
+    Protocol proto_client(std::move(client));
+    ClientMessage hello;
+    hello.cmd = HELLO_STR;
+    hello.protocol_version = PROTOCOL_VERSION;
+    proto_client.sendMessage(hello);
+
+    ServerMessage msg;
+    GameJoinedResponse jr{};
+    uint8_t opcode = 0;
+    ASSERT_TRUE(proto_client.receiveAnyServerPacket(msg, jr, opcode));
+    ASSERT_EQ(opcode, HELLO);
+
+    proto_client.openDatagramChannel(static_cast<uint16_t>(std::stoi(TEST_PORT)), token);
+    EXPECT_FALSE(proto_client.datagramChannelReady());
+    // Sin confirmar el token no sale ningún input
+    proto_client.sendInputMask(INPUT_MASK_DOWN);
+
+    ASSERT_TRUE(proto_client.receiveAnyServerPacket(msg, jr, opcode));
+    EXPECT_EQ(opcode, UPDATE_POSITIONS);
+    ASSERT_EQ(msg.positions.size(), 1u);
+    EXPECT_EQ(msg.positions[0].player_id, 4);
+    EXPECT_TRUE(proto_client.datagramChannelReady());
+    proto_client.sendInputMask(INPUT_MASK_UP | INPUT_MASK_LEFT);
+
+    ServerMessage newer;
+    ASSERT_TRUE(proto_client.receiveAnyServerPacket(newer, jr, opcode));
+    EXPECT_EQ(opcode, UPDATE_POSITIONS);
+    ASSERT_TRUE(proto_client.receiveAnyServerPacket(msg, jr, opcode));
+    EXPECT_EQ(opcode, GAME_STARTED);
+
+    server_thread.join();
+}
+
+TEST(ProtocolLocalhostTest, GameActionsArriveAsTypedInputs) {
+    // Comando textual (como lo arma el cliente) y acción tipada producen el mismo frame
+    ClientMessage textual;
+    textual.cmd = std::string(CHANGE_CAR_STR) + " " + LIMOUSINE_CAR;
+    textual.car_type = LIMOUSINE_CAR;
+    ClientMessage typed;
+    typed.input = InputEvent{InputAction::CHANGE_CAR, 6};
+    MessageEncoder encoder;
+    std::vector<uint8_t> textual_frame = encoder.encodeClientMessage(textual);
+    EXPECT_EQ(textual_frame, encoder.encodeClientMessage(typed));
+
+    std::thread server_thread([]() {
+        Socket listener(TEST_PORT);
+        Socket peer = listener.accept();
+        Protocol proto_server(std::move(peer));
+
+        ClientMessage car = proto_server.receiveClientMessage();
+        EXPECT_EQ(car.opcode, CHANGE_CAR);
+        EXPECT_EQ(car.input.action, InputAction::CHANGE_CAR);
+        ASSERT_LT(car.input.arg, CAR_TYPES_COUNT);
+        EXPECT_STREQ(CAR_TYPES[car.input.arg], RED_JEEP_CAR);
+
+        ClientMessage upgrade = proto_server.receiveClientMessage();
+        EXPECT_EQ(upgrade.input.action, InputAction::UPGRADE_HANDLING);
+
+        ClientMessage cheat = proto_server.receiveClientMessage();
+        EXPECT_EQ(cheat.input.action, InputAction::CHEAT_SKIP_LAP);
+        EXPECT_EQ(cheat.player_id, 7);
+
+        ClientMessage unknown_car = proto_server.receiveClientMessage();
+        EXPECT_EQ(unknown_car.opcode, CHANGE_CAR);
+        EXPECT_EQ(unknown_car.input.action, InputAction::NONE);
+
+        ClientMessage lobby = proto_server.receiveClientMessage();
+        EXPECT_EQ(lobby.cmd, GET_GAMES_STR);
+        EXPECT_EQ(lobby.input.action, InputAction::NONE);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    Socket client("localhost", TEST_PORT);
+    Protocol proto_client(std::move(client));
+
+    ClientMessage car;
+    car.cmd = std::string(CHANGE_CAR_STR) + " " + RED_JEEP_CAR;
+    car.car_type = RED_JEEP_CAR;
+    proto_client.sendMessage(car);
+
+    ClientMessage upgrade;
+    upgrade.cmd = UPGRADE_CAR_STR;
+    upgrade.upgrade_type = CarUpgrade::HANDLING_IMPROVEMENT;
+    proto_client.sendMessage(upgrade);
+
+    ClientMessage cheat;
+    cheat.input.action = InputAction::CHEAT_SKIP_LAP;
+    cheat.player_id = 7;
+    proto_client.sendMessage(cheat);
+
+    ClientMessage unknown_car;
+    unknown_car.cmd = CHANGE_CAR_STR;
+    unknown_car.car_type = "tanque";
+    proto_client.sendMessage(unknown_car);
+
+    ClientMessage lobby;
+    lobby.cmd = GET_GAMES_STR;
+    proto_client.sendMessage(lobby);
+
+    server_thread.join();
+}
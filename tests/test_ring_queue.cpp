@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../common/ring_queue.h"
+
+// ================================================================
+// TEST: Varios productores y un consumidor: llegan todos, en orden por productor
+// ================================================================
+TEST(RingQueueTest, MultipleProducersDeliverEverythingInOrder)
+{
+    const int producers = 4;
+    const int per_producer = 20000;
+    RingQueue<std::pair<int, int>> queue(64);  // chica a propósito: los productores se bloquean
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&queue, p]() {
+            for (int i = 0; i < per_producer; ++i)
+                queue.push(std::make_pair(p, i));
+        });
+    }
+
+    std::vector<int> next(producers, 0);
+    for (int n = 0; n < producers * per_producer; ++n)
+    {
+        auto [p, i] = queue.pop();
+        ASSERT_EQ(i, next[p]) << "Desorden en el productor " << p;
+        ++next[p];
+    }
+    for (auto &t : threads)
+        t.join();
+
+    std::pair<int, int> extra;
+    EXPECT_FALSE(queue.try_pop(extra));
+}
+
+// ================================================================
+// TEST: Llena, try_pop_all por lotes y semántica de cierre igual a Queue
+// ================================================================
+TEST(RingQueueTest, BatchDrainAndCloseSemantics)
+{
+    RingQueue<std::unique_ptr<int>> queue(5);
+    ASSERT_EQ(queue.capacity(), 8u);
+
+    for (int i = 0; i < 8; ++i)
+        ASSERT_TRUE(queue.try_push(std::make_unique<int>(i)));
+
+    // Llena: el valor no se consume si el push falla
+    auto rejected = std::make_unique<int>(99);
+    EXPECT_FALSE(queue.try_push(std::move(rejected)));
+    ASSERT_NE(rejected, nullptr);
+
+    std::vector<std::unique_ptr<int>> batch;
+    EXPECT_EQ(queue.try_pop_all(batch, 3), 3u);
+    EXPECT_EQ(queue.try_pop_all(batch), 5u);
+    ASSERT_EQ(batch.size(), 8u);
+    for (int i = 0; i < 8; ++i)
+        EXPECT_EQ(*batch[i], i);
+    EXPECT_EQ(queue.try_pop_all(batch), 0u);
+
+    // Lo encolado antes de cerrar se sigue entregando; después, ClosedQueue
+    ASSERT_TRUE(queue.try_push(std::make_unique<int>(7)));
+    queue.close();
+    EXPECT_THROW(queue.try_push(std::make_unique<int>(8)), ClosedQueue);
+    EXPECT_THROW(queue.close(), std::runtime_error);
+    EXPECT_EQ(*queue.pop(), 7);
+    std::unique_ptr<int> val;
+    EXPECT_THROW(queue.try_pop(val), ClosedQueue);
+    EXPECT_THROW(queue.pop(), ClosedQueue);
+}
+
+// ================================================================
+// TEST: close() despierta al consumidor bloqueado en pop()
+// ================================================================
+TEST(RingQueueTest, CloseWakesBlockedConsumer)
+{
+    RingQueue<int, RingProducers::SINGLE> queue(4);
+    bool closed_seen = false;
+    std::thread consumer([&]() {
+        try
+        {
+            queue.pop();
+        }
+        catch (const ClosedQueue &)
+        {
+            closed_seen = true;
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    queue.close();
+    consumer.join();
+    EXPECT_TRUE(closed_seen);
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "../server/gameloop/npc/point_kd_tree.h"
+#include "../server/gameloop/npc/road_graph.h"
+
+static MapLayout::WaypointData waypoint(float x, float y, std::vector<int> connections)
+{
+    MapLayout::WaypointData wp;
+    wp.position = b2Vec2(x, y);
+    wp.connections = std::move(connections);
+    return wp;
+}
+
+// ================================================================
+// TEST: CSR con largos y próximo salto por el camino más corto
+// ================================================================
+TEST(RoadGraphTest, NextHopFollowsShortestDirectedPath)
+{
+    // 0 -> 1 -> 2 es más corto que el atajo 0 -> 3 -> 2; 4 no sale a ningún lado
+    std::vector<MapLayout::WaypointData> waypoints = {
+        waypoint(0, 0, {1, 3, 99}),
+        waypoint(1, 0, {2}),
+        waypoint(2, 0, {0}),
+        waypoint(1, 5, {2}),
+        waypoint(9, 9, {}),
+    };
+    RoadGraph graph;
+    graph.build(waypoints);
+    ASSERT_EQ(graph.size(), 5);
+    ASSERT_TRUE(graph.has_routes());
+
+    // La conexión a un waypoint inexistente (99) se descarta
+    ASSERT_EQ(graph.neighbors(0).size(), 2u);
+    EXPECT_FLOAT_EQ(graph.edge_lengths(0)[0], 1.0f);
+    EXPECT_TRUE(graph.neighbors(4).empty());
+
+    EXPECT_EQ(graph.next_hop(0, 2), 1);
+    EXPECT_EQ(graph.next_hop(1, 2), 2);
+    EXPECT_EQ(graph.next_hop(3, 0), 2);
+    EXPECT_EQ(graph.next_hop(2, 3), 0);
+    EXPECT_EQ(graph.next_hop(1, 1), 1);
+
+    // Aristas dirigidas: a 4 no se llega y desde 4 no se sale
+    EXPECT_EQ(graph.next_hop(0, 4), RoadGraph::NO_ROUTE);
+    EXPECT_EQ(graph.next_hop(4, 0), RoadGraph::NO_ROUTE);
+    EXPECT_EQ(graph.next_hop(0, 7), RoadGraph::NO_ROUTE);
+}
+
+// ================================================================
+// TEST: El KD-tree responde igual que la búsqueda lineal
+// ================================================================
+TEST(RoadGraphTest, KdTreeMatchesLinearSearch)
+{
+    std::vector<b2Vec2> points;
+    for (int i = 0; i < 200; ++i)
+        points.push_back(b2Vec2(static_cast<float>((i * 37) % 101), static_cast<float>((i * 53) % 89)));
+    PointKdTree tree(points);
+
+    EXPECT_FALSE(PointKdTree({}).any_within(b2Vec2(0, 0), 100.0f));
+    for (float x = -5.0f; x < 110.0f; x += 3.7f)
+    {
+        for (float y = -5.0f; y < 95.0f; y += 4.3f)
+        {
+            b2Vec2 center(x, y);
+            for (float radius : {0.5f, 1.5f, 4.0f})
+            {
+                bool expected = false;
+                for (const auto &p : points)
+                    expected = expected || (p - center).Length() < radius;
+                ASSERT_EQ(tree.any_within(center, radius), expected) << x << "," << y << " r=" << radius;
+            }
+        }
+    }
+}
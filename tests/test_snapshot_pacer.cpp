@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "../server/gameloop/tick/snapshot_pacer.h"
+
+static std::vector<int> ticks_between_snapshots(SnapshotPacer &pacer, int ticks)
+{
+    std::vector<int> gaps;
+    int since = 0;
+    for (int i = 0; i < ticks; ++i)
+    {
+        ++since;
+        if (pacer.tick())
+        {
+            gaps.push_back(since);
+            since = 0;
+        }
+    }
+    return gaps;
+}
+
+// ================================================================
+// TEST: Los snapshots se reparten parejo entre los ticks de física
+// ================================================================
+TEST(SnapshotPacerTest, SpreadsSnapshotsEvenlyAcrossTicks)
+{
+    SnapshotPacer half(60, 30);
+    std::vector<int> gaps = ticks_between_snapshots(half, 60);
+    ASSERT_EQ(gaps.size(), 30u);
+    // El primer tick manda; después uno cada dos
+    EXPECT_EQ(gaps[0], 1);
+    for (size_t i = 1; i < gaps.size(); ++i)
+        EXPECT_EQ(gaps[i], 2);
+    EXPECT_FLOAT_EQ(half.interval_seconds(), 2.0f / 60.0f);
+
+    // 60/25 no es entero: en un segundo salen exactamente 25, separados por 2 o 3 ticks
+    SnapshotPacer uneven(60, 25);
+    gaps = ticks_between_snapshots(uneven, 60);
+    ASSERT_EQ(gaps.size(), 25u);
+    for (size_t i = 1; i < gaps.size(); ++i)
+        EXPECT_TRUE(gaps[i] == 2 || gaps[i] == 3);
+
+    // 0 o más que el tick: uno por tick
+    SnapshotPacer every(60, 0);
+    EXPECT_EQ(ticks_between_snapshots(every, 10).size(), 10u);
+    EXPECT_EQ(every.get_rate(), 60);
+    every.set_rate(120);
+    EXPECT_EQ(every.get_rate(), 60);
+
+    // El cambio de frecuencia vale desde el tick siguiente
+    every.set_rate(20);
+    EXPECT_EQ(ticks_between_snapshots(every, 60).size(), 20u);
+}
+
+// ================================================================
+// TEST: Un cliente que pisa snapshots baja su frecuencia y la recupera
+// ================================================================
+TEST(SnapshotPacerTest, SlowClientSkipsSnapshotsAndRecovers)
+{
+    ClientSnapshotRate rate;
+    uint64_t replaced = 0;
+    EXPECT_TRUE(rate.due(replaced, 4, 3));
+    EXPECT_TRUE(rate.due(replaced, 4, 3));
+    EXPECT_EQ(rate.divisor(), 1);
+
+    // El outbox pisó uno: pasa a recibir uno de cada dos
+    replaced = 1;
+    EXPECT_FALSE(rate.due(replaced, 4, 3));
+    EXPECT_TRUE(rate.due(replaced, 4, 3));
+    EXPECT_EQ(rate.divisor(), 2);
+
+    // Sigue pisando: uno de cada cuatro, sin pasar el máximo
+    replaced = 3;
+    int sent = 0;
+    for (int i = 0; i < 8; ++i)
+        sent += rate.due(replaced, 4, 100) ? 1 : 0;
+    EXPECT_EQ(sent, 2);
+    EXPECT_EQ(rate.divisor(), 4);
+    replaced = 4;
+    rate.due(replaced, 4, 100);
+    EXPECT_EQ(rate.divisor(), 4);
+
+    // recover_after envíos limpios: vuelve a duplicar la frecuencia
+    for (int i = 0; i < 3 * 4; ++i)
+        rate.due(replaced, 4, 3);
+    EXPECT_EQ(rate.divisor(), 2);
+
+    // Si la partida baja su frecuencia, el máximo se respeta enseguida
+    replaced = 5;
+    rate.due(replaced, 1, 3);
+    EXPECT_EQ(rate.divisor(), 1);
+}
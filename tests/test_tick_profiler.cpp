@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+#include "../server/gameloop/tick/tick_profiler.h"
+
+using namespace std::chrono;
+
+// ================================================================
+// TEST: Cada fase acumula en su histograma y los percentiles caen en su bucket
+// ================================================================
+TEST(TickProfilerTest, PhasesAccumulateAndPercentilesUseBuckets)
+{
+    TickProfiler profiler;
+    auto t0 = TickProfiler::clock::now();
+    // 99 fases de 3 us (bucket [2, 4)) y una de 1000 us (bucket [512, 1024))
+    for (int i = 0; i < 99; ++i)
+        profiler.record(TickPhase::PHYSICS_STEP, t0, t0 + microseconds(3));
+    profiler.record(TickPhase::PHYSICS_STEP, t0, t0 + microseconds(1000));
+    profiler.record(TickPhase::BROADCAST, t0, t0 + microseconds(40));
+    profiler.add_encoded(100);
+    profiler.add_encoded(28);
+
+    TickProfiler::Report report = profiler.report();
+    const auto &physics = report.phases[static_cast<size_t>(TickPhase::PHYSICS_STEP)];
+    EXPECT_EQ(physics.count, 100u);
+    EXPECT_EQ(physics.total_us, 99u * 3u + 1000u);
+    EXPECT_EQ(physics.max_us, 1000u);
+    EXPECT_EQ(physics.p50_us, 4u);
+    EXPECT_EQ(physics.p99_us, 4u);
+
+    const auto &broadcast = report.phases[static_cast<size_t>(TickPhase::BROADCAST)];
+    EXPECT_EQ(broadcast.count, 1u);
+    EXPECT_EQ(broadcast.p99_us, 64u);
+    EXPECT_EQ(report.phases[static_cast<size_t>(TickPhase::EVENTS)].count, 0u);
+    EXPECT_EQ(report.encoded_bytes, 128u);
+    EXPECT_EQ(report.encoded_frames, 2u);
+
+    std::mutex mtx;
+    {
+        auto lk = profiler.lock_timed(mtx);
+        EXPECT_TRUE(lk.owns_lock());
+    }
+    EXPECT_EQ(profiler.report().phases[static_cast<size_t>(TickPhase::LOCK_WAIT)].count, 1u);
+}
+
+// ================================================================
+// TEST: El trace guarda solo los últimos eventos, del más viejo al más nuevo
+// ================================================================
+TEST(TickProfilerTest, TraceKeepsNewestEventsInOrder)
+{
+    TickProfiler profiler;
+    auto t0 = TickProfiler::clock::time_point(seconds(1));
+    size_t total = TickProfiler::TRACE_CAPACITY + 10;
+    for (size_t i = 0; i < total; ++i)
+        profiler.record(TickPhase::NPC_UPDATE, t0 + microseconds(i), t0 + microseconds(i + 1));
+
+    std::ostringstream out;
+    bool first = true;
+    profiler.write_trace_events(out, 7, first);
+    std::string trace = out.str();
+    EXPECT_FALSE(first);
+
+    size_t events = 0;
+    for (size_t pos = trace.find("\"ph\":\"X\""); pos != std::string::npos; pos = trace.find("\"ph\":\"X\"", pos + 1))
+        ++events;
+    EXPECT_EQ(events, TickProfiler::TRACE_CAPACITY);
+
+    // Los 10 primeros se pisaron: el primero que queda empieza en t0 + 10 us
+    EXPECT_EQ(trace.find("\"ts\":1000010"), trace.find("\"ts\":"));
+    EXPECT_NE(trace.find("\"tid\":7"), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"npc_update\""), std::string::npos);
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "../server/gameloop/tick/tick_scheduler.h"
+
+using namespace std::chrono;
+
+// Un tick cuyo trabajo termina en 'until'
+static void run_tick(TickScheduler &scheduler, TickScheduler::clock::time_point until)
+{
+    scheduler.begin_tick();
+    std::this_thread::sleep_until(until);
+    scheduler.end_tick();
+}
+
+// ================================================================
+// TEST: end_tick cuenta deadlines perdidos, recupera y resincroniza
+// ================================================================
+TEST(TickSchedulerTest, EndTickCountsMissedDeadlinesAndResyncs)
+{
+    // 100 Hz: 10 ms por tick; se recuperan hasta 2 ticks de atraso
+    TickScheduler scheduler(100, 2);
+    const auto period = milliseconds(10);
+    scheduler.start();
+
+    // A tiempo: el deadline avanza un período exacto
+    auto deadline = scheduler.next_deadline();
+    run_tick(scheduler, TickScheduler::clock::now());
+    EXPECT_EQ(scheduler.next_deadline(), deadline + period);
+    TickStats stats = scheduler.get_stats();
+    EXPECT_EQ(stats.ticks, 1u);
+    EXPECT_EQ(stats.missed_deadlines, 0u);
+    EXPECT_GT(stats.last_slack_ms, 0.0);
+
+    // Atrasado menos que el máximo: deadline perdido, pero el siguiente sigue
+    // la grilla (ya vencido, corre sin esperar) y no se descarta nada
+    deadline = scheduler.next_deadline();
+    run_tick(scheduler, deadline + period + milliseconds(3));
+    EXPECT_EQ(scheduler.next_deadline(), deadline + period);
+    EXPECT_LT(scheduler.next_deadline(), TickScheduler::clock::now());
+    stats = scheduler.get_stats();
+    EXPECT_EQ(stats.missed_deadlines, 1u);
+    EXPECT_EQ(stats.skipped_ticks, 0u);
+    EXPECT_LT(stats.last_slack_ms, 0.0);
+    EXPECT_LT(stats.min_slack_ms, 0.0);
+
+    // Más de max_catchup_ticks de atraso: se descartan los ticks enteros que
+    // pasaron y el próximo deadline se cuenta desde ahora
+    deadline = scheduler.next_deadline();
+    run_tick(scheduler, deadline + period + milliseconds(55));
+    auto after = TickScheduler::clock::now();
+    EXPECT_GT(scheduler.next_deadline(), after);
+    EXPECT_LE(scheduler.next_deadline(), after + period);
+    stats = scheduler.get_stats();
+    EXPECT_EQ(stats.ticks, 3u);
+    EXPECT_EQ(stats.missed_deadlines, 2u);
+    EXPECT_GE(stats.skipped_ticks, 5u);
+    EXPECT_LE(stats.skipped_ticks, 7u);
+    EXPECT_GE(stats.max_work_ms, 55.0);
+}